@@ -0,0 +1,138 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "AdaptorOCL/OCL/BiFCache.h"
+#include "AdaptorOCL/OCL/LoadBuffer.h"
+#include "AdaptorOCL/OCL/BuiltinResource.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/Error.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdio>
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+
+BiFCache& BiFCache::get()
+{
+    // Never destroyed: lazy modules handed out to compiles reference the
+    // cached buffers, and compiles may still be running at process exit.
+    static BiFCache* Cache = new BiFCache();
+    return *Cache;
+}
+
+bool BiFCache::load(BiFKind Kind, Entry& E)
+{
+    int ResId = 0;
+    switch (Kind)
+    {
+    case BIF_GENERIC: ResId = OCL_BC;    break;
+    case BIF_SIZE_32: ResId = OCL_BC_32; break;
+    case BIF_SIZE_64: ResId = OCL_BC_64; break;
+    default:
+        IGC_ASSERT_MESSAGE(0, "Unknown builtin module kind");
+        return false;
+    }
+
+    char ResName[5] = { '-' };
+    snprintf(ResName, sizeof(ResName), "#%d", ResId);
+
+    E.Buffer.reset(LoadBufferFromResource(ResName, "BC"));
+    if (!E.Buffer)
+    {
+        return false;
+    }
+
+    Expected<std::vector<BitcodeModule>> BCOrErr = getBitcodeModuleList(E.Buffer->getMemBufferRef());
+    if (Error Err = BCOrErr.takeError())
+    {
+        consumeError(std::move(Err));
+        E.Buffer.reset();
+        return false;
+    }
+    if (BCOrErr->size() != 1)
+    {
+        E.Buffer.reset();
+        return false;
+    }
+
+    E.BCModule.reset(new BitcodeModule(std::move(BCOrErr->front())));
+
+    // Index the call graph once so BIImport can materialize exactly the
+    // builtins it needs instead of walking each lazy module. The parsed
+    // module only lives in a private context for the duration of the scan.
+    {
+        LLVMContext ScanCtx;
+        Expected<std::unique_ptr<Module>> ModuleOrErr = E.BCModule->parseModule(ScanCtx);
+        if (Error Err = ModuleOrErr.takeError())
+        {
+            consumeError(std::move(Err));
+            E.BCModule.reset();
+            E.Buffer.reset();
+            return false;
+        }
+        E.Symbols.reset(new BiFSymbolTable(**ModuleOrErr));
+    }
+
+    E.Loaded = true;
+    return true;
+}
+
+std::unique_ptr<Module> BiFCache::getLazyModule(
+    BiFKind Kind, LLVMContext& Ctx, bool& IsHit)
+{
+    IGC_ASSERT(Kind < BIF_NUM_KINDS);
+    Entry& E = m_Entries[Kind];
+
+    {
+        std::lock_guard<std::mutex> Guard(m_Lock);
+        IsHit = E.Loaded;
+        if (!E.Loaded && !load(Kind, E))
+        {
+            return nullptr;
+        }
+    }
+
+    // The entry is immutable once loaded, so modules for different contexts
+    // can be created concurrently without holding the lock.
+    Expected<std::unique_ptr<Module>> ModuleOrErr =
+        E.BCModule->getLazyModule(Ctx, false, false);
+    if (Error Err = ModuleOrErr.takeError())
+    {
+        consumeError(std::move(Err));
+        return nullptr;
+    }
+    return std::move(*ModuleOrErr);
+}
+
+const BiFSymbolTable* BiFCache::getSymbolTable(BiFKind Kind)
+{
+    IGC_ASSERT(Kind < BIF_NUM_KINDS);
+    std::lock_guard<std::mutex> Guard(m_Lock);
+    return m_Entries[Kind].Loaded ? m_Entries[Kind].Symbols.get() : nullptr;
+}
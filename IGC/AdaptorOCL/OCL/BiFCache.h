@@ -0,0 +1,93 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include "Compiler/Optimizer/BuiltInFuncImport.h"
+
+#include <memory>
+#include <mutex>
+
+namespace IGC
+{
+    /// Process-wide cache of the OCL builtin (BiF) bitcode.
+    ///
+    /// The builtin resources are immutable for the lifetime of the process, so
+    /// they are loaded and scanned only once. Every compile then creates a lazy
+    /// module in its own LLVMContext from the cached bitcode; BIImport only
+    /// materializes the builtins the program actually references, found
+    /// through the symbol table built when the resource is loaded.
+    class BiFCache
+    {
+    public:
+        enum BiFKind
+        {
+            BIF_GENERIC = 0,
+            BIF_SIZE_32,
+            BIF_SIZE_64,
+            BIF_NUM_KINDS
+        };
+
+        static BiFCache& get();
+
+        /// Create a lazily loaded module for the given builtin kind in Ctx.
+        /// Sets IsHit to false if this call had to load the resource; callers
+        /// report it through COUNTER_OCL_BiFCacheHit/Miss.
+        /// Returns nullptr if the resource is missing or malformed.
+        std::unique_ptr<llvm::Module> getLazyModule(
+            BiFKind Kind, llvm::LLVMContext& Ctx, bool& IsHit);
+
+        /// Symbol table of a builtin module; valid once getLazyModule has
+        /// returned a module for Kind, nullptr otherwise.
+        const BiFSymbolTable* getSymbolTable(BiFKind Kind);
+
+    private:
+        struct Entry
+        {
+            std::unique_ptr<llvm::MemoryBuffer> Buffer;
+            /// Module block located once in Buffer; independent of any LLVMContext.
+            std::unique_ptr<llvm::BitcodeModule> BCModule;
+            std::unique_ptr<BiFSymbolTable> Symbols;
+            bool Loaded = false;
+        };
+
+        BiFCache() = default;
+        BiFCache(const BiFCache&) = delete;
+        BiFCache& operator=(const BiFCache&) = delete;
+
+        bool load(BiFKind Kind, Entry& E);
+
+        std::mutex m_Lock;
+        Entry m_Entries[BIF_NUM_KINDS];
+    };
+} // namespace IGC
@@ -0,0 +1,581 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "AdaptorOCL/OCL/KernelCache.h"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef LLVM_ON_UNIX
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace IGC;
+
+namespace
+{
+    const uint32_t EntryMagic = 0x434B4749;   // "IGKC"
+    // Bump whenever the entry layout or the key material changes.
+    const uint32_t EntryVersion = 3;
+    const char* EntryExtension = ".igckc";
+    const char* TempExtension = ".tmp";
+    // Temporary files this old were left behind by a crashed writer.
+    const std::chrono::hours StaleTempAge(1);
+
+    struct EntryHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t KeySize;
+        uint64_t BinarySize;
+        uint64_t DebugDataSize;
+        uint64_t BuildLogSize;
+        /// xxHash64 of everything following the header.
+        uint64_t Checksum;
+    };
+
+    template <typename T>
+    void appendPOD(std::string& Key, const T& Value)
+    {
+        Key.append(reinterpret_cast<const char*>(&Value), sizeof(Value));
+    }
+
+    void appendBlob(std::string& Key, const void* Data, uint64_t Size)
+    {
+        appendPOD(Key, Size);
+        if (Size)
+        {
+            Key.append(static_cast<const char*>(Data), static_cast<size_t>(Size));
+        }
+    }
+
+    // The structs below contain padding, so their fields are appended one by
+    // one to keep keys independent of whatever the padding bytes hold.
+    void appendPlatform(std::string& Key, const PLATFORM& Platform)
+    {
+        appendPOD(Key, static_cast<uint32_t>(Platform.eProductFamily));
+        appendPOD(Key, static_cast<uint32_t>(Platform.ePCHProductFamily));
+        appendPOD(Key, static_cast<uint32_t>(Platform.eDisplayCoreFamily));
+        appendPOD(Key, static_cast<uint32_t>(Platform.eRenderCoreFamily));
+#ifndef _COMMON_PPA
+        appendPOD(Key, static_cast<uint32_t>(Platform.ePlatformType));
+#endif
+        appendPOD(Key, Platform.usDeviceID);
+        appendPOD(Key, Platform.usRevId);
+        appendPOD(Key, Platform.usDeviceID_PCH);
+        appendPOD(Key, Platform.usRevId_PCH);
+        appendPOD(Key, static_cast<uint32_t>(Platform.eGTType));
+    }
+
+    void appendSubSliceInfo(std::string& Key, const GT_SUBSLICE_INFO& SubSlice)
+    {
+        appendPOD(Key, SubSlice.Enabled);
+        appendPOD(Key, SubSlice.EuEnabledCount);
+        appendPOD(Key, SubSlice.EuEnabledMask);
+    }
+
+    void appendGTSystemInfo(std::string& Key, const GT_SYSTEM_INFO& Info)
+    {
+        appendPOD(Key, Info.EUCount);
+        appendPOD(Key, Info.ThreadCount);
+        appendPOD(Key, Info.SliceCount);
+        appendPOD(Key, Info.SubSliceCount);
+        appendPOD(Key, Info.DualSubSliceCount);
+        appendPOD(Key, Info.L3CacheSizeInKb);
+        appendPOD(Key, Info.LLCCacheSizeInKb);
+        appendPOD(Key, Info.EdramSizeInKb);
+        appendPOD(Key, Info.L3BankCount);
+        appendPOD(Key, Info.MaxFillRate);
+        appendPOD(Key, Info.EuCountPerPoolMax);
+        appendPOD(Key, Info.EuCountPerPoolMin);
+        appendPOD(Key, Info.TotalVsThreads);
+        appendPOD(Key, Info.TotalHsThreads);
+        appendPOD(Key, Info.TotalDsThreads);
+        appendPOD(Key, Info.TotalGsThreads);
+        appendPOD(Key, Info.TotalPsThreadsWindowerRange);
+        appendPOD(Key, Info.TotalVsThreads_Pocs);
+        appendPOD(Key, Info.CsrSizeInMb);
+        appendPOD(Key, Info.MaxEuPerSubSlice);
+        appendPOD(Key, Info.MaxSlicesSupported);
+        appendPOD(Key, Info.MaxSubSlicesSupported);
+        appendPOD(Key, Info.MaxDualSubSlicesSupported);
+        appendPOD(Key, Info.IsL3HashModeEnabled);
+        appendPOD(Key, Info.VDBoxInfo.Instances.VDBoxEnableMask);
+        appendPOD(Key, Info.VDBoxInfo.SFCSupport.Value);
+        appendPOD(Key, Info.VDBoxInfo.NumberOfVDBoxEnabled);
+        appendPOD(Key, Info.VDBoxInfo.IsValid);
+        appendPOD(Key, Info.VEBoxInfo.Instances.VEBoxEnableMask);
+        appendPOD(Key, Info.VEBoxInfo.SFCSupport.Value);
+        appendPOD(Key, Info.VEBoxInfo.NumberOfVEBoxEnabled);
+        appendPOD(Key, Info.VEBoxInfo.IsValid);
+        for (const GT_SLICE_INFO& Slice : Info.SliceInfo)
+        {
+            appendPOD(Key, Slice.Enabled);
+            for (const GT_SUBSLICE_INFO& SubSlice : Slice.SubSliceInfo)
+            {
+                appendSubSliceInfo(Key, SubSlice);
+            }
+            for (const GT_DUALSUBSLICE_INFO& DualSubSlice : Slice.DSSInfo)
+            {
+                appendPOD(Key, DualSubSlice.Enabled);
+                for (const GT_SUBSLICE_INFO& SubSlice : DualSubSlice.SubSlice)
+                {
+                    appendSubSliceInfo(Key, SubSlice);
+                }
+            }
+            appendPOD(Key, Slice.SubSliceEnabledCount);
+            appendPOD(Key, Slice.DualSubSliceEnabledCount);
+        }
+        appendPOD(Key, Info.IsDynamicallyPopulated);
+        appendPOD(Key, Info.SqidiInfo.NumberofSQIDI);
+        appendPOD(Key, Info.SqidiInfo.NumberofDoorbellPerSQIDI);
+        appendPOD(Key, Info.ReservedCCSWays);
+    }
+
+    /// Per-user default location of the cache: $XDG_CACHE_HOME or ~/.cache.
+    bool getDefaultCacheDir(SmallVectorImpl<char>& Dir)
+    {
+        Dir.clear();
+        Optional<std::string> XdgCache = sys::Process::GetEnv("XDG_CACHE_HOME");
+        if (XdgCache && sys::path::is_absolute(*XdgCache))
+        {
+            sys::path::append(Dir, *XdgCache);
+        }
+        else if (sys::path::home_directory(Dir))
+        {
+            sys::path::append(Dir, ".cache");
+        }
+        if (Dir.empty())
+        {
+            return false;
+        }
+        sys::path::append(Dir, "igc_kernel_cache");
+        return true;
+    }
+
+    /// Cache keys can be computed by anyone, so a directory that another user
+    /// can write to would let them plant binaries that this process loads.
+    /// Only a directory owned by the current user and writable by nobody else
+    /// is accepted. There is no such check for Windows ACLs, so the cache is
+    /// disabled there.
+    bool isPrivateDir(const SmallVectorImpl<char>& Dir)
+    {
+#ifdef LLVM_ON_UNIX
+        std::string Path(Dir.begin(), Dir.end());
+        struct stat St;
+        if (::stat(Path.c_str(), &St) != 0 || !S_ISDIR(St.st_mode))
+        {
+            return false;
+        }
+        return St.st_uid == ::geteuid() && (St.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#else
+        (void)Dir;
+        return false;
+#endif
+    }
+} // namespace
+
+/// Identifies the IGC build, so that upgraded drivers never pick up binaries
+/// produced by a different compiler. Empty if the build cannot be identified.
+static const std::string& getBuildIdentity()
+{
+    static const std::string Identity = []() {
+        // Identify the library this code was loaded from by its path, size
+        // and modification time, which also covers local builds.
+        std::string Path;
+#if defined(LLVM_ON_UNIX)
+        Dl_info Info;
+        if (dladdr((void*)&getBuildIdentity, &Info) && Info.dli_fname)
+        {
+            Path = Info.dli_fname;
+        }
+#endif
+        sys::fs::file_status Status;
+        if (Path.empty() || sys::fs::status(Path, Status))
+        {
+            return std::string();
+        }
+        std::string Id;
+#ifdef TB_BUILD_ID
+        Id = std::to_string(TB_BUILD_ID) + ":";
+#endif
+        return Id + Path + ":" + std::to_string(Status.getSize()) + ":" +
+            std::to_string(Status.getLastModificationTime().time_since_epoch().count());
+    }();
+    return Identity;
+}
+
+template <typename T>
+static void appendRegKey(std::string& State, unsigned Value, const char*)
+{
+    appendPOD(State, Value);
+}
+
+template <>
+void appendRegKey<debugString>(std::string& State, unsigned, const char* String)
+{
+    appendBlob(State, String, strlen(String));
+}
+
+#if defined(IGC_DEBUG_VARIABLES)
+/// Whether IGC_GET_FLAG_VALUE returns the set value of RegKey while the
+/// shader with ShaderHash is compiled. Evaluated here rather than by
+/// SetCurrentDebugHash, which would change the hash every later regkey read
+/// of the thread sees.
+template <typename MetaData>
+static bool regKeyApplies(const MetaData& RegKey, uint64_t ShaderHash)
+{
+#if defined(__linux__) && !defined(_DEBUG) && !defined(_INTERNAL)
+    if (!RegKey.IsReleaseMode())
+    {
+        return false;
+    }
+#endif
+    return RegKey.hashes.empty() ||
+        std::any_of(RegKey.hashes.begin(), RegKey.hashes.end(), [&](const HashRange& Range) {
+            return ShaderHash >= Range.start && ShaderHash <= Range.end;
+        });
+}
+#define REGKEY_VALUE_FOR_HASH(name, hash) \
+    (regKeyApplies(g_RegKeyList.name, hash) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+#define REGKEY_STRING_FOR_HASH(name, hash) \
+    (regKeyApplies(g_RegKeyList.name, hash) ? g_RegKeyList.name.m_string : "")
+#else
+#define REGKEY_VALUE_FOR_HASH(name, hash) IGC_GET_FLAG_VALUE(name)
+#define REGKEY_STRING_FOR_HASH(name, hash) IGC_GET_REGKEYSTRING(name)
+#endif
+
+/// Regkeys steer codegen, so the values IGC sees for them while compiling the
+/// shader are part of the key. This leaves out keys this build ignores (e.g.,
+/// non-release keys in Linux release builds) and keys restricted to other
+/// shader hashes. Dump and statistics keys and the cache's own configuration
+/// don't change the binary and are left out, so that they don't split the
+/// cache.
+static uint64_t getRegKeysHash(uint64_t ShaderHash)
+{
+    std::string State;
+    StringRef Group;
+#define DECLARE_IGC_GROUP(groupName) Group = groupName;
+#define DECLARE_IGC_REGKEY(dataType, regkeyName, defaultValue, description, releaseMode) \
+    if (Group != "Shader dumping" &&                                                    \
+        !StringRef(#regkeyName).contains("KernelCache") &&                             \
+        !StringRef(#regkeyName).equals("SIMDPredictorLog"))                            \
+    {                                                                                   \
+        appendRegKey<dataType>(State, REGKEY_VALUE_FOR_HASH(regkeyName, ShaderHash),    \
+            REGKEY_STRING_FOR_HASH(regkeyName, ShaderHash));                            \
+    }
+#include "common/igc_regkeys.def"
+#undef DECLARE_IGC_REGKEY
+    (void)Group;
+    (void)ShaderHash;
+    return xxHash64(State);
+}
+
+static void touchFile(const Twine& Path)
+{
+    int FD = -1;
+    if (sys::fs::openFileForWrite(Path, FD, sys::fs::CD_OpenExisting))
+    {
+        return;
+    }
+    auto Now = std::chrono::system_clock::now();
+#if LLVM_VERSION_MAJOR >= 11
+    sys::fs::setLastAccessAndModificationTime(FD, Now);
+#else
+    sys::fs::setLastModificationAndAccessTime(FD, Now);
+#endif
+    sys::Process::SafelyCloseFileDescriptor(FD);
+}
+
+KernelCache& KernelCache::get()
+{
+    static KernelCache* Cache = new KernelCache();
+    return *Cache;
+}
+
+KernelCache::KernelCache()
+{
+    if (IGC_IS_FLAG_DISABLED(EnableKernelCache) || getBuildIdentity().empty())
+    {
+        return;
+    }
+
+    SmallString<256> Dir(StringRef(IGC_GET_REGKEYSTRING(KernelCacheDir)));
+    if (Dir.empty() && !getDefaultCacheDir(Dir))
+    {
+        return;
+    }
+    if (sys::fs::create_directories(Dir, /*IgnoreExisting=*/true, sys::fs::perms::owner_all) ||
+        !isPrivateDir(Dir))
+    {
+        return;
+    }
+    m_Dir = Dir.str().str();
+    m_MaxSize = uint64_t(IGC_GET_FLAG_VALUE(KernelCacheMaxSizeMB)) << 20;
+}
+
+std::string KernelCache::getKey(
+    const TC::STB_TranslateInputArgs& InputArgs,
+    TC::TB_DATA_FORMAT DataFormat,
+    const CPlatform& Platform,
+    float ProfilingTimerResolution,
+    uint64_t InputHash)
+{
+    std::string Key;
+    const std::string& BuildId = getBuildIdentity();
+    appendBlob(Key, BuildId.data(), BuildId.size());
+    appendPOD(Key, getRegKeysHash(InputHash));
+    appendPOD(Key, static_cast<uint32_t>(DataFormat));
+
+    // The input itself is not stored; two independent hashes stand in for it.
+    appendPOD(Key, static_cast<uint64_t>(InputArgs.InputSize));
+    appendPOD(Key, InputHash);
+    appendPOD(Key, xxHash64(StringRef(InputArgs.pInput, InputArgs.InputSize)));
+
+    appendBlob(Key, InputArgs.pOptions, InputArgs.pOptions ? InputArgs.OptionsSize : 0);
+    appendBlob(Key, InputArgs.pInternalOptions,
+        InputArgs.pInternalOptions ? InputArgs.InternalOptionsSize : 0);
+    appendPOD(Key, InputArgs.SpecConstantsSize);
+    for (uint32_t i = 0; i < InputArgs.SpecConstantsSize; i++)
+    {
+        appendPOD(Key, InputArgs.pSpecConstantsIds[i]);
+        appendPOD(Key, InputArgs.pSpecConstantsValues[i]);
+    }
+
+    appendPlatform(Key, Platform.getPlatformInfo());
+    // The WA and SKU tables are made of unsigned int bitfields only, so they
+    // have no padding bytes; their unused bits are zero because every source
+    // (SetWorkaroundTable, ConvertSkuTable, the CIF features table) clears
+    // the table before setting bits.
+    appendPOD(Key, Platform.getWATable());
+    appendPOD(Key, Platform.getSkuTable());
+    appendGTSystemInfo(Key, Platform.GetGTSystemInfo());
+    appendPOD(Key, Platform.getMaxOCLParameteSize());
+    // Baked into the binary as __ProfilingTimerResolution.
+    appendPOD(Key, ProfilingTimerResolution);
+    return Key;
+}
+
+std::string KernelCache::getEntryPath(const std::string& Key) const
+{
+    char Name[17];
+    snprintf(Name, sizeof(Name), "%016llx", (unsigned long long)xxHash64(Key));
+    SmallString<256> Path(m_Dir);
+    sys::path::append(Path, Twine(Name) + EntryExtension);
+    return Path.str().str();
+}
+
+bool KernelCache::lookup(const std::string& Key, Entry& Result)
+{
+    std::string Path = getEntryPath(Key);
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFile(Path, -1, /*RequiresNullTerminator=*/false);
+    if (!BufOrErr)
+    {
+        return false;
+    }
+
+    StringRef Data = (*BufOrErr)->getBuffer();
+    EntryHeader Header;
+    bool IsValid = Data.size() >= sizeof(Header);
+    if (IsValid)
+    {
+        memcpy(&Header, Data.data(), sizeof(Header));
+        Data = Data.drop_front(sizeof(Header));
+        // Check each size separately so that their sum cannot overflow.
+        IsValid = Header.Magic == EntryMagic &&
+            Header.Version == EntryVersion &&
+            Header.KeySize <= Data.size() &&
+            Header.BinarySize <= Data.size() - Header.KeySize &&
+            Header.DebugDataSize <= Data.size() - Header.KeySize - Header.BinarySize &&
+            Header.BuildLogSize ==
+                Data.size() - Header.KeySize - Header.BinarySize - Header.DebugDataSize &&
+            Header.Checksum == xxHash64(Data);
+    }
+    if (!IsValid)
+    {
+        // Truncated or otherwise corrupted; drop it so it gets rewritten.
+        sys::fs::remove(Path);
+        return false;
+    }
+
+    // A different key with the same file name; the entry is left alone.
+    if (Data.take_front(Header.KeySize) != Key)
+    {
+        return false;
+    }
+    Data = Data.drop_front(Header.KeySize);
+    Result.BinarySize = static_cast<size_t>(Header.BinarySize);
+    Result.Binary.reset(new char[Result.BinarySize]);
+    memcpy(Result.Binary.get(), Data.data(), Result.BinarySize);
+    Data = Data.drop_front(Header.BinarySize);
+    Result.DebugDataSize = static_cast<size_t>(Header.DebugDataSize);
+    if (Result.DebugDataSize)
+    {
+        Result.DebugData.reset(new char[Result.DebugDataSize]);
+        memcpy(Result.DebugData.get(), Data.data(), Result.DebugDataSize);
+    }
+    Result.BuildLog = Data.drop_front(Header.DebugDataSize).str();
+
+    touchFile(Path);
+    return true;
+}
+
+void KernelCache::store(
+    const std::string& Key, StringRef Binary, StringRef DebugData, StringRef BuildLog)
+{
+    std::string Payload;
+    Payload.reserve(Key.size() + Binary.size() + DebugData.size() + BuildLog.size());
+    Payload.append(Key);
+    Payload.append(Binary.data(), Binary.size());
+    Payload.append(DebugData.data(), DebugData.size());
+    Payload.append(BuildLog.data(), BuildLog.size());
+
+    EntryHeader Header;
+    Header.Magic = EntryMagic;
+    Header.Version = EntryVersion;
+    Header.KeySize = Key.size();
+    Header.BinarySize = Binary.size();
+    Header.DebugDataSize = DebugData.size();
+    Header.BuildLogSize = BuildLog.size();
+    Header.Checksum = xxHash64(Payload);
+
+    // Write a private temporary file and publish it with a rename, so that
+    // readers only ever see complete entries.
+    SmallString<256> TempPath;
+    int FD = -1;
+    if (sys::fs::createUniqueFile(Twine(m_Dir) + "/%%%%%%%%%%%%%%%%" + TempExtension, FD, TempPath))
+    {
+        return;
+    }
+    {
+        raw_fd_ostream OS(FD, /*shouldClose=*/true);
+        OS.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+        OS.write(Payload.data(), Payload.size());
+        OS.close();
+        if (OS.has_error())
+        {
+            OS.clear_error();
+            sys::fs::remove(TempPath);
+            return;
+        }
+    }
+    if (sys::fs::rename(TempPath, getEntryPath(Key)))
+    {
+        sys::fs::remove(TempPath);
+        return;
+    }
+
+    // Replacing an existing entry overestimates the size; the next scan
+    // corrects that.
+    std::lock_guard<std::mutex> Guard(m_EvictLock);
+    m_TotalSize += sizeof(Header) + Payload.size();
+    if (!m_TotalSizeKnown || m_TotalSize > m_MaxSize)
+    {
+        scanAndEvict();
+    }
+}
+
+/// Measure the cache directory, drop stale temporaries and evict the least
+/// recently used entries until it fits under the cap. Called with
+/// m_EvictLock held.
+void KernelCache::scanAndEvict()
+{
+    struct FileInfo
+    {
+        std::string Path;
+        sys::TimePoint<> LastUse;
+        uint64_t Size;
+    };
+
+    std::vector<FileInfo> Entries;
+    uint64_t TotalSize = 0;
+    auto Now = std::chrono::system_clock::now();
+    std::error_code EC;
+    for (sys::fs::directory_iterator It(m_Dir, EC), End; !EC && It != End; It.increment(EC))
+    {
+        const std::string& Path = It->path();
+        sys::fs::file_status Status;
+        if (sys::fs::status(Path, Status) || Status.type() != sys::fs::file_type::regular_file)
+        {
+            continue;
+        }
+        StringRef Extension = sys::path::extension(Path);
+        if (Extension == TempExtension)
+        {
+            if (Now - Status.getLastModificationTime() > StaleTempAge)
+            {
+                sys::fs::remove(Path);
+            }
+            continue;
+        }
+        if (Extension != EntryExtension)
+        {
+            continue;
+        }
+        Entries.push_back({ Path, Status.getLastModificationTime(), Status.getSize() });
+        TotalSize += Status.getSize();
+    }
+
+    m_TotalSize = TotalSize;
+    m_TotalSizeKnown = true;
+    if (TotalSize <= m_MaxSize)
+    {
+        return;
+    }
+
+    std::sort(Entries.begin(), Entries.end(),
+        [](const FileInfo& A, const FileInfo& B) { return A.LastUse < B.LastUse; });
+    for (const FileInfo& Entry : Entries)
+    {
+        if (TotalSize <= m_MaxSize)
+        {
+            break;
+        }
+        // Another process may have evicted it already; either way it is gone.
+        sys::fs::remove(Entry.Path);
+        TotalSize -= Entry.Size;
+    }
+    m_TotalSize = TotalSize;
+}
@@ -0,0 +1,112 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#pragma once
+
+#include "AdaptorOCL/TranslationBlock.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/StringRef.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace IGC
+{
+    /// Persistent on-disk cache of OCL program binaries (EnableKernelCache).
+    ///
+    /// Entries are content addressed: the key material covers everything that
+    /// can change the produced binary (input, options, spec constants,
+    /// platform, WA/SKU tables, profiling timer resolution, effective regkey
+    /// values and the IGC build), and the file name is a hash of it. Each
+    /// entry is a single file holding a checksummed header, the full key
+    /// material, the program binary, its debug data and the build log of the
+    /// compile that produced it.
+    /// Entries are published by renaming a completed temporary file, so
+    /// concurrent processes never observe partial writes. Hits refresh the
+    /// file's modification time, which eviction uses as its LRU order once the
+    /// directory grows past KernelCacheMaxSizeMB. The directory is only
+    /// scanned when the process's size estimate passes that cap.
+    class KernelCache
+    {
+    public:
+        static KernelCache& get();
+
+        /// False if caching is disabled or the cache directory is unusable.
+        bool isEnabled() const { return !m_Dir.empty(); }
+
+        /// Contents of a cache hit. The buffers are allocated with new[] so
+        /// that they can be handed to the caller as they are.
+        struct Entry
+        {
+            std::unique_ptr<char[]> Binary;
+            size_t BinarySize = 0;
+            std::unique_ptr<char[]> DebugData;
+            size_t DebugDataSize = 0;
+            std::string BuildLog;
+        };
+
+        /// Build the key material of a TranslateBuild invocation.
+        static std::string getKey(
+            const TC::STB_TranslateInputArgs& InputArgs,
+            TC::TB_DATA_FORMAT DataFormat,
+            const CPlatform& Platform,
+            float ProfilingTimerResolution,
+            uint64_t InputHash);
+
+        /// Look up the entry for Key. Corrupted or mismatching entries are
+        /// removed and reported as misses.
+        bool lookup(const std::string& Key, Entry& Result);
+
+        /// Publish an entry for Key and evict old entries if over the size cap.
+        void store(
+            const std::string& Key,
+            llvm::StringRef Binary,
+            llvm::StringRef DebugData,
+            llvm::StringRef BuildLog);
+
+    private:
+        KernelCache();
+        KernelCache(const KernelCache&) = delete;
+        KernelCache& operator=(const KernelCache&) = delete;
+
+        std::string getEntryPath(const std::string& Key) const;
+        void scanAndEvict();
+
+        std::string m_Dir;
+        uint64_t m_MaxSize = 0;
+        /// Serializes eviction scans and guards the size estimate below.
+        std::mutex m_EvictLock;
+        /// Size of the cache directory as of the last scan plus everything
+        /// this process stored since. Other processes' stores are only seen
+        /// by the next scan, which runs once the estimate passes the cap.
+        uint64_t m_TotalSize = 0;
+        bool m_TotalSizeKnown = false;
+    };
+} // namespace IGC
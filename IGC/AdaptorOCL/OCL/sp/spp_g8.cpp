@@ -110,6 +110,16 @@ RETVAL CGen8OpenCLProgramBase::GetProgramBinary(
         DebugProgramBinaryHeader(&header, m_StateProcessor.m_oclStateDebugMessagePrintOut);
     }
 
+    // All parts are final at this point; size the output so that it is
+    // written with a single allocation.
+    std::streamsize binarySize = programBinary.Size() + sizeof( header ) +
+        m_ProgramScopePatchStream->Size();
+    for( auto data : m_KernelBinaries )
+    {
+        binarySize += data.kernelBinary->Size();
+    }
+    programBinary.Reserve( binarySize );
+
     programBinary.Write( header );
 
     programBinary.Write( *m_ProgramScopePatchStream );
@@ -168,6 +178,16 @@ RETVAL CGen8OpenCLProgramBase::GetProgramDebugData(Util::BinaryStream& programDe
         header.NumberOfKernels = numDebugBinaries;
         header.SteppingId = m_Platform.usRevId;
 
+        std::streamsize debugDataSize = programDebugData.Size() + sizeof( header );
+        for (auto data : m_KernelBinaries)
+        {
+            if (data.kernelDebugData)
+            {
+                debugDataSize += data.kernelDebugData->Size();
+            }
+        }
+        programDebugData.Reserve( debugDataSize );
+
         programDebugData.Write( header );
 
         for (auto data : m_KernelBinaries)
@@ -253,7 +273,7 @@ void overrideOCLKernelBinary(
 
 
 void CGen8OpenCLProgram::GetZEBinary(
-    llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
+    Util::BinaryStream& programBinary, unsigned pointerSizeInBytes,
     const char* spv, uint32_t spvSize)
 {
     auto isValidShader = [&](IGC::COpenCLKernel* shader)->bool
@@ -112,7 +112,8 @@ public:
 
     /// getZEBinary - create and get ZE Binary
     /// if spv and spvSize are given, a .spv section will be created in the output ZEBinary
-    void GetZEBinary(llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
+    /// The binary is written in place into programBinary, which is sized up front
+    void GetZEBinary(Util::BinaryStream& programBinary, unsigned pointerSizeInBytes,
         const char* spv, uint32_t spvSize);
 
     // Used to track the kernel info from CodeGen
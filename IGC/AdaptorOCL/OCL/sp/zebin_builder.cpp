@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/raw_ostream.h"
 #include "Probe/Assertion.h"
 
 using namespace IGC;
@@ -508,12 +509,45 @@ void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
     mBuilder.finalize(os);
 }
 
+namespace {
+/// raw_pwrite_stream appending to a Util::BinaryStream. Offsets are relative
+/// to the stream size at construction.
+class BinaryStreamOStream : public llvm::raw_pwrite_stream
+{
+public:
+    BinaryStreamOStream(Util::BinaryStream& stream)
+        : raw_pwrite_stream(true), mStream(stream), mStart(stream.Size()) {}
+
+private:
+    void write_impl(const char* ptr, size_t size) override
+    {
+        bool success = mStream.Write(ptr, size);
+        IGC_ASSERT(success);
+        (void)success;
+    }
+
+    void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override
+    {
+        bool success = mStream.WriteAt(ptr, size, mStart + offset);
+        IGC_ASSERT(success);
+        (void)success;
+    }
+
+    uint64_t current_pos() const override { return mStream.Size() - mStart; }
+
+    Util::BinaryStream& mStream;
+    std::streamsize mStart;
+};
+} // namespace
+
 void ZEBinaryBuilder::getBinaryObject(Util::BinaryStream& outputStream)
 {
-    llvm::SmallVector<char, 64> buf;
-    llvm::raw_svector_ostream llvm_os(buf);
-    getBinaryObject(llvm_os);
-    outputStream.Write(buf.data(), buf.size());
+    mBuilder.addSectionZEInfo(mZEInfoBuilder.getZEInfoContainer());
+    // size the stream first so that the object is written in place with a
+    // single allocation; ze_info is serialized once, by getBinarySize
+    outputStream.Reserve(outputStream.Size() + mBuilder.getBinarySize());
+    BinaryStreamOStream os(outputStream);
+    mBuilder.finalize(os);
 }
 
 void ZEBinaryBuilder::printBinaryObject(const std::string& filename)
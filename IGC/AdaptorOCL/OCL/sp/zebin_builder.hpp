@@ -76,7 +76,7 @@ public:
     void getBinaryObject(llvm::raw_pwrite_stream& os);
 
     // getBinaryObject - write the final object into given Util::BinaryStream
-    // Avoid using this function, which has extra buffer copy
+    // The stream is sized first and the object is written in place
     void getBinaryObject(Util::BinaryStream& outputStream);
 
     void printBinaryObject(const std::string& filename);
@@ -23,70 +23,106 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 
 ======================= end_copyright_notice ==================================*/
-
 #include "BinaryStream.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 namespace Util
 {
 
-BinaryStream::BinaryStream() : m_membuf( std::ios::in | std::ios::out | std::ios::binary )
+BinaryStream::BinaryStream()
 {
     // Nothing!
 }
 
 BinaryStream::~BinaryStream()
 {
-    // Nothing!
+    delete[] m_buffer;
 }
 
-bool BinaryStream::Write( const char* s, std::streamsize n )
+bool BinaryStream::Grow( std::streamsize n )
 {
-    bool retValue = false;
-
-    std::streamsize prevSize = Size();
-
-    m_membuf.write( s, n );
+    if( n <= m_capacity )
+    {
+        return true;
+    }
 
-    if( ( Size() - prevSize ) == n )
+    char* buffer = new (std::nothrow) char[ (size_t)n ];
+    if( buffer == nullptr )
     {
-        retValue = true;
+        return false;
     }
 
-    if( m_membuf.fail() )
+    if( m_size )
     {
-        retValue = false;
+        memcpy( buffer, m_buffer, (size_t)m_size );
     }
+    delete[] m_buffer;
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    m_buffer = buffer;
+    m_capacity = n;
 
-    return retValue;
+    return true;
 }
 
-bool BinaryStream::Write( const BinaryStream& in )
+bool BinaryStream::Reserve( std::streamsize n )
 {
-    bool retValue = false;
+    return Grow( n );
+}
 
-    std::streamsize prevSize = Size();
+char* BinaryStream::Release()
+{
+    char* buffer = m_buffer;
 
-    m_membuf << in.m_membuf.str();
+    m_buffer = nullptr;
+    m_size = 0;
+    m_capacity = 0;
+
+    return buffer;
+}
 
-    if( ( Size() - prevSize ) == in.Size() )
+bool BinaryStream::Write( const char* s, std::streamsize n )
+{
+    if( n < 0 )
     {
-        retValue = true;
+        return false;
     }
 
-    if( m_membuf.fail() )
+    if( ( m_size + n ) > m_capacity &&
+        !Grow( std::max( m_size + n, m_capacity * 2 ) ) )
     {
-        retValue = false;
+        return false;
     }
 
-#if defined(_DEBUG)
-    GetLinearPointer();
-#endif
+    if( n )
+    {
+        memcpy( m_buffer + m_size, s, (size_t)n );
+        m_size += n;
+    }
 
-    return retValue;
+    return true;
+}
+
+bool BinaryStream::Write( const BinaryStream& in )
+{
+    // in may be this stream, so size it before growing the buffer
+    std::streamsize n = in.m_size;
+
+    if( ( m_size + n ) > m_capacity &&
+        !Grow( std::max( m_size + n, m_capacity * 2 ) ) )
+    {
+        return false;
+    }
+
+    if( n )
+    {
+        memcpy( m_buffer + m_size, in.m_buffer, (size_t)n );
+        m_size += n;
+    }
+
+    return true;
 }
 
 
@@ -97,9 +133,7 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
     // Give this function name it seems like this function should enlarge the stream if needed. Discuss.
     if( ( n + loc ) < Size() )
     {
-        m_membuf.seekp( loc, std::ios_base::beg );
-        Write( s, n );
-        m_membuf.seekp( 0, std::ios_base::end );
+        memcpy( m_buffer + loc, s, (size_t)n );
     }
     else
     {
@@ -111,8 +145,7 @@ bool BinaryStream::WriteAt( const char* s, std::streamsize n, std::streamsize lo
 
 const char* BinaryStream::GetLinearPointer()
 {
-    m_LinearPointer = m_membuf.str();
-    return m_LinearPointer.c_str();
+    return m_buffer ? m_buffer : "";
 }
 
 bool BinaryStream::Align( std::streamsize alignment )
@@ -137,28 +170,33 @@ bool BinaryStream::Align( std::streamsize alignment )
 
 bool BinaryStream::AddPadding( std::streamsize padding )
 {
-    bool retValue = true;
+    // Always pad with 0x0 to make external tools that parse
+    // OpenCL program binaries easier to maintain
+    if( padding <= 0 )
+    {
+        return padding == 0;
+    }
 
-    while( padding-- )
+    if( ( m_size + padding ) > m_capacity &&
+        !Grow( std::max( m_size + padding, m_capacity * 2 ) ) )
     {
-        // Always pad with 0x0 to make external tools that parse
-        // OpenCL program binaries easier to maintain
-        retValue &= Write( (char)0x0 );
+        return false;
     }
 
-    return retValue;
+    memset( m_buffer + m_size, 0, (size_t)padding );
+    m_size += padding;
+
+    return true;
 }
 
 std::streamsize BinaryStream::Size() const
 {
-    // tellp is a non const function
-    // TODO: Is there a better way to do this?
-    return const_cast<BinaryStream*>(this)->Size();
+    return m_size;
 }
 
 std::streamsize BinaryStream::Size()
 {
-    return m_membuf.tellp();
+    return m_size;
 }
 
 }
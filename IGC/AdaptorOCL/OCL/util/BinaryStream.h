@@ -26,7 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-#include <sstream>
+#include <ios>
 
 namespace Util
 {
@@ -37,6 +37,9 @@ public:
     BinaryStream();
     ~BinaryStream();
 
+    BinaryStream( const BinaryStream& ) = delete;
+    BinaryStream& operator=( const BinaryStream& ) = delete;
+
     bool Write( const char* s, std::streamsize n );
 
     bool Write( const BinaryStream& in );
@@ -52,15 +55,26 @@ public:
     bool Align( std::streamsize alignment );
     bool AddPadding( std::streamsize padding );
 
+    // Valid until the next write.
     const char* GetLinearPointer();
 
     std::streamsize Size() const;
     std::streamsize Size();
 
+    // Grow the buffer to hold n bytes, so that a stream whose final size is
+    // known up front is written with a single allocation.
+    bool Reserve( std::streamsize n );
+
+    // Hand the buffer over to the caller and leave the stream empty. The
+    // buffer is allocated with new[] and must be released with delete[].
+    char* Release();
+
 private:
-    std::stringstream m_membuf;
+    bool Grow( std::streamsize n );
 
-    std::string m_LinearPointer;
+    char* m_buffer = nullptr;
+    std::streamsize m_size = 0;
+    std::streamsize m_capacity = 0;
 };
 
 template< class T >
@@ -4407,11 +4407,12 @@ __attr_unused static void dumpSPIRVBC(const char* fname, const char* data, unsig
     }
 }
 
-bool ReadSPIRV(LLVMContext &C, std::istream &IS, Module *&M,
+bool ReadSPIRV(LLVMContext &C, StringRef Input, Module *&M,
     std::string &ErrMsg,
     std::unordered_map<uint32_t, uint64_t> *specConstants) {
   std::unique_ptr<SPIRVModule> BM( SPIRVModule::createSPIRVModule() );
   BM->setSpecConstantMap(specConstants);
+  SPIRVInputStream IS(Input.data(), Input.size());
   IS >> *BM;
   BM->resolveUnknownStructFields();
   M = new Module( "",C );
@@ -43,9 +43,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <unordered_map>
 
 namespace spv{
-// Loads SPIRV from istream and translate to LLVM module.
+// Loads SPIRV from a binary in memory and translate to LLVM module. The
+// binary is decoded in place and need not outlive the call.
 // Returns true if succeeds.
-bool ReadSPIRV(llvm::LLVMContext &C, std::istream &IS, llvm::Module *&M,
+bool ReadSPIRV(llvm::LLVMContext &C, llvm::StringRef Input, llvm::Module *&M,
     std::string &ErrMsg,
     std::unordered_map<uint32_t, uint64_t> *specConstants);
 
@@ -114,7 +114,7 @@ SPIRVDecorate::setWordCount(SPIRVWord Count){
 }
 
 void
-SPIRVDecorate::decode(std::istream &I)
+SPIRVDecorate::decode(SPIRVInputStream &I)
 {
     getDecoder(I) >> Target >> Dec;
     auto currLoc = I.tellg();
@@ -141,19 +141,19 @@ SPIRVMemberDecorate::setWordCount(SPIRVWord Count){
 }
 
 void
-SPIRVMemberDecorate::decode(std::istream &I){
+SPIRVMemberDecorate::decode(SPIRVInputStream &I){
   getDecoder(I) >> Target >> MemberNumber >> Dec >> Literals;
   getOrCreateTarget()->addMemberDecorate(this);
 }
 
 void
-SPIRVDecorationGroup::decode(std::istream &I){
+SPIRVDecorationGroup::decode(SPIRVInputStream &I){
   getDecoder(I) >> Id;
   Module->addDecorationGroup(this);
 }
 
 void
-SPIRVGroupDecorateGeneric::decode(std::istream &I){
+SPIRVGroupDecorateGeneric::decode(SPIRVInputStream &I){
   getDecoder(I) >> DecorationGroup >> Targets;
   Module->addGroupDecorateGeneric(this);
 }
@@ -119,7 +119,7 @@ SPIRVEntry::getValueType(SPIRVId TheId)const {
 }
 
 SPIRVDecoder
-SPIRVEntry::getDecoder(std::istream& I){
+SPIRVEntry::getDecoder(SPIRVInputStream& I){
   return SPIRVDecoder(I, *Module);
 }
 
@@ -147,7 +147,7 @@ SPIRVEntry::setModule(SPIRVModule *TheModule) {
 // function for creating the SPIRVEntry. Therefore the input stream only
 // contains the remaining part of the words for the SPIRVEntry.
 void
-SPIRVEntry::decode(std::istream &I) {
+SPIRVEntry::decode(SPIRVInputStream &I) {
   IGC_ASSERT_EXIT_MESSAGE(0, "Not implemented");
 }
 
@@ -365,8 +365,8 @@ SPIRVEntry::setLinkageType(SPIRVLinkageTypeKind LT) {
   addDecorate(new SPIRVDecorate(DecorationLinkageAttributes, this, LT));
 }
 
-std::istream &
-operator>>(std::istream &I, SPIRVEntry &E) {
+SPIRVInputStream &
+operator>>(SPIRVInputStream &I, SPIRVEntry &E) {
   E.decode(I);
   return I;
 }
@@ -379,14 +379,14 @@ SPIRVEntryPoint::SPIRVEntryPoint(SPIRVModule *TheModule,
 }
 
 void
-SPIRVEntryPoint::decode(std::istream &I) {
+SPIRVEntryPoint::decode(SPIRVInputStream &I) {
   getDecoder(I) >> ExecModel >> Target >> Name;
   Module->setName(getOrCreateTarget(), Name);
   Module->addEntryPoint(ExecModel, Target);
 }
 
 void
-SPIRVExecutionMode::decode(std::istream &I) {
+SPIRVExecutionMode::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Target >> ExecMode;
   switch(ExecMode) {
   case SPIRVExecutionModeKind::ExecutionModeLocalSize:
@@ -423,7 +423,7 @@ SPIRVName::SPIRVName(const SPIRVEntry *TheTarget, const std::string& TheStr)
 }
 
 void
-SPIRVName::decode(std::istream &I) {
+SPIRVName::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Target >> Str;
   Module->setName(getOrCreateTarget(), Str);
 }
@@ -437,7 +437,7 @@ _SPIRV_IMP_DEC2(SPIRVString, Id, Str)
 _SPIRV_IMP_DEC3(SPIRVMemberName, Target, MemberNumber, Str)
 
 void
-SPIRVLine::decode(std::istream &I) {
+SPIRVLine::decode(SPIRVInputStream &I) {
   getDecoder(I) >> FileName >> Line >> Column;
 }
 
@@ -451,7 +451,7 @@ SPIRVLine::validate() const {
 }
 
 void
-SPIRVNoLine::decode(std::istream &I) {
+SPIRVNoLine::decode(SPIRVInputStream &I) {
 }
 
 void
@@ -475,7 +475,7 @@ SPIRVExtInstImport::SPIRVExtInstImport(SPIRVModule *TheModule, SPIRVId TheId,
 }
 
 void
-SPIRVExtInstImport::decode(std::istream &I) {
+SPIRVExtInstImport::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Id >> Str;
   Module->importBuiltinSetWithId(Str, Id);
 }
@@ -487,7 +487,7 @@ SPIRVExtInstImport::validate() const {
 }
 
 void
-SPIRVMemoryModel::decode(std::istream &I) {
+SPIRVMemoryModel::decode(SPIRVInputStream &I) {
   SPIRVAddressingModelKind AddrModel;
   SPIRVMemoryModelKind MemModel;
   getDecoder(I) >> AddrModel >> MemModel;
@@ -504,7 +504,7 @@ SPIRVMemoryModel::validate() const {
 }
 
 void
-SPIRVSource::decode(std::istream &I) {
+SPIRVSource::decode(SPIRVInputStream &I) {
   SpvSourceLanguage Lang = SpvSourceLanguageUnknown;
   SPIRVWord Ver = SPIRVWORD_MAX;
   getDecoder(I) >> Lang >> Ver;
@@ -515,7 +515,7 @@ SPIRVSourceExtension::SPIRVSourceExtension(SPIRVModule *M,
     const std::string &SS) : SPIRVEntryNoId(M, 1 + getSizeInWords(SS)), S(SS){}
 
 void
-SPIRVSourceExtension::decode(std::istream &I) {
+SPIRVSourceExtension::decode(SPIRVInputStream &I) {
   getDecoder(I) >> S;
   Module->getSourceExtension().insert(S);
 }
@@ -524,7 +524,7 @@ SPIRVExtension::SPIRVExtension(SPIRVModule *M, const std::string &SS)
   :SPIRVEntryNoId(M, 1 + getSizeInWords(SS)), S(SS){}
 
 void
-SPIRVExtension::decode(std::istream &I) {
+SPIRVExtension::decode(SPIRVInputStream &I) {
   getDecoder(I) >> S;
   Module->getExtension().insert(S);
 }
@@ -534,13 +534,13 @@ SPIRVCapability::SPIRVCapability(SPIRVModule *M, SPIRVCapabilityKind K)
 }
 
 void
-SPIRVCapability::decode(std::istream &I) {
+SPIRVCapability::decode(SPIRVInputStream &I) {
   getDecoder(I) >> Kind;
   Module->addCapability(Kind);
 }
 
 void
-SPIRVModuleProcessed::decode(std::istream &I) {
+SPIRVModuleProcessed::decode(SPIRVInputStream &I) {
     getDecoder(I) >> S;
     Module->setModuleProcessed(S);
 }
@@ -550,7 +550,7 @@ template <spv::Op OC> void SPIRVContinuedInstINTELBase<OC>::validate() const {
 }
 
 template <spv::Op OC>
-void SPIRVContinuedInstINTELBase<OC>::decode(std::istream& I) {
+void SPIRVContinuedInstINTELBase<OC>::decode(SPIRVInputStream& I) {
     SPIRVEntry::getDecoder(I) >> (Elements);
 }
 
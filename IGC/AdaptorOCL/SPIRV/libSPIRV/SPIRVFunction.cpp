@@ -91,12 +91,12 @@ SPIRVFunctionParameter::foreachAttr(
 }
 
 SPIRVDecoder
-SPIRVFunction::getDecoder(std::istream &IS) {
+SPIRVFunction::getDecoder(SPIRVInputStream &IS) {
   return SPIRVDecoder(IS, *this);
 }
 
 void
-SPIRVFunction::decode(std::istream &I) {
+SPIRVFunction::decode(SPIRVInputStream &I) {
   SPIRVDecoder Decoder = getDecoder(I);
   Decoder >> Type >> Id >> FCtrlMask >> FuncType;
   Module->addFunction(this);
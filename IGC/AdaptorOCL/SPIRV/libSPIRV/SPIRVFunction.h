@@ -124,7 +124,7 @@ public:
   SPIRVFunction():SPIRVValue(OpFunction),FuncType(NULL),
      FCtrlMask(SPIRVFunctionControlMaskKind::FunctionControlMaskNone){}
 
-  SPIRVDecoder getDecoder(std::istream &IS);
+  SPIRVDecoder getDecoder(SPIRVInputStream &IS);
   SPIRVTypeFunction *getFunctionType() const { return FuncType;}
   SPIRVWord getFuncCtlMask() const { return FCtrlMask;}
   size_t getNumBasicBlock() const { return BBVec.size();}
@@ -373,7 +373,7 @@ public:
   }
 
 protected:
-  virtual void decode(std::istream &I) override {
+  virtual void decode(SPIRVInputStream &I) override {
     auto D = getDecoder(I);
     if (hasType())
       D >> Type;
@@ -509,7 +509,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> PtrId >> ValId >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -557,7 +557,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id >> PtrId >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -1230,7 +1230,7 @@ public:
     IGC_ASSERT_MESSAGE((ExtSetKind == SPIRVEIS_OpenCL) || (ExtSetKind == SPIRVEIS_DebugInfo) ||
         (ExtSetKind == SPIRVEIS_OpenCL_DebugInfo_100), "not supported");
   }
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id >> ExtSetId;
     setExtSetKindById();
     switch(ExtSetKind) {
@@ -1414,7 +1414,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Target >> Source >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
@@ -1452,7 +1452,7 @@ protected:
     MemoryAccess.resize(TheWordCount - FixedWords);
   }
 
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Target >> Source >> Size >> MemoryAccess;
     MemoryAccessUpdate(MemoryAccess);
   }
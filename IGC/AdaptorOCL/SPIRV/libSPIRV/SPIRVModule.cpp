@@ -90,6 +90,7 @@ public:
     SrcLang(SpvSourceLanguageOpenCL_C),
     SrcLangVer(12),
     MemoryModel(SPIRVMemoryModelKind::MemoryModelOpenCL),
+    DenseIdLimit(SPIRVID_INVALID),
     SCMap(nullptr) {
     AddrModel = sizeof(size_t) == 32 ? AddressingModelPhysical32 : AddressingModelPhysical64;
   };
@@ -232,36 +233,37 @@ public:
 
   virtual SPIRVExtInst* getCompilationUnit() const override
   {
-      for (auto& item : IdEntryMap)
+      SPIRVExtInst* compileUnit = nullptr;
+      forEachEntry([&](SPIRVEntry* item)
       {
-          if (item.second->getOpCode() == spv::Op::OpExtInst)
+          if (!compileUnit && item->getOpCode() == spv::Op::OpExtInst)
           {
-              auto extInst = static_cast<SPIRVExtInst*>(item.second);
+              auto extInst = static_cast<SPIRVExtInst*>(item);
               if ((extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_DebugInfo ||
                   extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_OpenCL_DebugInfo_100) &&
                   extInst->getExtOp() == OCLExtOpDbgKind::CompileUnit)
-                  return extInst;
+                  compileUnit = extInst;
           }
-      }
+      });
 
-      return nullptr;
+      return compileUnit;
   }
 
   virtual std::vector<SPIRVExtInst*> getGlobalVars() override
   {
       std::vector<SPIRVExtInst*> globalVars;
 
-      for (auto& item : IdEntryMap)
+      forEachEntry([&](SPIRVEntry* item)
       {
-          if (item.second->getOpCode() == spv::Op::OpExtInst)
+          if (item->getOpCode() == spv::Op::OpExtInst)
           {
-              auto extInst = static_cast<SPIRVExtInst*>(item.second);
+              auto extInst = static_cast<SPIRVExtInst*>(item);
               if ((extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_DebugInfo ||
                   extInst->getExtSetKind() == SPIRVExtInstSetKind::SPIRVEIS_OpenCL_DebugInfo_100) &&
                   extInst->getExtOp() == OCLExtOpDbgKind::GlobalVariable)
                   globalVars.push_back(extInst);
           }
-      }
+      });
 
       return globalVars;
   }
@@ -270,23 +272,23 @@ public:
   {
       std::vector<SPIRVValue*> specConstants;
 
-      for (auto& item : IdEntryMap)
+      forEachEntry([&](SPIRVEntry* item)
       {
-          Op opcode = item.second->getOpCode();
+          Op opcode = item->getOpCode();
           if (opcode == spv::Op::OpSpecConstant ||
               opcode == spv::Op::OpSpecConstantTrue ||
               opcode == spv::Op::OpSpecConstantFalse)
           {
-              auto specConstant = static_cast<SPIRVValue*>(item.second);
+              auto specConstant = static_cast<SPIRVValue*>(item);
               specConstants.push_back(specConstant);
           }
-      }
+      });
 
       return specConstants;
   }
 
   // I/O functions
-  friend std::istream & operator>>(std::istream &I, SPIRVModule& M);
+  friend SPIRVInputStream & operator>>(SPIRVInputStream &I, SPIRVModule& M);
 
 private:
   SPIRVErrorLog ErrLog;
@@ -302,11 +304,17 @@ private:
   SPIRVMemoryModelKind MemoryModel;
   std::string ModuleProcessed;
 
-  typedef std::map<SPIRVId, SPIRVEntry *> SPIRVIdToEntryMap;
+  // Indexed by id. SPIR-V ids are dense and below the bound in the module
+  // header, so a vector is both smaller and faster than a tree; ids without
+  // an entry map to null. Ids at or above DenseIdLimit, which only corrupt
+  // or very sparse input has, go to a tree instead, so that a huge id cannot
+  // force a huge table.
+  typedef std::vector<SPIRVEntry *> SPIRVIdToEntryMap;
+  typedef std::map<SPIRVId, SPIRVEntry *> SPIRVSparseIdToEntryMap;
   typedef std::map<SPIRVTypeStruct*,
       std::vector<std::pair<unsigned, SPIRVId> > > SPIRVUnknownStructFieldMap;
   typedef std::unordered_set<SPIRVEntry *> SPIRVEntrySet;
-  typedef std::set<SPIRVId> SPIRVIdSet;
+  typedef std::unordered_set<SPIRVId> SPIRVIdSet;
   typedef std::vector<SPIRVId> SPIRVIdVec;
   typedef std::vector<SPIRVFunction *> SPIRVFunctionVector;
   typedef std::vector<SPIRVVariable *> SPIRVVariableVec;
@@ -314,7 +322,7 @@ private:
   typedef std::vector<SPIRVLine *> SPIRVLineVec;
   typedef std::vector<SPIRVDecorationGroup *> SPIRVDecGroupVec;
   typedef std::vector<SPIRVGroupDecorateGeneric *> SPIRVGroupDecVec;
-  typedef std::map<SPIRVId, SPIRVExtInstSetKind> SPIRVIdToBuiltinSetMap;
+  typedef std::unordered_map<SPIRVId, SPIRVExtInstSetKind> SPIRVIdToBuiltinSetMap;
   typedef std::map<SPIRVExecutionModelKind, SPIRVIdSet> SPIRVExecModelIdSetMap;
   typedef std::map<SPIRVExecutionModelKind, SPIRVIdVec> SPIRVExecModelIdVecMap;
   typedef std::unordered_map<std::string, SPIRVString*> SPIRVStringMap;
@@ -322,6 +330,8 @@ private:
 
   SPIRVAsmVector AsmVec;
   SPIRVIdToEntryMap IdEntryMap;
+  SPIRVSparseIdToEntryMap SparseIdEntryMap;
+  size_t DenseIdLimit;
   SPIRVUnknownStructFieldMap UnknownStructFieldMap;
   SPIRVFunctionVector FuncVec;
   SPIRVVariableVec VariableVec;
@@ -338,15 +348,28 @@ private:
   SPIRVStringMap StrMap;
   SPIRVCapSet CapSet;
   SPIRVSpecConstantMap *SCMap;
-  std::map<unsigned, SPIRVTypeInt*> IntTypeMap;
-  std::map<unsigned, SPIRVConstant*> LiteralMap;
+  std::unordered_map<unsigned, SPIRVTypeInt*> IntTypeMap;
+  std::unordered_map<unsigned, SPIRVConstant*> LiteralMap;
 
   void layoutEntry(SPIRVEntry* Entry);
+  SPIRVEntry *lookupEntry(SPIRVId Id) const;
+  void mapEntry(SPIRVId Id, SPIRVEntry* Entry);
+  void unmapEntry(SPIRVId Id);
+
+  // Calls F on every mapped entry in ascending id order; every dense id is
+  // below every sparse one.
+  template <typename FnT>
+  void forEachEntry(FnT F) const {
+    for (auto *Entry : IdEntryMap)
+      if (Entry)
+        F(Entry);
+    for (auto &IdAndEntry : SparseIdEntryMap)
+      F(IdAndEntry.second);
+  }
 };
 
 SPIRVModuleImpl::~SPIRVModuleImpl() {
-    for (auto I : IdEntryMap)
-        delete I.second;
+    forEachEntry([](SPIRVEntry* I) { delete I; });
 
     for (auto I : EntryNoId)
         delete I;
@@ -455,7 +478,7 @@ SPIRVModuleImpl::addEntry(SPIRVEntry *Entry) {
         }
         else
         {
-            IdEntryMap[Id] = Entry;
+            mapEntry(Id, Entry);
         }
     }
     else
@@ -469,6 +492,36 @@ SPIRVModuleImpl::addEntry(SPIRVEntry *Entry) {
     return Entry;
 }
 
+SPIRVEntry *
+SPIRVModuleImpl::lookupEntry(SPIRVId Id) const {
+  if (Id < IdEntryMap.size())
+    return IdEntryMap[Id];
+  if (Id < DenseIdLimit)
+    return nullptr;
+  auto Loc = SparseIdEntryMap.find(Id);
+  return Loc == SparseIdEntryMap.end() ? nullptr : Loc->second;
+}
+
+void
+SPIRVModuleImpl::mapEntry(SPIRVId Id, SPIRVEntry* Entry) {
+  if (Id >= DenseIdLimit) {
+    SparseIdEntryMap[Id] = Entry;
+    return;
+  }
+  if (Id >= IdEntryMap.size())
+    IdEntryMap.resize(std::min<size_t>(
+        std::max<size_t>(Id + 1, IdEntryMap.size() * 2), DenseIdLimit));
+  IdEntryMap[Id] = Entry;
+}
+
+void
+SPIRVModuleImpl::unmapEntry(SPIRVId Id) {
+  if (Id < IdEntryMap.size())
+    IdEntryMap[Id] = nullptr;
+  else
+    SparseIdEntryMap.erase(Id);
+}
+
 bool
 SPIRVModuleImpl::exist(SPIRVId Id) const {
   return exist(Id, nullptr);
@@ -477,11 +530,11 @@ SPIRVModuleImpl::exist(SPIRVId Id) const {
 bool
 SPIRVModuleImpl::exist(SPIRVId Id, SPIRVEntry **Entry) const {
   IGC_ASSERT_MESSAGE(Id != SPIRVID_INVALID, "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  if (Loc == IdEntryMap.end())
+  SPIRVEntry *Mapped = lookupEntry(Id);
+  if (!Mapped)
     return false;
   if (Entry)
-    *Entry = Loc->second;
+    *Entry = Mapped;
   return true;
 }
 
@@ -500,9 +553,9 @@ SPIRVModuleImpl::getId(SPIRVId Id, unsigned increment) {
 SPIRVEntry *
 SPIRVModuleImpl::getEntry(SPIRVId Id) const {
   IGC_ASSERT_MESSAGE(Id != SPIRVID_INVALID, "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  IGC_ASSERT_EXIT_MESSAGE(Loc != IdEntryMap.end(), "Id is not in map");
-  return Loc->second;
+  SPIRVEntry *Entry = lookupEntry(Id);
+  IGC_ASSERT_EXIT_MESSAGE(Entry, "Id is not in map");
+  return Entry;
 }
 
 void
@@ -653,13 +706,12 @@ SPIRVModuleImpl::replaceForward(SPIRVForward *Forward, SPIRVEntry *Entry) {
   SPIRVId Id = Entry->getId();
   SPIRVId ForwardId = Forward->getId();
   if (ForwardId == Id)
-    IdEntryMap[Id] = Entry;
+    mapEntry(Id, Entry);
   else {
-    auto Loc = IdEntryMap.find(Id);
-    IGC_ASSERT_EXIT(Loc != IdEntryMap.end());
-    IdEntryMap.erase(Loc);
+    IGC_ASSERT_EXIT(lookupEntry(Id));
+    unmapEntry(Id);
     Entry->setId(ForwardId);
-    IdEntryMap[ForwardId] = Entry;
+    mapEntry(ForwardId, Entry);
   }
   // Annotations include name, decorations, execution modes
   Entry->takeAnnotations(Forward);
@@ -788,8 +840,8 @@ SPIRVModuleImpl::addMemberName(SPIRVTypeStruct* ST,
   return add(new SPIRVMemberName(ST, MemberNumber, Name));
 }
 
-std::istream &
-operator>> (std::istream &I, SPIRVModule &M) {
+SPIRVInputStream &
+operator>> (SPIRVInputStream &I, SPIRVModule &M) {
   SPIRVDecoder Decoder(I, M);
   SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl*>(&M);
 
@@ -809,6 +861,14 @@ operator>> (std::istream &I, SPIRVModule &M) {
 
   // Bound for Id
   Decoder >> MI.NextId;
+  // Every id needs an instruction of at least two words, so a bound past the
+  // input size is not trusted for the initial table size. Neither bound nor
+  // ids are trusted for the table's growth: ids past twice the word count
+  // are mapped sparsely, which keeps the table within a few times the input
+  // size while leaving room for ids created after reading.
+  const size_t NumWords = I.size() / sizeof(SPIRVWord);
+  MI.DenseIdLimit = std::max<size_t>(2 * NumWords, 1024);
+  MI.IdEntryMap.resize(std::min<size_t>(MI.NextId, NumWords));
 
   Decoder >> MI.InstSchema;
   IGC_ASSERT_MESSAGE(MI.InstSchema == SPIRVISCH_Default, "Unsupported instruction schema");
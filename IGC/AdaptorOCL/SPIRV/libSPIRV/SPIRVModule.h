@@ -230,7 +230,7 @@ public:
   virtual std::vector<SPIRVValue*> parseSpecConstants() = 0;
 
   // I/O functions
-  friend std::istream & operator>>(std::istream &I, SPIRVModule& M);
+  friend SPIRVInputStream & operator>>(SPIRVInputStream &I, SPIRVModule& M);
 };
 
 class SPIRVDbgInfo {
@@ -71,11 +71,11 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace spv{
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVFunction &F)
   :IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
    Scope(&F){}
 
-SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVBasicBlock &BB)
+SPIRVDecoder::SPIRVDecoder(SPIRVInputStream &InputStream, SPIRVBasicBlock &BB)
   :IS(InputStream), M(*BB.getModule()), WordCount(0), OpCode(OpNop),
    Scope(&BB){}
 
@@ -88,8 +88,8 @@ SPIRVDecoder::setScope(SPIRVEntry *TheScope) {
 
 template<>
 const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
-   SPIRVWord W;
-   I.IS.read(reinterpret_cast<char*>(&W), sizeof(W));
+   SPIRVWord W = 0;
+   I.IS.read(W);
    V = (W == 0) ? false : true;
    return I;
 }
@@ -97,7 +97,7 @@ const SPIRVDecoder& DecodeBinary(const SPIRVDecoder& I, bool &V) {
 template<>
 const SPIRVDecoder&
 DecodeBinary(const SPIRVDecoder& I, SPIRVWord &V) {
-   I.IS.read(reinterpret_cast<char*>(&V), sizeof(V));
+   I.IS.read(V);
    return I;
 }
 
@@ -152,18 +152,7 @@ SPIRV_DEF_DEC(OCLExtOpDbgKind)
 // words.
 const SPIRVDecoder&
 operator>>(const SPIRVDecoder&I, std::string& Str) {
-  uint64_t Count = 0;
-  char Ch;
-  while ((!I.IS.eof() && I.IS.get(Ch)) && Ch != '\0') {
-    Str += Ch;
-    ++Count;
-  }
-  Count = (Count + 1) % 4;
-  Count = Count ? 4 - Count : 0;
-  for (;Count; --Count) {
-    (!I.IS.eof() && I.IS.get(Ch));
-    IGC_ASSERT(Ch == '\0' && "Invalid string in SPIRV");
-  }
+  I.IS.read(Str);
   return I;
 }
 
@@ -71,7 +71,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "SPIRVExtInst.h"
 #include <algorithm>
 #include <cstdint>
-#include <iostream>
+#include <cstring>
 #include <iterator>
 #include <vector>
 #include <string>
@@ -81,20 +81,104 @@ namespace spv{
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+/// Input of SPIRVDecoder: a bounds-checked cursor over a SPIR-V binary held
+/// by the caller. The words are read in place; only a module of the opposite
+/// endianness is copied, to swap all of its words once.
+///
+/// The state queries follow std::istream, which this replaced: eof() and
+/// fail() are set by the first read past the end and stay set.
+class SPIRVInputStream {
+public:
+  SPIRVInputStream(const char *TheData, size_t TheSize)
+    :Data(TheData), Size(TheSize), Pos(0), AtEnd(false), Failed(false) {
+    SPIRVWord First = 0;
+    if (Size >= sizeof(First))
+      memcpy(&First, Data, sizeof(First));
+    if (First == swap(SPIRVMagicNumber)) {
+      Swapped.resize(Size / sizeof(SPIRVWord));
+      memcpy(Swapped.data(), Data, Swapped.size() * sizeof(SPIRVWord));
+      for (SPIRVWord &W : Swapped)
+        W = swap(W);
+      Data = reinterpret_cast<const char *>(Swapped.data());
+      Size = Swapped.size() * sizeof(SPIRVWord);
+    }
+  }
+
+  bool eof() const { return AtEnd; }
+  bool fail() const { return Failed; }
+  bool bad() const { return false; }
+  size_t tellg() const { return Pos; }
+  size_t size() const { return Size; }
+  void seekg(size_t ThePos) {
+    IGC_ASSERT(ThePos <= Size);
+    Pos = ThePos;
+    AtEnd = false;
+  }
+
+  bool read(SPIRVWord &W) {
+    if (Failed || Size - Pos < sizeof(W))
+      return setEnd();
+    memcpy(&W, Data + Pos, sizeof(W));
+    Pos += sizeof(W);
+    return true;
+  }
+
+  /// Read a nul-terminated literal string and its padding to a word
+  /// boundary.
+  bool read(std::string &Str) {
+    if (Failed)
+      return false;
+    const char *Begin = Data + Pos;
+    const char *Nul = static_cast<const char *>(memchr(Begin, '\0', Size - Pos));
+    if (!Nul) {
+      Str.append(Begin, Size - Pos);
+      Pos = Size;
+      return setEnd();
+    }
+    size_t Len = Nul - Begin;
+    Str.append(Begin, Len);
+    size_t Padded = (Len + sizeof(SPIRVWord)) & ~(sizeof(SPIRVWord) - 1);
+    if (Padded > Size - Pos) {
+      Pos = Size;
+      return setEnd();
+    }
+    for (size_t I = Len; I != Padded; ++I)
+      IGC_ASSERT(Begin[I] == '\0' && "Invalid string in SPIRV");
+    Pos += Padded;
+    return true;
+  }
+
+private:
+  static SPIRVWord swap(SPIRVWord W) {
+    return (W >> 24) | ((W >> 8) & 0xFF00) | ((W << 8) & 0xFF0000) | (W << 24);
+  }
+  bool setEnd() {
+    AtEnd = Failed = true;
+    return false;
+  }
+
+  const char *Data;
+  size_t Size;
+  size_t Pos;
+  bool AtEnd;
+  bool Failed;
+  std::vector<SPIRVWord> Swapped;
+};
+
 class SPIRVDecoder {
 public:
-  SPIRVDecoder(std::istream& InputStream, SPIRVModule& Module)
+  SPIRVDecoder(SPIRVInputStream& InputStream, SPIRVModule& Module)
     :IS(InputStream), M(Module), WordCount(0), OpCode(OpNop),
      Scope(NULL){}
-  SPIRVDecoder(std::istream& InputStream, SPIRVFunction& F);
-  SPIRVDecoder(std::istream& InputStream, SPIRVBasicBlock &BB);
+  SPIRVDecoder(SPIRVInputStream& InputStream, SPIRVFunction& F);
+  SPIRVDecoder(SPIRVInputStream& InputStream, SPIRVBasicBlock &BB);
 
   void setScope(SPIRVEntry *);
   bool getWordCountAndOpCode();
   SPIRVEntry *getEntry();
   void validate()const;
 
-  std::istream &IS;
+  SPIRVInputStream &IS;
   SPIRVModule &M;
   SPIRVWord WordCount;
   Op OpCode;
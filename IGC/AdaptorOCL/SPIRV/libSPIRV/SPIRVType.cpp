@@ -288,7 +288,7 @@ SPIRVType::isTypeVectorOrScalarFloat() const {
   return isTypeFloat() || isTypeVectorFloat();
 }
 
-void SPIRVTypeStruct::decode(std::istream &I)
+void SPIRVTypeStruct::decode(SPIRVInputStream &I)
 {
     SPIRVDecoder Decoder = getDecoder(I);
     Decoder >> Id;
@@ -366,7 +366,7 @@ SPIRVTypeArray::getLength() const {
 
 _SPIRV_IMP_DEC3(SPIRVTypeArray, Id, ElemType, Length)
 
-void SPIRVTypeForwardPointer::decode(std::istream& I) {
+void SPIRVTypeForwardPointer::decode(SPIRVInputStream& I) {
   auto Decoder = getDecoder(I);
   SPIRVId PointerId;
   Decoder >> PointerId >> SC;
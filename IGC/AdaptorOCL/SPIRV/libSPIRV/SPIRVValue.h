@@ -208,7 +208,7 @@ protected:
     SPIRVValue::setWordCount(WordCount);
     NumWords = WordCount - 3;
   }
-  void decode(std::istream &I) {
+  void decode(SPIRVInputStream &I) {
     getDecoder(I) >> Type >> Id;
     validate();
     for (unsigned i = 0; i < NumWords; ++i)
@@ -338,7 +338,7 @@ protected:
     Elements.resize(WordCount - FixedWC);
   }
 
-  void decode(std::istream& I) override
+  void decode(SPIRVInputStream& I) override
   {
       SPIRVDecoder Decoder = getDecoder(I);
       Decoder >> Type >> Id >> Elements;
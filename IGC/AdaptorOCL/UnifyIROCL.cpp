@@ -179,7 +179,9 @@ namespace IGC
 static void CommonOCLBasedPasses(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolTable* pGenericSymbols,
+    const BiFSymbolTable* pSizeSymbols)
 {
     IGCPassManager mpm(pContext, "Unify");
 
@@ -333,7 +335,8 @@ static void CommonOCLBasedPasses(
 
     mpm.add(new PreBIImportAnalysis());
     mpm.add(createTimeStatsCounterPass(pContext, TIME_Unify_BuiltinImport, STATS_COUNTER_START));
-    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule)));
+    mpm.add(createBuiltInImportPass(std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        pGenericSymbols, pSizeSymbols));
     mpm.add(createTimeStatsCounterPass(pContext, TIME_Unify_BuiltinImport, STATS_COUNTER_END));
     mpm.add(new UndefinedReferencesPass());
 
@@ -540,17 +543,23 @@ static void CommonOCLBasedPasses(
 void UnifyIROCL(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolTable* pGenericSymbols,
+    const BiFSymbolTable* pSizeSymbols)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        pGenericSymbols, pSizeSymbols);
 }
 
 void UnifyIRSPIR(
     OpenCLProgramContext* pContext,
     std::unique_ptr<llvm::Module> BuiltinGenericModule,
-    std::unique_ptr<llvm::Module> BuiltinSizeModule)
+    std::unique_ptr<llvm::Module> BuiltinSizeModule,
+    const BiFSymbolTable* pGenericSymbols,
+    const BiFSymbolTable* pSizeSymbols)
 {
-    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+    CommonOCLBasedPasses(pContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+        pGenericSymbols, pSizeSymbols);
 }
 
 }
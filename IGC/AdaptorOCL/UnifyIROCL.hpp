@@ -28,13 +28,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace IGC
 {
+    class BiFSymbolTable;
+
     void UnifyIROCL(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFSymbolTable* pGenericSymbols = nullptr,
+        const BiFSymbolTable* pSizeSymbols = nullptr);
 
     void UnifyIRSPIR(
         OpenCLProgramContext* pContext,
         std::unique_ptr<llvm::Module> BuiltinGenericModule,
-        std::unique_ptr<llvm::Module> BuiltinSizeModule);
+        std::unique_ptr<llvm::Module> BuiltinSizeModule,
+        const BiFSymbolTable* pGenericSymbols = nullptr,
+        const BiFSymbolTable* pSizeSymbols = nullptr);
 }
\ No newline at end of file
@@ -39,16 +39,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AdaptorCommon/customApi.hpp"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
 #include "AdaptorOCL/OCL/BuiltinResource.h"
+#include "AdaptorOCL/OCL/BiFCache.h"
+#include "AdaptorOCL/OCL/KernelCache.h"
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
+#include "Compiler/Optimizer/OpenCLPasses/RemoveFinishedKernels/RemoveFinishedKernels.hpp"
+#include "common/LLVMUtils.h"
 #include "common/debug/Dump.hpp"
 #include "common/debug/Debug.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
+#include "common/CompileTrace.h"
 #include "common/shaderOverride.hpp"
 
 #include "CLElfLib/ElfReader.h"
@@ -72,6 +77,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "AdaptorOCL/SPIRV/libSPIRV/SPIRVModule.h"
 #include "AdaptorOCL/SPIRV/libSPIRV/SPIRVValue.h"
+#include "AdaptorOCL/SPIRV/libSPIRV/SPIRVStream.h"
 #endif
 
 #ifdef IGC_SPIRV_TOOLS_ENABLED
@@ -468,13 +474,12 @@ bool ProcessElfInput(
               llvm::Module* pKernelModule = nullptr;
 #if defined(IGC_SPIRV_ENABLED)
               Context.setAsSPIRV();
-              std::istringstream IS(buf.str());
               std::string stringErrMsg;
               std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
                                                                                   InputArgs.pSpecConstantsIds,
                                                                                   InputArgs.pSpecConstantsValues,
                                                                                   InputArgs.SpecConstantsSize);
-              bool success = spv::ReadSPIRV(*Context.getLLVMContext(), IS, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
+              bool success = spv::ReadSPIRV(*Context.getLLVMContext(), buf, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
               // handle OpenCL Compiler Options
               GenerateCompilerOptionsMD(
                   *Context.getLLVMContext(),
@@ -715,13 +720,12 @@ bool ParseInput(
     else if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
 #if defined(IGC_SPIRV_ENABLED)
         //convert SPIR-V binary to LLVM module
-        std::istringstream IS(strInput.str());
         std::string stringErrMsg;
         std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
                                                                             pInputArgs->pSpecConstantsIds,
                                                                             pInputArgs->pSpecConstantsValues,
                                                                             pInputArgs->SpecConstantsSize);
-        bool success = spv::ReadSPIRV(oclContext, IS, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
+        bool success = spv::ReadSPIRV(oclContext, strInput, pKernelModule, stringErrMsg, &specIDToSpecValueMap);
         // handle OpenCL Compiler Options
         GenerateCompilerOptionsMD(
             oclContext,
@@ -760,11 +764,12 @@ bool ParseInput(
 }
 
 #if defined(IGC_SPIRV_ENABLED)
-bool ReadSpecConstantsFromSPIRV(std::istream &IS, std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo)
+bool ReadSpecConstantsFromSPIRV(llvm::StringRef Input, std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo)
 {
     using namespace spv;
 
     std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
+    SPIRVInputStream IS(Input.data(), Input.size());
     IS >> *BM;
 
     auto SPV = BM->parseSpecConstants();
@@ -840,10 +845,81 @@ void dumpOCLProgramBinary(OpenCLProgramContext &Ctx, char *binaryOutput, int bin
 #endif
 }
 
-static std::unique_ptr<llvm::MemoryBuffer> GetGenericModuleBuffer() {
-    char Resource[5] = {'-'};
-    _snprintf(Resource, sizeof(Resource), "#%d", OCL_BC);
-    return std::unique_ptr<llvm::MemoryBuffer>{llvm::LoadBufferFromResource(Resource, "BC")};
+static void recordBiFCacheAccess(OpenCLProgramContext &Ctx, bool isHit)
+{
+    COMPILER_COUNTER_ADD(&Ctx, isHit ? COUNTER_OCL_BiFCacheHit : COUNTER_OCL_BiFCacheMiss, 1);
+}
+
+// Dumps, overrides and instrumentation all need an actual compile, so the
+// kernel cache is bypassed whenever any of them is requested.
+static bool canUseKernelCache(const STB_TranslateInputArgs* pInputArgs)
+{
+    return IGC_IS_FLAG_ENABLED(EnableKernelCache) &&
+        IGC_IS_FLAG_DISABLED(ShaderDumpEnable) &&
+        IGC_IS_FLAG_DISABLED(ShaderOverride) &&
+        !GTPIN_IGC_OCL_IsEnabled() &&
+        !(IGC_IS_FLAG_ENABLED(EnableReadGTPinInput) && pInputArgs->GTPinInput) &&
+        pInputArgs->TracingOptionsCount == 0 &&
+        KernelCache::get().isEnabled();
+}
+
+// Same convention as the BiF cache: hits and misses are the hit counts of
+// the corresponding timers, the lookup latency is their parent's time.
+static void recordKernelCacheAccess(OpenCLProgramContext &Ctx, bool isHit)
+{
+    COMPILE_TIME_INTERVALS timer = isHit ? TIME_OCL_KernelCacheHit : TIME_OCL_KernelCacheMiss;
+    COMPILER_TIME_START(&Ctx, timer);
+    COMPILER_TIME_END(&Ctx, timer);
+}
+
+// State of the program right after unification. Besides the module, this
+// holds the context flags that unification computes and clear() resets.
+struct UnifiedModuleSnapshot
+{
+    llvm::SmallVector<char, 0> Bitcode;
+    bool EnableSubroutine = false;
+    bool EnableFunctionPointer = false;
+};
+
+static void SaveUnifiedModule(OpenCLProgramContext &Ctx, UnifiedModuleSnapshot &Snapshot)
+{
+    // Make sure the metadata held by the context is reflected in the module.
+    Ctx.getMetaDataUtils()->save(*Ctx.getLLVMContext());
+    serialize(*Ctx.getModuleMetaData(), Ctx.getModule());
+
+    Snapshot.Bitcode.clear();
+    llvm::raw_svector_ostream OS(Snapshot.Bitcode);
+    IGCLLVM::WriteBitcodeToFile(Ctx.getModule(), OS);
+    Snapshot.EnableSubroutine = Ctx.m_enableSubroutine;
+    Snapshot.EnableFunctionPointer = Ctx.m_enableFunctionPointer;
+}
+
+static bool RestoreUnifiedModule(OpenCLProgramContext &Ctx, const UnifiedModuleSnapshot &Snapshot)
+{
+    llvm::MemoryBufferRef Buf(
+        llvm::StringRef(Snapshot.Bitcode.data(), Snapshot.Bitcode.size()), "<unified>");
+    llvm::Expected<std::unique_ptr<llvm::Module>> MOE =
+        llvm::parseBitcodeFile(Buf, *Ctx.getLLVMContext());
+    if (llvm::Error E = MOE.takeError())
+    {
+        llvm::consumeError(std::move(E));
+        return false;
+    }
+
+    llvm::Module *M = MOE->release();
+    Ctx.setModule(M);
+    deserialize(*Ctx.getModuleMetaData(), M);
+    // Set by ProcessFuncAttributes during unification, which is skipped.
+    Ctx.m_enableSubroutine = Snapshot.EnableSubroutine;
+    Ctx.m_enableFunctionPointer = Snapshot.EnableFunctionPointer;
+
+    // Drop the kernels that compiled without spilling on the previous try.
+    IGCPassManager mpm(&Ctx, "RetryRestore");
+    mpm.add(new MetaDataUtilsWrapper(Ctx.getMetaDataUtils(), Ctx.getModuleMetaData()));
+    mpm.add(new CodeGenContextWrapper(&Ctx));
+    mpm.add(new RemoveFinishedKernels());
+    mpm.run(*M);
+    return true;
 }
 
 bool TranslateBuild(
@@ -853,6 +929,15 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution)
 {
+    const char* tracePath = IGC_GET_REGKEYSTRING(CompileTraceFile);
+    if (tracePath && tracePath[0] != '\0')
+    {
+        CompileTrace::Tracer::get().enable(tracePath);
+    }
+    // Declared first, so that the build event is recorded before the flush.
+    CompileTrace::FlushScope traceFlush;
+    CompileTrace::Scope traceBuild("TranslateBuild", "OCL");
+
 #if !defined(WDDM_LINUX) && (!defined(IGC_VC_DISABLED) || !IGC_VC_DISABLED)
     if (pInputArgs->pOptions) {
         std::error_code Status =
@@ -947,10 +1032,6 @@ bool TranslateBuild(
         DumpShaderFile(pOutputFolder, cmdfile.str().c_str(), cmdfile.str().size(), hash, "_cmd.txt");
     }
 
-    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
-    {
-        return false;
-    }
     CDriverInfoOCLNEO driverInfoOCL;
     IGC::CDriverInfo* driverInfo = &driverInfoOCL;
 
@@ -969,6 +1050,49 @@ bool TranslateBuild(
 #endif // __GNUC__
 
     COMPILER_TIME_START(&oclContext, TIME_TOTAL);
+
+    // Look the program up before parsing, so that hits skip the whole compile.
+    const bool useKernelCache = canUseKernelCache(pInputArgs);
+    std::string kernelCacheKey;
+    if (useKernelCache)
+    {
+        COMPILER_TIME_START(&oclContext, TIME_OCL_KernelCacheLookup);
+        kernelCacheKey = KernelCache::getKey(*pInputArgs, inputDataFormatTemp, IGCPlatform,
+            profilingTimerResolution, inputShHash.getAsmHash());
+        KernelCache::Entry cached;
+        bool isHit = KernelCache::get().lookup(kernelCacheKey, cached);
+        recordKernelCacheAccess(oclContext, isHit);
+        COMPILER_TIME_END(&oclContext, TIME_OCL_KernelCacheLookup);
+
+        if (isHit)
+        {
+            pOutputArgs->OutputSize = int_cast<int>(cached.BinarySize);
+            pOutputArgs->pOutput = cached.Binary.release();
+            if (cached.DebugDataSize > 0)
+            {
+                pOutputArgs->DebugDataSize = int_cast<int>(cached.DebugDataSize);
+                pOutputArgs->pDebugData = cached.DebugData.release();
+            }
+
+            // Replay the warnings the original compile reported.
+            if (!cached.BuildLog.empty())
+            {
+                SetErrorMessage(cached.BuildLog, *pOutputArgs);
+            }
+
+            COMPILER_TIME_END(&oclContext, TIME_TOTAL);
+            COMPILER_TIME_PRINT(&oclContext, ShaderType::OPENCL_SHADER, inputShHash);
+            COMPILER_TIME_DEL(&oclContext, m_compilerTimeStats);
+            return true;
+        }
+    }
+
+    if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *llvmContext, inputDataFormatTemp))
+    {
+        COMPILER_TIME_DEL(&oclContext, m_compilerTimeStats);
+        return false;
+    }
+
     oclContext.m_ProfilingTimerResolution = profilingTimerResolution;
 
     if(inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V)
@@ -1001,127 +1125,132 @@ bool TranslateBuild(
     }
 
     unsigned PtrSzInBits = pKernelModule->getDataLayout().getPointerSizeInBits();
-    //TODO: Again, this should not happen on each compilation
 
     /// set retry manager
     bool retry = false;
     oclContext.m_retryManager.Enable();
+
+    // Bitcode of the module right after unification. A retry restores it
+    // instead of parsing the input and linking builtins again.
+    UnifiedModuleSnapshot unifiedModuleSnapshot;
+    bool restoredFromSnapshot = false;
+    unsigned attempt = 0;
     do
     {
-        std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
-        std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        CompileTrace::Scope traceAttempt("Compile attempt", "OCL", "attempt", attempt++);
+
+        // On an incremental retry the post-unification module has been
+        // restored from the snapshot, so parsing and BiF linking are skipped.
+        if (!restoredFromSnapshot)
         {
-            // IGC has two BIF Modules:
-            //            1. kernel Module (pKernelModule)
-            //            2. BIF Modules:
-            //                 a) generic Module (BuiltinGenericModule)
-            //                 b) size Module (BuiltinSizeModule)
-            //
-            // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
-            // those types, its original names are themselves; the derived names are ones with
-            // '.<digit>' appended to the original names. For example,  clk_event_t is the original
-            // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
-            //
-            // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
-            // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
-            // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
-            // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
-            // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
-            // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
-            // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
-            // used in M0.
-
-            // Load the builtin module -  Generic BC
-            // Load the builtin module -  Generic BC
+            std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
+            std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
+            const BiFSymbolTable* BuiltinGenericSymbols = nullptr;
+            const BiFSymbolTable* BuiltinSizeSymbols = nullptr;
             {
+                // IGC has two BIF Modules:
+                //            1. kernel Module (pKernelModule)
+                //            2. BIF Modules:
+                //                 a) generic Module (BuiltinGenericModule)
+                //                 b) size Module (BuiltinSizeModule)
+                //
+                // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
+                // those types, its original names are themselves; the derived names are ones with
+                // '.<digit>' appended to the original names. For example,  clk_event_t is the original
+                // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
+                //
+                // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
+                // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
+                // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
+                // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
+                // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
+                // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
+                // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
+                // used in M0.
+
+                // Builtin bitcode is loaded once per process by BiFCache; here we only
+                // create lazy modules for this compile's context.
                 COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
+                BiFCache& bifCache = BiFCache::get();
 
-                pGenericBuffer = GetGenericModuleBuffer();
-
-                if (pGenericBuffer == NULL)
+                // Load the builtin module -  Generic BC
                 {
-                    SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
-                    return false;
-                }
-
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    bool isHit = false;
+                    BuiltinGenericModule = bifCache.getLazyModule(
+                        BiFCache::BIF_GENERIC, *oclContext.getLLVMContext(), isHit);
+                    recordBiFCacheAccess(oclContext, isHit);
+                    BuiltinGenericSymbols = bifCache.getSymbolTable(BiFCache::BIF_GENERIC);
 
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                {
-                    std::string error_str = "Error lazily loading bitcode for generic builtins,"
-                                            "is bitcode the right version and correctly formed?";
-                    SetErrorMessage(error_str, *pOutputArgs);
-                    return false;
-                }
-                else
-                {
-                    BuiltinGenericModule = std::move(*ModuleOrErr);
+                    if (BuiltinGenericModule == NULL)
+                    {
+                        std::string error_str = "Error lazily loading bitcode for generic builtins,"
+                                                "is bitcode the right version and correctly formed?";
+                        SetErrorMessage(error_str, *pOutputArgs);
+                        return false;
+                    }
                 }
 
-                if (BuiltinGenericModule == NULL)
+                // Load the builtin module -  pointer depended
                 {
-                    SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
-                    return false;
+                    BiFCache::BiFKind sizeKind = BiFCache::BIF_SIZE_64;
+                    switch (PtrSzInBits)
+                    {
+                    case 32:
+                        sizeKind = BiFCache::BIF_SIZE_32;
+                        break;
+                    case 64:
+                        sizeKind = BiFCache::BIF_SIZE_64;
+                        break;
+                    default:
+                        IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
+                    }
+
+                    bool isHit = false;
+                    BuiltinSizeModule = bifCache.getLazyModule(
+                        sizeKind, *oclContext.getLLVMContext(), isHit);
+                    recordBiFCacheAccess(oclContext, isHit);
+                    BuiltinSizeSymbols = bifCache.getSymbolTable(sizeKind);
+
+                    IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
                 }
                 COMPILER_TIME_END(&oclContext, TIME_OCL_LazyBiFLoading);
+
+                BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
+                BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
+            }
+
+            oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
+
+            if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
+            {
+                IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+                    BuiltinGenericSymbols, BuiltinSizeSymbols);
+            }
+            else // not SPIR
+            {
+                IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule),
+                    BuiltinGenericSymbols, BuiltinSizeSymbols);
             }
 
-            // Load the builtin module -  pointer depended
+            if (!(oclContext.oclErrorMessage.empty()))
             {
-                char ResNumber[5] = { '-' };
-                switch (PtrSzInBits)
+                 //The error buffer returned will be deleted when the module is unloaded so
+                 //a copy is necessary
+                if (const char *pErrorMsg = oclContext.oclErrorMessage.c_str())
                 {
-                case 32:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
-                    break;
-                case 64:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
-                    break;
-                default:
-                    IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
+                    SetErrorMessage(oclContext.oclErrorMessage, *pOutputArgs);
                 }
-
-                // the MemoryBuffer becomes owned by the module and does not need to be managed
-                pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
-                IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
-
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                    IGC_ASSERT_MESSAGE(0, "Error lazily loading bitcode for size_t builtins");
-                else
-                    BuiltinSizeModule = std::move(*ModuleOrErr);
-
-                IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
+                return false;
             }
 
-            BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
-            BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
-        }
-
-        oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
-
-        if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
-        {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
-        else // not SPIR
-        {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
-
-        if (!(oclContext.oclErrorMessage.empty()))
-        {
-             //The error buffer returned will be deleted when the module is unloaded so
-             //a copy is necessary
-            if (const char *pErrorMsg = oclContext.oclErrorMessage.c_str())
+            if (IGC_IS_FLAG_ENABLED(EnableIncrementalOCLRetry) &&
+                IGC_IS_FLAG_DISABLED(DisableRecompilation) &&
+                !oclContext.getModuleMetaData()->compOpt.OptDisable)
             {
-                SetErrorMessage(oclContext.oclErrorMessage, *pOutputArgs);
+                COMPILER_TIME_START(&oclContext, TIME_OCL_RetrySnapshot);
+                SaveUnifiedModule(oclContext, unifiedModuleSnapshot);
+                COMPILER_TIME_END(&oclContext, TIME_OCL_RetrySnapshot);
             }
-            return false;
         }
 
         // Compiler Options information available after unification.
@@ -1138,11 +1267,18 @@ bool TranslateBuild(
         // Now, perform code generation
         IGC::CodeGen(&oclContext);
 
+        if (retry)
+        {
+            COMPILER_TIME_END(&oclContext, TIME_OCL_Retry);
+        }
+
         retry = (oclContext.m_retryManager.AdvanceState() &&
                 !oclContext.m_retryManager.kernelSet.empty());
 
         if (retry)
         {
+            COMPILER_TIME_START(&oclContext, TIME_OCL_Retry);
+
             oclContext.clear();
 
             // Create a new LLVMContext
@@ -1150,11 +1286,25 @@ bool TranslateBuild(
 
             IGC::Debug::RegisterComputeErrHandlers(*oclContext.getLLVMContext());
 
-            if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+            restoredFromSnapshot = false;
+            if (!unifiedModuleSnapshot.Bitcode.empty())
             {
-                return false;
+                COMPILER_TIME_START(&oclContext, TIME_OCL_RetrySnapshot);
+                restoredFromSnapshot = RestoreUnifiedModule(oclContext, unifiedModuleSnapshot);
+                COMPILER_TIME_END(&oclContext, TIME_OCL_RetrySnapshot);
+            }
+
+            if (!restoredFromSnapshot)
+            {
+                if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+                {
+                    COMPILER_TIME_END(&oclContext, TIME_OCL_Retry);
+                    COMPILER_TIME_END(&oclContext, TIME_TOTAL);
+                    COMPILER_TIME_DEL(&oclContext, m_compilerTimeStats);
+                    return false;
+                }
+                oclContext.setModule(pKernelModule);
             }
-            oclContext.setModule(pKernelModule);
         }
     } while (retry);
 
@@ -1174,37 +1324,30 @@ bool TranslateBuild(
 
     // FIXME: zebin currently only support program output itself, will add debug info
     // into it
-    int binarySize = 0;
-    char* binaryOutput = nullptr;
 
+    // Both formats are written into a stream sized up front, whose buffer is
+    // then handed over to the caller as is.
+    Util::BinaryStream programBinary;
     if (!IGC_IS_FLAG_ENABLED(EnableZEBinary) &&
         !oclContext.getModuleMetaData()->compOpt.EnableZEBinary) {
-        Util::BinaryStream programBinary;
         // Patch token based binary format
         oclContext.m_programOutput.CreateKernelBinaries();
         oclContext.m_programOutput.GetProgramBinary(programBinary, pointerSizeInBytes);
-        binarySize = static_cast<int>(programBinary.Size());
-        binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, (char*)programBinary.GetLinearPointer(), binarySize);
     } else {
         // ze binary foramt
-        llvm::SmallVector<char, 64> buf;
-        llvm::raw_svector_ostream llvm_os(buf);
         const char* spv_data = nullptr;
         uint32_t spv_size = 0;
         if (inputDataFormatTemp == TB_DATA_FORMAT_SPIR_V) {
             spv_data = pInputArgs->pInput;
             spv_size = pInputArgs->InputSize;
         }
-        oclContext.m_programOutput.GetZEBinary(llvm_os, pointerSizeInBytes,
+        oclContext.m_programOutput.GetZEBinary(programBinary, pointerSizeInBytes,
             spv_data, spv_size);
-
-        // FIXME: try to avoid memory copy here
-        binarySize = buf.size();
-        binaryOutput = new char[binarySize];
-        memcpy_s(binaryOutput, binarySize, buf.data(), buf.size());
     }
 
+    int binarySize = static_cast<int>(programBinary.Size());
+    char* binaryOutput = programBinary.Release();
+
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
         dumpOCLProgramBinary(oclContext, binaryOutput, binarySize);
 
@@ -1221,11 +1364,24 @@ bool TranslateBuild(
     int debugDataSize = int_cast<int>(programDebugData.Size());
     if (debugDataSize > 0)
     {
-        char* debugDataOutput = new char[debugDataSize];
-        memcpy_s(debugDataOutput, debugDataSize, (char*)programDebugData.GetLinearPointer(), debugDataSize);
-
         pOutputArgs->DebugDataSize = debugDataSize;
-        pOutputArgs->pDebugData = debugDataOutput;
+        pOutputArgs->pDebugData = programDebugData.Release();
+    }
+
+    if (useKernelCache)
+    {
+        COMPILER_TIME_START(&oclContext, TIME_OCL_KernelCacheStore);
+        // The error string of a successful build holds its warnings.
+        llvm::StringRef buildLog;
+        if (pOutputArgs->pErrorString && pOutputArgs->ErrorStringSize > 0)
+        {
+            buildLog = llvm::StringRef(pOutputArgs->pErrorString, pOutputArgs->ErrorStringSize - 1);
+        }
+        KernelCache::get().store(kernelCacheKey,
+            llvm::StringRef(binaryOutput, binarySize),
+            llvm::StringRef(pOutputArgs->pDebugData, pOutputArgs->DebugDataSize),
+            buildLog);
+        COMPILER_TIME_END(&oclContext, TIME_OCL_KernelCacheStore);
     }
 
     const char* driverName =
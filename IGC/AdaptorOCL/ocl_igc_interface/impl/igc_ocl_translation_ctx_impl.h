@@ -66,7 +66,7 @@ bool TranslateBuild(
   float profilingTimerResolution);
 
 bool ReadSpecConstantsFromSPIRV(
-    std::istream &IS,
+    llvm::StringRef Input,
     std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo);
 
 }
@@ -123,11 +123,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
 
         if(this->inType == CodeType::spirV){
             llvm::StringRef strInput = llvm::StringRef(pInput, inputSize);
-            std::istringstream IS(strInput.str());
 
             // vector of pairs [spec_id, spec_size]
             std::vector<std::pair<uint32_t, uint32_t>> SCInfo;
-            success = TC::ReadSpecConstantsFromSPIRV(IS, SCInfo);
+            success = TC::ReadSpecConstantsFromSPIRV(strInput, SCInfo);
 
             outSpecConstantsIds->Resize(sizeof(uint32_t) * SCInfo.size());
             outSpecConstantsSizes->Resize(sizeof(uint32_t) * SCInfo.size());
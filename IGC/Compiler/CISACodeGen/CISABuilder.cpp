@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/PixelShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
 #include "common/allocator.h"
 #include "common/Types.hpp"
 #include "common/Stats.hpp"
@@ -38,6 +39,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/secure_string.h"
 #include "common/shaderOverride.hpp"
 #include "common/CompilerStatsUtils.hpp"
+#include "common/CompileTrace.h"
 #include "inc/common/sku_wa.h"
 #include <llvm/ADT/Statistic.h>
 #include <iStdLib/utility.h>
@@ -4396,6 +4398,10 @@ namespace IGC
             SaveOption(vISA_NoRemat, true);
             SaveOption(vISA_SpillSpaceCompression, false);
             SaveOption(vISA_LocalDeclareSplitInGlobalRA, false);
+            if (IGC_IS_FLAG_ENABLED(FastestCompileLinearScanRA))
+            {
+                SaveOption(vISA_LinearScan, true);
+            }
         }
     }
 
@@ -4966,11 +4972,10 @@ namespace IGC
         }
     }
 
-    void CEncoder::Compile(bool hasSymbolTable)
+    bool CEncoder::PrepareCompile(bool hasSymbolTable, VISABuilder*& pBuilder, VISAKernel*& pMainKernel)
     {
         IGC_ASSERT(nullptr != m_program);
         CodeGenContext* const context = m_program->GetContext();
-        SProgramOutput* const pOutput = m_program->ProgramOutput();
 
         if (m_program->m_dispatchSize == SIMDMode::SIMD8)
         {
@@ -4985,8 +4990,8 @@ namespace IGC
             MEM_SNAPSHOT(IGC::SMS_AFTER_CISACreateDestroy_SIMD32);
         }
 
-        int vIsaCompile = 0;
-        VISAKernel* pMainKernel = nullptr;
+        pBuilder = nullptr;
+        pMainKernel = nullptr;
 
         // ShaderOverride for .visaasm files
         std::vector<std::string> visaOverrideFiles;
@@ -5132,7 +5137,7 @@ namespace IGC
             if (vISAAsmParseError)
             {
                 COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
-                return;
+                return false;
             }
             else
             {
@@ -5142,26 +5147,102 @@ namespace IGC
                     vAsmTextBuilder->SetOption(vISA_NoVerifyvISA, true);
                 }
                 pMainKernel = vAsmTextBuilder->GetVISAKernel(kernelName);
-                vIsaCompile = vAsmTextBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+                pBuilder = vAsmTextBuilder;
             }
         }
         //Compile to generate the V-ISA binary
         else
         {
             pMainKernel = vMainKernel;
-            vIsaCompile = vbuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
+            pBuilder = vbuilder;
+        }
+        return true;
+    }
+
+    void CEncoder::Compile(bool hasSymbolTable)
+    {
+        VISABuilder* pBuilder = nullptr;
+        VISAKernel* pMainKernel = nullptr;
+        if (!PrepareCompile(hasSymbolTable, pBuilder, pMainKernel))
+        {
+            return;
+        }
+
+        int vIsaCompile = 0;
+        {
+            CompileTrace::Scope traceCompile("vISA compile", "IGC codegen", "simd", numLanes(m_program->m_dispatchSize));
+            vIsaCompile = pBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
         }
 
         COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
 
 #if GET_TIME_STATS
         // handle the vISA time counters differently here
-        if (context->m_compilerTimeStats)
+        if (m_program->GetContext()->m_compilerTimeStats)
+        {
+            m_program->GetContext()->m_compilerTimeStats->recordVISATimers();
+        }
+#endif
+
+        FinishCompile(hasSymbolTable, pMainKernel, vIsaCompile);
+    }
+
+    void CEncoder::CompileAsync(bool hasSymbolTable)
+    {
+        IGC_ASSERT_MESSAGE(!IsCompilePending(), "previous compile has not been joined");
+        VISABuilder* pBuilder = nullptr;
+        VISAKernel* pMainKernel = nullptr;
+        if (!PrepareCompile(hasSymbolTable, pBuilder, pMainKernel))
+        {
+            return;
+        }
+
+        // Only the emission is accounted to this timer; the vISA timers of
+        // the finalizer are recorded by JoinCompile().
+        COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+
+        m_pendingCompile.hasSymbolTable = hasSymbolTable;
+        m_pendingCompile.pMainKernel = pMainKernel;
+        std::string isaName = m_enableVISAdump ? GetDumpFileName("isa") : "";
+#if GET_TIME_STATS
+        TimeStats::VISATimerValues* visaTimers = &m_pendingCompile.visaTimers;
+#endif
+        unsigned lanes = numLanes(m_program->m_dispatchSize);
+        m_pendingCompile.status = std::async(std::launch::async, [=]()
+        {
+            CompileTrace::Scope traceCompile("vISA compile", "IGC codegen", "simd", lanes);
+            int status = pBuilder->Compile(isaName.c_str());
+#if GET_TIME_STATS
+            TimeStats::captureVISATimers(*visaTimers);
+#endif
+            return status;
+        });
+    }
+
+    void CEncoder::JoinCompile()
+    {
+        if (!IsCompilePending())
+        {
+            return;
+        }
+
+        int vIsaCompile = m_pendingCompile.status.get();
+
+#if GET_TIME_STATS
+        if (m_program->GetContext()->m_compilerTimeStats)
         {
-            context->m_compilerTimeStats->recordVISATimers();
+            m_program->GetContext()->m_compilerTimeStats->recordVISATimers(m_pendingCompile.visaTimers);
         }
 #endif
 
+        FinishCompile(m_pendingCompile.hasSymbolTable, m_pendingCompile.pMainKernel, vIsaCompile);
+    }
+
+    void CEncoder::FinishCompile(bool hasSymbolTable, VISAKernel* pMainKernel, int vIsaCompile)
+    {
+        CodeGenContext* const context = m_program->GetContext();
+        SProgramOutput* const pOutput = m_program->ProgramOutput();
+
         FINALIZER_INFO* jitInfo = nullptr;
         pMainKernel->GetJitInfo(jitInfo);
         if (jitInfo->isSpill)
@@ -5205,6 +5286,10 @@ namespace IGC
                 COMPILER_SHADER_STATS_SET(m_program->m_shaderStats, STATS_ISA_EARLYEXIT32, 1);
             }
 #endif
+            if (SIMDPredictor::isLogging())
+            {
+                SIMDPredictor::logCompileResult(m_program, true, jitInfo->spillMemUsed, jitInfo->numAsmCount, 0);
+            }
             return;
         }
 
@@ -5237,6 +5322,16 @@ namespace IGC
             m_program->m_staticCycle = staticCycle;
         }
 
+        if (SIMDPredictor::isLogging())
+        {
+            uint staticCycle = 0;
+            for (uint i = 0; i < jitInfo->BBNum; i++)
+            {
+                staticCycle += jitInfo->BBInfo[i].staticCycle;
+            }
+            SIMDPredictor::logCompileResult(m_program, false, jitInfo->spillMemUsed, jitInfo->numAsmCount, staticCycle);
+        }
+
         if (jitInfo->isSpill && (AvoidRetryOnSmallSpill() || jitInfo->avoidRetry))
         {
             context->m_retryManager.Disable();
@@ -31,6 +31,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "visa_wa.h"
 #include "inc/common/sku_wa.h"
 
+#include <future>
+
 namespace IGC
 {
     class CShader;
@@ -149,6 +151,12 @@ namespace IGC
         void DeclareInput(CVariable* var, uint offset, uint instance);
         void MarkAsOutput(CVariable* var);
         void Compile(bool hasSymbolTable = false);
+        /// Same as Compile(), but the vISA finalizer (RA, scheduling, encoding)
+        /// runs on a worker thread. The program output is not filled in until
+        /// JoinCompile() is called.
+        void CompileAsync(bool hasSymbolTable = false);
+        void JoinCompile();
+        bool IsCompilePending() const { return m_pendingCompile.status.valid(); }
         std::string GetShaderName();
         void ReportCompilerStatistics(VISAKernel* pMainKernel, SProgramOutput* pOutput);
         int GetThreadCount(SIMDMode simdMode);
@@ -498,6 +506,12 @@ namespace IGC
         // save compile time by avoiding retry if the amount of spill is (very) small
         bool AvoidRetryOnSmallSpill() const;
 
+        // Compile() is split around the call to VISABuilder::Compile() so that
+        // the finalizer can run on another thread. PrepareCompile() returns the
+        // builder to compile and false if there is nothing to compile.
+        bool PrepareCompile(bool hasSymbolTable, VISABuilder*& pBuilder, VISAKernel*& pMainKernel);
+        void FinishCompile(bool hasSymbolTable, VISAKernel* pMainKernel, int vIsaCompile);
+
         // CreateSymbolTable, CreateRelocationTable and CreateFuncAttributeTable will create symbols, relococations and FuncAttributes in
         // two formats. One in given buffer that will be later parsed as patch token based format, another as struct type that will be parsed
         // as ZE binary format
@@ -602,6 +616,18 @@ namespace IGC
         VISABuilder* vbuilder;
         VISABuilder* vAsmTextBuilder;
 
+        // vISA finalization started by CompileAsync()
+        struct PendingCompile
+        {
+            std::future<int> status;
+            VISAKernel* pMainKernel = nullptr;
+            bool hasSymbolTable = false;
+#if GET_TIME_STATS
+            TimeStats::VISATimerValues visaTimers;
+#endif
+        };
+        PendingCompile m_pendingCompile;
+
         // This is for CodePatch to split payload interpolation from a shader
         VISAKernel* vPayloadSection;
         VISAKernel* vKernelTmp;
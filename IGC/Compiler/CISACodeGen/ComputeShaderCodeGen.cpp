@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/messageEncoding.hpp"
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
 #include "common/allocator.h"
 #include "common/secure_mem.h"
 #include <iStdLib/utility.h>
@@ -460,6 +461,19 @@ namespace IGC
             return false;
         }
 
+        // skip simd32 if the predictor expects simd16 to win, unless forced
+        if (simdMode == SIMDMode::SIMD32 && hasSimd16 && &F == entry &&
+            (SIMDPredictor::isEnabled() || SIMDPredictor::isLogging()) &&
+            IGC_IS_FLAG_DISABLED(ForceCSSIMD32) &&
+            IGC_IS_FLAG_DISABLED(EnableCSSIMD32) &&
+            ctx->getModuleMetaData()->csInfo.forcedSIMDSize == 0 &&
+            ctx->getModuleMetaData()->csInfo.waveSize == 0 &&
+            !SIMDPredictor::predict(simdMode, this, EP, F))
+        {
+            ctx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
+            return false;
+        }
+
         if (hasSimd16)  // got simd16 kernel, see whether compile simd32/simd8
         {
             if (simdMode == SIMDMode::SIMD32)
@@ -45,6 +45,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Dump.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/Stats.hpp"
+#include "common/CompileTrace.h"
 #include "Compiler/CISACodeGen/helper.h"
 #include "Compiler/DebugInfo/ScalarVISAModule.h"
 #include "common/secure_mem.h"
@@ -118,6 +119,7 @@ EmitPass::EmitPass(CShaderProgram::KernelShaderMap& shaders, SIMDMode mode, bool
     initializeCoalescingEnginePass(*PassRegistry::getPassRegistry());
     initializeMetaDataUtilsWrapperPass(*PassRegistry::getPassRegistry());
     initializeSimd32ProfitabilityAnalysisPass(*PassRegistry::getPassRegistry());
+    initializeRegisterEstimatorPass(*PassRegistry::getPassRegistry());
     initializeVariableReuseAnalysisPass(*PassRegistry::getPassRegistry());
     initializeLiveVariablesPass(*PassRegistry::getPassRegistry());
 }
@@ -328,6 +330,110 @@ uint EmitPass::DecideInstanceAndSlice(llvm::BasicBlock& blk, SDAG& sdag, bool& s
     return numInstance;
 }
 
+// Mid-thread preemption depends on the instruction count, so this is done
+// once the kernel has been finalized.
+static void updateMidThreadPreemption(CShader* shader, bool hasStackCall)
+{
+    if ((shader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
+        shader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        shader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
+        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
+        (shader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
+        (shader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+    {
+        if (shader->GetShaderType() == ShaderType::COMPUTE_SHADER)
+        {
+            CComputeShader* csProgram = static_cast<CComputeShader*>(shader);
+            csProgram->SetDisableMidthreadPreemption();
+        }
+        else
+        {
+            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(shader);
+            kernel->SetDisableMidthreadPreemption();
+        }
+    }
+
+    // Temp WA to disable MTP when stack calls are present
+    // TODO: Remove when VISA is fixed to copy R0 to dedicated register, so R0 contents won't be corrupted by MTP
+    if (shader->GetShaderType() == ShaderType::OPENCL_SHADER && hasStackCall)
+    {
+        COpenCLKernel* kernel = static_cast<COpenCLKernel*>(shader);
+        kernel->SetDisableMidthreadPreemption();
+    }
+}
+
+// Wait for the vISA finalization of shader started by EmitPass::finalizeAsync()
+// and do what EmitPass::runOnFunction() left for after it.
+static void finishPendingCompile(CShader* shader)
+{
+    CEncoder& encoder = shader->GetEncoder();
+    encoder.JoinCompile();
+    encoder.DestroyVISABuilder();
+    updateMidThreadPreemption(shader, false);
+}
+
+bool EmitPass::canFinalizeAsync(bool hasStackCall) const
+{
+    // Stack calls, debug info and code patching use the kernel's output or
+    // builder right after it is compiled.
+    return IGC_GET_FLAG_VALUE(ConcurrentSIMDFinalize) != 0 &&
+        (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
+         m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
+        !hasStackCall &&
+        !m_currShader->GetDebugInfoData() &&
+        !m_encoder->IsCodePatchCandidate();
+}
+
+void EmitPass::finalizeAsync(bool hasSymbolTable)
+{
+    // Bound the number of kernels in flight, the oldest one is joined first.
+    std::deque<CShader*>& pending = m_pCtx->m_pendingCompiles;
+    while (!pending.empty() &&
+        pending.size() >= IGC_GET_FLAG_VALUE(ConcurrentSIMDFinalize))
+    {
+        finishPendingCompile(pending.front());
+        pending.pop_front();
+    }
+
+    m_encoder->CompileAsync(hasSymbolTable);
+    if (m_encoder->IsCompilePending())
+    {
+        pending.push_back(m_currShader);
+    }
+    m_pCtx->m_prevShader = nullptr;
+}
+
+void EmitPass::joinPendingCompiles(CShaderProgram* program)
+{
+    // Joined in the order they were started, so that the retry manager sees
+    // the results in the same order as with serial compilation.
+    std::deque<CShader*>& pending = m_pCtx->m_pendingCompiles;
+    for (auto I = pending.begin(); I != pending.end();)
+    {
+        CShader* shader = *I;
+        if (program && shader->GetShaderProgram() != program)
+        {
+            ++I;
+            continue;
+        }
+        finishPendingCompile(shader);
+        I = pending.erase(I);
+    }
+}
+
+bool EmitPass::doFinalization(llvm::Module& M)
+{
+    // Runs once the whole pass manager is done, i.e. after DebugInfoPass.
+    // That is fine, because kernels with debug info are never finalized
+    // asynchronously. What runs after the pass manager (FillProgram, SIMD
+    // selection, retry) reads the output of every kernel.
+    if (m_pCtx)
+    {
+        joinPendingCompiles();
+    }
+    return false;
+}
+
 bool EmitPass::setCurrentShader(llvm::Function* F)
 {
     llvm::Function* Kernel = F;
@@ -490,6 +596,8 @@ bool EmitPass::runOnFunction(llvm::Function& F)
     }
     m_moduleMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
 
+    CompileTrace::Scope traceEmit("EmitPass", "IGC codegen", "simd", numLanes(m_SimdMode));
+
     CreateKernelShaderMap(m_pCtx, pMdUtils, F);
 
     m_FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
@@ -505,6 +613,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
             return false;
         }
 
+        joinPendingCompiles(Iter->second);
         CShader * simd16Program = Iter->second->GetShader(SIMDMode::SIMD16);
         if (simd16Program &&
             simd16Program->ProgramOutput()->m_programBin != 0 &&
@@ -569,6 +678,10 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         m_currShader->InitEncoder(m_SimdMode, m_canAbortOnSpill, m_ShaderDispatchMode);
         // Pre-analysis pass to be executed before call to visa builder so we can pass scratch space offset
         m_currShader->PreAnalysisPass();
+        if (m_currShader->CompileSIMDSizeReadsOtherSIMD())
+        {
+            joinPendingCompiles(m_currShader->GetShaderProgram());
+        }
         if (!m_currShader->CompileSIMDSize(m_SimdMode, *this, F))
         {
             return false;
@@ -645,6 +758,10 @@ bool EmitPass::runOnFunction(llvm::Function& F)
     }
     else
     {
+        if (m_currShader->CompileSIMDSizeReadsOtherSIMD())
+        {
+            joinPendingCompiles(m_currShader->GetShaderProgram());
+        }
         if (!m_currShader->CompileSIMDSize(m_SimdMode, *this, F))
         {
             return false;
@@ -953,8 +1070,15 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         {
             compileWithSymbolTable = true;
         }
-        m_encoder->Compile(compileWithSymbolTable);
-        m_pCtx->m_prevShader = m_currShader;
+        if (canFinalizeAsync(hasStackCall))
+        {
+            finalizeAsync(compileWithSymbolTable);
+        }
+        else
+        {
+            m_encoder->Compile(compileWithSymbolTable);
+            m_pCtx->m_prevShader = m_currShader;
+        }
         // if we are doing stack-call, do the following:
         // - Hard-code a large scratch-space for visa
         if (hasStackCall)
@@ -975,7 +1099,10 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         {
             IF_DEBUG_INFO(IDebugEmitter::Release(m_pDebugEmitter);)
 
-            if(!m_encoder->IsCodePatchCandidate() || m_encoder->HasPrevKernel())
+            // The builder of a kernel that is still being finalized is
+            // destroyed once the finalization is joined.
+            if ((!m_encoder->IsCodePatchCandidate() || m_encoder->HasPrevKernel()) &&
+                !m_encoder->IsCompilePending())
             {
                 m_pCtx->m_prevShader = nullptr;
                 // Postpone destroying VISA builder to
@@ -989,36 +1116,22 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         }
     }
 
-    if ((m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER ||
-        m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER) &&
-        m_currShader->m_Platform->supportDisableMidThreadPreemptionSwitch() &&
-        IGC_IS_FLAG_ENABLED(EnableDisableMidThreadPreemptionOpt) &&
-        (m_currShader->GetContext()->m_instrTypes.numLoopInsts == 0) &&
-        (m_currShader->ProgramOutput()->m_InstructionCount < IGC_GET_FLAG_VALUE(MidThreadPreemptionDisableThreshold)))
+    // Done when the finalization is joined if it is still running.
+    if (!m_encoder->IsCompilePending())
     {
-        if (m_currShader->GetShaderType() == ShaderType::COMPUTE_SHADER)
-        {
-            CComputeShader* csProgram = static_cast<CComputeShader*>(m_currShader);
-            csProgram->SetDisableMidthreadPreemption();
-        }
-        else
-        {
-            COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
-            kernel->SetDisableMidthreadPreemption();
-        }
+        updateMidThreadPreemption(m_currShader, hasStackCall);
     }
 
-    // Temp WA to disable MTP when stack calls are present
-    // TODO: Remove when VISA is fixed to copy R0 to dedicated register, so R0 contents won't be corrupted by MTP
-    if (m_currShader->GetShaderType() == ShaderType::OPENCL_SHADER && hasStackCall)
+    if (IGC_IS_FLAG_ENABLED(ForceBestSIMD))
     {
-        COpenCLKernel* kernel = static_cast<COpenCLKernel*>(m_currShader);
-        kernel->SetDisableMidthreadPreemption();
+        return false;
     }
 
-    if (IGC_IS_FLAG_ENABLED(ForceBestSIMD))
+    if (m_currShader->CompileSIMDSizeReadsOtherSIMD() &&
+        (IsStage1BestPerf(m_pCtx->m_CgFlag, m_pCtx->m_StagingCtx) ||
+         IsStage1FastCompile(m_pCtx->m_CgFlag, m_pCtx->m_StagingCtx)))
     {
-        return false;
+        joinPendingCompiles(m_currShader->GetShaderProgram());
     }
 
     if (m_SimdMode == SIMDMode::SIMD16 &&
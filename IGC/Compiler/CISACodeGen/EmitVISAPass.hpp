@@ -29,6 +29,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "ShaderCodeGen.hpp"
 #include "CoalescingEngine.hpp"
 #include "Simd32Profitability.hpp"
+#include "SIMDPredictor.hpp"
+#include "RegisterEstimator.hpp"
 #include "GenCodeGenModule.h"
 #include "VariableReuseAnalysis.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
@@ -77,10 +79,15 @@ public:
         AU.addRequired<Simd32ProfitabilityAnalysis>();
         AU.addRequired<CodeGenContextWrapper>();
         AU.addRequired<VariableReuseAnalysis>();
+        if (SIMDPredictor::isEnabled() || SIMDPredictor::isLogging())
+        {
+            AU.addRequired<RegisterEstimator>();
+        }
         AU.setPreservesAll();
     }
 
     virtual bool runOnFunction(llvm::Function& F) override;
+    virtual bool doFinalization(llvm::Module& M) override;
     virtual llvm::StringRef getPassName() const  override { return "EmitPass"; }
 
     void CreateKernelShaderMap(CodeGenContext* ctx, IGC::IGCMD::MetaDataUtils* pMdUtils, llvm::Function& F);
@@ -545,6 +552,14 @@ public:
     /// check if the dummy kernel requires compilation
     bool compileSymbolTableKernel(llvm::Function* F);
 
+    /// With ConcurrentSIMDFinalize, the vISA finalization of a kernel may run
+    /// on a worker thread while the next SIMD variant is emitted.
+    bool canFinalizeAsync(bool hasStackCall) const;
+    void finalizeAsync(bool hasSymbolTable);
+    /// Wait for the pending finalization of the SIMD variants of program, or
+    /// of all kernels if program is nullptr.
+    void joinPendingCompiles(CShaderProgram* program = nullptr);
+
     // Arithmetic operations with constant folding
     // Src0 and Src1 are the input operands
     // DstPrototype is a prototype of the result of operation and may be used for cloning to a new variable
@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/Optimizer/OpenCLPasses/LocalBuffers/InlineLocalsResolution.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelArgs.hpp"
 #include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
 #include "Compiler/Optimizer/OCLBIUtils.h"
 #include "AdaptorOCL/OCL/KernelAnnotations.hpp"
 #include "common/allocator.h"
@@ -2092,6 +2093,10 @@ namespace IGC
             }
             shader->m_kernelInfo.m_executionEnivronment.CompiledSIMDSize = simdMode;
             shader->m_kernelInfo.m_executionEnivronment.SIMDInfo = ctx->GetSIMDInfo();
+            if (SIMDPredictor::isLogging())
+            {
+                SIMDPredictor::logSelection(shader);
+            }
             return true;
         }
         return false;
@@ -2263,6 +2268,15 @@ namespace IGC
     }
 
 
+    bool COpenCLKernel::CompileSIMDSizeReadsOtherSIMD() const
+    {
+        // Only the check whether another SIMD size has been compiled already
+        // looks at the other variants, and it is skipped when the driver takes
+        // all of them.
+        return !(m_Context->m_DriverInfo.sendMultipleSIMDModes() &&
+            m_Context->getModuleMetaData()->csInfo.forcedSIMDSize == 0);
+    }
+
     SIMDStatus COpenCLKernel::checkSIMDCompileConds(SIMDMode simdMode, EmitPass& EP, llvm::Function& F)
     {
         CShader* simd8Program = m_parent->GetShader(SIMDMode::SIMD8);
@@ -2433,6 +2447,14 @@ namespace IGC
                     return SIMDStatus::SIMD_PERF_FAIL;
                 }
             }
+
+            // bail out if the predictor expects a narrower SIMD size to win.
+            if ((SIMDPredictor::isEnabled() || SIMDPredictor::isLogging()) && &F == entry &&
+                !SIMDPredictor::predict(simdMode, this, EP, F))
+            {
+                pCtx->SetSIMDInfo(SIMD_SKIP_PERF, simdMode, ShaderDispatchMode::NOT_APPLICABLE);
+                return SIMDStatus::SIMD_PERF_FAIL;
+            }
         }
 
         return SIMDStatus::SIMD_PASS;
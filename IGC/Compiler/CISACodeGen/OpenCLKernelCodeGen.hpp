@@ -48,6 +48,7 @@ namespace IGC
 
         bool        hasReadWriteImage(llvm::Function& F) override;
         bool        CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Function& F) override;
+        bool        CompileSIMDSizeReadsOtherSIMD() const override;
         SIMDStatus  checkSIMDCompileConds(SIMDMode simdMode, EmitPass& EP, llvm::Function& F);
 
         void        FillKernel();
@@ -225,6 +225,13 @@ namespace IGC
             return getNumRegs(grfuse, simdsize);
         }
 
+        // Return the max number of GRF needed anywhere in the function.
+        // Only valid after calculate().
+        uint32_t getMaxLiveGRF(uint16_t simdsize = 16) const {
+            const RegUse& grfuse = m_MaxRegs.allUses[REGISTER_CLASS_GRF];
+            return getNumRegs(grfuse, simdsize);
+        }
+
         uint32_t getNumValues() const {
             return (uint32_t)m_ValueRegUses.capacity();
         }
@@ -0,0 +1,332 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
+#include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/EmitVISAPass.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
+#include "Compiler/CISACodeGen/Simd32Profitability.hpp"
+#include "Compiler/CodeGenPublic.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+using namespace IGC;
+
+static const char* const FeatureNames[NUM_SIMD_FEATURES] =
+{
+    "temp_count",
+    "grf_pressure",
+    "inst_count",
+    "loop_count",
+    "loop_depth",
+    "divergent_branches",
+    "slm_usage",
+    "occupancy_gain",
+    "has_barrier",
+    "sroa_exceeded",
+    "licm_exceeded",
+    "narrower_spilled",
+    "narrower_send_stall",
+    "profitable_hint",
+};
+
+const char* SIMDPredictor::getFeatureName(SIMDFeature feature)
+{
+    IGC_ASSERT(feature < NUM_SIMD_FEATURES);
+    return FeatureNames[feature];
+}
+
+bool SIMDPredictor::isEnabled()
+{
+    return IGC_IS_FLAG_ENABLED(EnableSIMDPredictor);
+}
+
+bool SIMDPredictor::isLogging()
+{
+    const char* path = IGC_GET_REGKEYSTRING(SIMDPredictorLog);
+    return path && path[0] != '\0';
+}
+
+const SIMDPredictor& SIMDPredictor::get()
+{
+    static const LinearSIMDPredictor predictor = []() {
+        LinearSIMDPredictor P;
+        const char* path = IGC_GET_REGKEYSTRING(SIMDPredictorModelFile);
+        if (path && path[0] != '\0')
+        {
+            P.load(path);
+        }
+        return P;
+    }();
+    return predictor;
+}
+
+void SIMDPredictor::collectFeatures(
+    SIMDFeatures& features,
+    SIMDMode simdMode,
+    CShader* pShader,
+    EmitPass& EP,
+    Function& F)
+{
+    CodeGenContext* ctx = pShader->GetContext();
+    const SIMDMode narrower = simdMode == SIMDMode::SIMD32 ? SIMDMode::SIMD16 : SIMDMode::SIMD8;
+
+    features[SIMD_FEATURE_TEMP_COUNT] = ctx->m_tempCount / 128.0f;
+
+    if (RegisterEstimator* RPE = EP.getAnalysisIfAvailable<RegisterEstimator>())
+    {
+        RPE->calculate();
+        features[SIMD_FEATURE_GRF_PRESSURE] =
+            float(RPE->getMaxLiveGRF(numLanes(simdMode))) / ctx->getNumGRFPerThread();
+    }
+
+    unsigned numInsts = 0;
+    for (auto& BB : F)
+    {
+        numInsts += BB.size();
+    }
+    features[SIMD_FEATURE_INST_COUNT] = std::log2(1.0f + numInsts) / 16.0f;
+
+    Simd32ProfitabilityAnalysis& PA = EP.getAnalysis<Simd32ProfitabilityAnalysis>();
+    features[SIMD_FEATURE_LOOP_COUNT] = std::min(PA.getNumLoops() / 16.0f, 1.0f);
+    features[SIMD_FEATURE_LOOP_DEPTH] = std::min(PA.getMaxLoopDepth() / 4.0f, 1.0f);
+    features[SIMD_FEATURE_DIVERGENT_BRANCHES] = PA.getDivergentBranchRatio();
+
+    if (ctx->type == ShaderType::COMPUTE_SHADER)
+    {
+        ComputeShaderContext* csCtx = static_cast<ComputeShaderContext*>(ctx);
+        if (unsigned slmPerSubslice = csCtx->GetSlmSizePerSubslice())
+        {
+            features[SIMD_FEATURE_SLM_USAGE] = float(csCtx->GetSlmSize()) / slmPerSubslice;
+        }
+        features[SIMD_FEATURE_OCCUPANCY_GAIN] =
+            csCtx->GetThreadOccupancy(simdMode) - csCtx->GetThreadOccupancy(narrower);
+    }
+    else if (ctx->type == ShaderType::OPENCL_SHADER)
+    {
+        features[SIMD_FEATURE_PROFITABLE_HINT] = simdMode == SIMDMode::SIMD32 ?
+            PA.isSimd32Profitable() : PA.isSimd16Profitable();
+    }
+
+    features[SIMD_FEATURE_HAS_BARRIER] = ctx->m_instrTypes.hasBarrier;
+    features[SIMD_FEATURE_SROA_EXCEEDED] = ctx->instrStat[SROA_PROMOTED][EXCEED_THRESHOLD] != 0;
+    features[SIMD_FEATURE_LICM_EXCEEDED] = ctx->instrStat[LICM_STAT][EXCEED_THRESHOLD] != 0;
+
+    // The narrower variant may still be finalizing on a worker thread; its
+    // results are only read once it is done.
+    CShader* prev = pShader->GetShaderProgram()->GetShader(narrower);
+    if (prev && prev != pShader && !prev->GetEncoder().IsCompilePending() &&
+        prev->ProgramOutput()->m_programSize > 0)
+    {
+        features[SIMD_FEATURE_NARROWER_SPILLED] = prev->m_spillSize > 0;
+        if (narrower == SIMDMode::SIMD16 && prev->m_staticCycle > 0)
+        {
+            features[SIMD_FEATURE_NARROWER_SEND_STALL] =
+                float(prev->m_sendStallCycle) / prev->m_staticCycle;
+        }
+    }
+}
+
+namespace
+{
+    /// Serializes appends to SIMDPredictorLog across compiles in the process.
+    std::mutex LogLock;
+
+    // Every record starts with kind,hash,function,simd; "predict" records are
+    // followed by the decision and the features, "result" records by
+    // aborted,spill_size,inst_count,static_cycles, "selected" records by
+    // nothing.
+    void writeLogRecord(CShader* pShader, const char* kind, SIMDMode simdMode,
+        const SmallVectorImpl<float>& values)
+    {
+        const char* path = IGC_GET_REGKEYSTRING(SIMDPredictorLog);
+        std::lock_guard<std::mutex> guard(LogLock);
+
+        bool writeHeader = !sys::fs::exists(path);
+        std::ofstream OS(path, std::ios::app);
+        if (!OS.is_open())
+        {
+            return;
+        }
+        if (writeHeader)
+        {
+            OS << "kind,hash,function,simd,decision";
+            for (unsigned i = 0; i < NUM_SIMD_FEATURES; ++i)
+            {
+                OS << ',' << FeatureNames[i];
+            }
+            OS << '\n';
+        }
+
+        CodeGenContext* ctx = pShader->GetContext();
+        OS << kind << ',';
+        OS << "0x" << std::hex << ctx->hash.getAsmHash() << std::dec << ',';
+        OS << (pShader->entry ? pShader->entry->getName().str() : std::string()) << ',';
+        OS << numLanes(simdMode);
+        for (float value : values)
+        {
+            OS << ',' << value;
+        }
+        OS << '\n';
+    }
+}
+
+bool SIMDPredictor::predict(SIMDMode simdMode, CShader* pShader, EmitPass& EP, Function& F)
+{
+    SIMDFeatures features;
+    collectFeatures(features, simdMode, pShader, EP, F);
+    bool compile = get().shouldCompile(simdMode, features);
+
+    if (isLogging())
+    {
+        SmallVector<float, NUM_SIMD_FEATURES + 1> values;
+        values.push_back(compile);
+        values.append(std::begin(features.values), std::end(features.values));
+        writeLogRecord(pShader, "predict", simdMode, values);
+    }
+
+    // In logging-only mode every size is still compiled, so that the log
+    // records the actual winner.
+    return compile || !isEnabled();
+}
+
+void SIMDPredictor::logCompileResult(
+    CShader* pShader,
+    bool aborted,
+    unsigned spillSize,
+    unsigned instCount,
+    unsigned staticCycle)
+{
+    SmallVector<float, 4> values;
+    values.push_back(aborted);
+    values.push_back(float(spillSize));
+    values.push_back(float(instCount));
+    values.push_back(float(staticCycle));
+    writeLogRecord(pShader, "result", pShader->m_dispatchSize, values);
+}
+
+void SIMDPredictor::logSelection(CShader* pShader)
+{
+    writeLogRecord(pShader, "selected", pShader->m_dispatchSize, SmallVector<float, 1>());
+}
+
+LinearSIMDPredictor::LinearSIMDPredictor()
+{
+    Model& simd16 = m_models[MODEL_SIMD16];
+    simd16.weights[SIMD_FEATURE_GRF_PRESSURE] = -0.8f;
+
+    Model& simd32 = m_models[MODEL_SIMD32];
+    simd32.weights[SIMD_FEATURE_GRF_PRESSURE] = -0.9f;
+    simd32.weights[SIMD_FEATURE_NARROWER_SPILLED] = -2.0f;
+    simd32.weights[SIMD_FEATURE_DIVERGENT_BRANCHES] = -0.5f;
+    simd32.weights[SIMD_FEATURE_OCCUPANCY_GAIN] = 2.0f;
+}
+
+bool LinearSIMDPredictor::shouldCompile(SIMDMode simdMode, const SIMDFeatures& features) const
+{
+    if (simdMode != SIMDMode::SIMD16 && simdMode != SIMDMode::SIMD32)
+    {
+        return true;
+    }
+
+    const Model& model = m_models[simdMode == SIMDMode::SIMD32 ? MODEL_SIMD32 : MODEL_SIMD16];
+    float score = model.bias;
+    for (unsigned i = 0; i < NUM_SIMD_FEATURES; ++i)
+    {
+        score += model.weights[i] * features.values[i];
+    }
+    return score >= 0.0f;
+}
+
+bool LinearSIMDPredictor::load(StringRef path)
+{
+    ErrorOr<std::unique_ptr<MemoryBuffer>> bufOrErr = MemoryBuffer::getFile(path);
+    if (!bufOrErr)
+    {
+        return false;
+    }
+
+    Model models[NUM_MODELS];
+    std::copy(std::begin(m_models), std::end(m_models), std::begin(models));
+
+    SmallVector<StringRef, 16> lines;
+    (*bufOrErr)->getBuffer().split(lines, '\n');
+    for (StringRef line : lines)
+    {
+        line = line.split('#').first.trim();
+        if (line.empty())
+        {
+            continue;
+        }
+
+        SmallVector<StringRef, 3> fields;
+        line.split(fields, ' ', -1, false);
+        if (fields.size() != 3)
+        {
+            return false;
+        }
+
+        Model* model = nullptr;
+        if (fields[0] == "simd16")
+            model = &models[MODEL_SIMD16];
+        else if (fields[0] == "simd32")
+            model = &models[MODEL_SIMD32];
+        else
+            return false;
+
+        double value = 0.0;
+        if (fields[2].getAsDouble(value))
+        {
+            return false;
+        }
+
+        if (fields[1] == "bias")
+        {
+            model->bias = float(value);
+            continue;
+        }
+        const char* const* name = std::find(std::begin(FeatureNames), std::end(FeatureNames), fields[1]);
+        if (name == std::end(FeatureNames))
+        {
+            return false;
+        }
+        model->weights[name - std::begin(FeatureNames)] = float(value);
+    }
+
+    std::copy(std::begin(models), std::end(models), std::begin(m_models));
+    return true;
+}
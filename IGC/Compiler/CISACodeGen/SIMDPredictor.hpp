@@ -0,0 +1,148 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include "common/Types.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/StringRef.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace llvm
+{
+    class Function;
+}
+
+namespace IGC
+{
+    class CShader;
+    class EmitPass;
+
+    /// Inputs of the SIMD predictor. All of them are already computed by the
+    /// time EmitPass decides whether to compile a SIMD size; each is scaled to
+    /// roughly [0, 1] so that model coefficients are comparable.
+    enum SIMDFeature
+    {
+        SIMD_FEATURE_TEMP_COUNT,            // m_tempCount / 128 (CS)
+        SIMD_FEATURE_GRF_PRESSURE,          // RegisterEstimator max live GRFs at this width / GRFs per thread
+        SIMD_FEATURE_INST_COUNT,            // log2(1 + LLVM instructions) / 16
+        SIMD_FEATURE_LOOP_COUNT,            // loops / 16, capped at 1
+        SIMD_FEATURE_LOOP_DEPTH,            // max loop depth / 4, capped at 1
+        SIMD_FEATURE_DIVERGENT_BRANCHES,    // non-uniform share of conditional branches
+        SIMD_FEATURE_SLM_USAGE,             // SLM size / SLM per subslice (CS)
+        SIMD_FEATURE_OCCUPANCY_GAIN,        // occupancy at this width minus at the next narrower one (CS)
+        SIMD_FEATURE_HAS_BARRIER,
+        SIMD_FEATURE_SROA_EXCEEDED,         // instrStat[SROA_PROMOTED][EXCEED_THRESHOLD]
+        SIMD_FEATURE_LICM_EXCEEDED,         // instrStat[LICM_STAT][EXCEED_THRESHOLD]
+        SIMD_FEATURE_NARROWER_SPILLED,      // the next narrower width was compiled and spilled
+        SIMD_FEATURE_NARROWER_SEND_STALL,   // send stall share of the compiled SIMD16 variant
+        SIMD_FEATURE_PROFITABLE_HINT,       // Simd32ProfitabilityAnalysis verdict (OCL)
+        NUM_SIMD_FEATURES
+    };
+
+    struct SIMDFeatures
+    {
+        float values[NUM_SIMD_FEATURES] = {};
+
+        float& operator[](SIMDFeature feature) { return values[feature]; }
+        float operator[](SIMDFeature feature) const { return values[feature]; }
+    };
+
+    /// Predicts whether compiling a SIMD size is worth it, so that variants
+    /// which would lose the final selection are not compiled at all.
+    ///
+    /// Only consulted for sizes above the least one the shader allows, and
+    /// never when a size is forced, so a narrower fallback always exists.
+    class SIMDPredictor
+    {
+    public:
+        virtual ~SIMDPredictor() {}
+
+        /// True if simdMode is expected to beat the next narrower size.
+        virtual bool shouldCompile(SIMDMode simdMode, const SIMDFeatures& features) const = 0;
+
+        /// The predictor selected by EnableSIMDPredictor / SIMDPredictorModelFile.
+        static const SIMDPredictor& get();
+
+        /// True if predictions are used to skip compiles.
+        static bool isEnabled();
+        /// True if features and results are logged to SIMDPredictorLog.
+        static bool isLogging();
+
+        static const char* getFeatureName(SIMDFeature feature);
+
+        /// Gather the features of F for compiling it at simdMode.
+        static void collectFeatures(
+            SIMDFeatures& features,
+            SIMDMode simdMode,
+            CShader* pShader,
+            EmitPass& EP,
+            llvm::Function& F);
+
+        /// Ask the predictor about simdMode for F and log the decision.
+        /// Returns true if it should be compiled.
+        static bool predict(SIMDMode simdMode, CShader* pShader, EmitPass& EP, llvm::Function& F);
+
+        /// Log records used to retrain the model offline.
+        static void logCompileResult(
+            CShader* pShader,
+            bool aborted,
+            unsigned spillSize,
+            unsigned instCount,
+            unsigned staticCycle);
+        static void logSelection(CShader* pShader);
+    };
+
+    /// Linear model per SIMD size: compile if
+    ///     bias + sum(weight[i] * feature[i]) >= 0.
+    ///
+    /// The built-in coefficients only veto widths that are all but certain
+    /// to spill or lose occupancy. A model file replaces them; each line is
+    ///     <simd16|simd32> <bias|feature name> <value>
+    /// and '#' starts a comment.
+    class LinearSIMDPredictor : public SIMDPredictor
+    {
+    public:
+        LinearSIMDPredictor();
+
+        bool shouldCompile(SIMDMode simdMode, const SIMDFeatures& features) const override;
+
+        /// Returns false and keeps the current coefficients if the file is
+        /// missing or malformed.
+        bool load(llvm::StringRef path);
+
+    private:
+        struct Model
+        {
+            float bias = 1.0f;
+            float weights[NUM_SIMD_FEATURES] = {};
+        };
+
+        enum { MODEL_SIMD16, MODEL_SIMD32, NUM_MODELS };
+
+        Model m_models[NUM_MODELS];
+    };
+} // namespace IGC
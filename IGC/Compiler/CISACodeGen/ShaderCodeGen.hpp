@@ -106,6 +106,10 @@ public:
     virtual bool hasReadWriteImage(llvm::Function& F) { return false; }
     bool CompileSIMDSizeInCommon();
     virtual bool CompileSIMDSize(SIMDMode simdMode, EmitPass& EP, llvm::Function& F) { return true; }
+    /// Whether CompileSIMDSize() looks at the output of the other SIMD variants,
+    /// which then have to be finalized first
+    virtual bool CompileSIMDSizeReadsOtherSIMD() const { return true; }
+    CShaderProgram* GetShaderProgram() const { return m_parent; }
     CVariable* LazyCreateCCTupleBackingVariable(
         CoalescingEngine::CCTuple* ccTuple,
         VISA_Type baseType = ISA_TYPE_UD);
@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/CISACodeGen/Platform.hpp"
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvmWrapper/IR/DerivedTypes.h>
 #include <llvm/IR/InstIterator.h>
@@ -60,7 +61,8 @@ const unsigned BRANCHY_MINPATH = 8;
 Simd32ProfitabilityAnalysis::Simd32ProfitabilityAnalysis()
     : FunctionPass(ID), F(nullptr), PDT(nullptr), LI(nullptr),
     pMdUtils(nullptr), WI(nullptr), m_isSimd32Profitable(true),
-    m_isSimd16Profitable(true) {
+    m_isSimd16Profitable(true), m_numLoops(0), m_maxLoopDepth(0),
+    m_divergentBranchRatio(0.0f) {
     initializeSimd32ProfitabilityAnalysisPass(*PassRegistry::getPassRegistry());
 }
 
@@ -572,9 +574,43 @@ bool Simd32ProfitabilityAnalysis::runOnFunction(Function& F)
         LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
         m_isSimd32Profitable = checkPSSimd32Profitable();
     }
+    if (SIMDPredictor::isEnabled() || SIMDPredictor::isLogging())
+    {
+        LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+        WI = &getAnalysis<WIAnalysis>();
+        collectControlFlowStats();
+    }
     return false;
 }
 
+void Simd32ProfitabilityAnalysis::collectControlFlowStats()
+{
+    m_numLoops = 0;
+    m_maxLoopDepth = 0;
+    SmallVector<Loop*, 8> Worklist(LI->begin(), LI->end());
+    while (!Worklist.empty())
+    {
+        Loop* L = Worklist.pop_back_val();
+        ++m_numLoops;
+        m_maxLoopDepth = std::max(m_maxLoopDepth, L->getLoopDepth());
+        Worklist.append(L->begin(), L->end());
+    }
+
+    unsigned numCondBranches = 0;
+    unsigned numDivergentBranches = 0;
+    for (auto& BB : *F)
+    {
+        BranchInst* Br = dyn_cast<BranchInst>(BB.getTerminator());
+        if (!Br || !Br->isConditional())
+            continue;
+        ++numCondBranches;
+        if (!WI->isUniform(Br->getCondition()))
+            ++numDivergentBranches;
+    }
+    m_divergentBranchRatio = numCondBranches ?
+        float(numDivergentBranches) / numCondBranches : 0.0f;
+}
+
 static bool isPayloadHeader(Value* V) {
     Argument* Arg = dyn_cast<Argument>(V);
     if (!Arg || !Arg->hasName())
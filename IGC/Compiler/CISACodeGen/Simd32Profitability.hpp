@@ -69,6 +69,12 @@ namespace IGC
         bool isSimd32Profitable() const { return m_isSimd32Profitable; }
         bool isSimd16Profitable() const { return m_isSimd16Profitable; }
 
+        // Control-flow statistics consumed by the SIMD predictor; only
+        // computed when it is enabled or logging.
+        unsigned getNumLoops() const { return m_numLoops; }
+        unsigned getMaxLoopDepth() const { return m_maxLoopDepth; }
+        float getDivergentBranchRatio() const { return m_divergentBranchRatio; }
+
     private:
         llvm::Function* F;
         llvm::PostDominatorTree* PDT;
@@ -77,6 +83,9 @@ namespace IGC
         WIAnalysis* WI;
         bool m_isSimd32Profitable;
         bool m_isSimd16Profitable;
+        unsigned m_numLoops;
+        unsigned m_maxLoopDepth;
+        float m_divergentBranchRatio;
 
         unsigned getLoopCyclomaticComplexity();
         bool checkSimd32Profitable(CodeGenContext*);
@@ -89,6 +98,8 @@ namespace IGC
         bool isSelectBasedOnGlobalIdX(llvm::Value*);
 
         bool checkPSSimd32Profitable();
+
+        void collectControlFlowStats();
     };
 
 } // namespace IGC
@@ -29,7 +29,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/IR/Function.h>
 #include "common/LLVMWarningsPop.hpp"
+#include "common/CompileTrace.h"
 
 using namespace llvm;
 using namespace IGC;
@@ -39,7 +41,7 @@ namespace {
         CodeGenContext* ctx;
         COMPILE_TIME_INTERVALS interval;
         TimeStatsCounterStartEndMode mode;
-        std::string igcPass;
+        unsigned passID;
         TimeStatsCounterType type;
 
     public:
@@ -57,31 +59,66 @@ namespace {
             type = STATS_COUNTER_ENUM_TYPE;
         }
 
-        TimeStatsCounter(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode) : ModulePass(ID) {
+        TimeStatsCounter(CodeGenContext* _ctx, unsigned _passID, TimeStatsCounterStartEndMode _mode) : ModulePass(ID) {
             initializeTimeStatsCounterPass(*PassRegistry::getPassRegistry());
             ctx = _ctx;
             mode = _mode;
-            igcPass = _igcPass;
+            passID = _passID;
             type = STATS_COUNTER_LLVM_PASS;
         }
 
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesAll();
+        }
+
         bool runOnModule(Module&) override;
 
     private:
 
     };
+
+    class TimeStatsFunctionCounter : public FunctionPass {
+        CodeGenContext* ctx = nullptr;
+        TimeStatsCounterStartEndMode mode = STATS_COUNTER_START;
+        unsigned passID = 0;
+
+    public:
+        static char ID;
+
+        TimeStatsFunctionCounter() : FunctionPass(ID) {
+            initializeTimeStatsFunctionCounterPass(*PassRegistry::getPassRegistry());
+        }
+
+        TimeStatsFunctionCounter(CodeGenContext* _ctx, unsigned _passID, TimeStatsCounterStartEndMode _mode) : FunctionPass(ID) {
+            initializeTimeStatsFunctionCounterPass(*PassRegistry::getPassRegistry());
+            ctx = _ctx;
+            mode = _mode;
+            passID = _passID;
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesAll();
+        }
+
+        bool runOnFunction(Function&) override;
+    };
 } // End anonymous namespace
 
 ModulePass* IGC::createTimeStatsCounterPass(CodeGenContext* _ctx, COMPILE_TIME_INTERVALS _interval, TimeStatsCounterStartEndMode _mode) {
     return new TimeStatsCounter(_ctx, _interval, _mode);
 }
 
-ModulePass* IGC::createTimeStatsIGCPass(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode)
+Pass* IGC::createTimeStatsIGCPass(CodeGenContext* _ctx, unsigned _passID, TimeStatsCounterStartEndMode _mode, bool isFunctionPass)
 {
-    return new TimeStatsCounter(_ctx, _igcPass, _mode);
+    if (isFunctionPass)
+    {
+        return new TimeStatsFunctionCounter(_ctx, _passID, _mode);
+    }
+    return new TimeStatsCounter(_ctx, _passID, _mode);
 }
 
 char TimeStatsCounter::ID = 0;
+char TimeStatsFunctionCounter::ID = 0;
 
 #define PASS_FLAG     "time-stats-counter"
 #define PASS_DESC     "TimeStatsCounter Start/Stop"
@@ -90,6 +127,8 @@ char TimeStatsCounter::ID = 0;
 namespace IGC {
     IGC_INITIALIZE_PASS_BEGIN(TimeStatsCounter, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
         IGC_INITIALIZE_PASS_END(TimeStatsCounter, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+    IGC_INITIALIZE_PASS_BEGIN(TimeStatsFunctionCounter, "time-stats-function-counter", "TimeStatsCounter Start/Stop per function", false, false)
+        IGC_INITIALIZE_PASS_END(TimeStatsFunctionCounter, "time-stats-function-counter", "TimeStatsCounter Start/Stop per function", false, false)
 }
 
 bool TimeStatsCounter::runOnModule(Module& F) {
@@ -108,13 +147,122 @@ bool TimeStatsCounter::runOnModule(Module& F) {
     {
         if (mode == STATS_COUNTER_START)
         {
-            COMPILER_TIME_PASS_START(ctx, igcPass);
+            COMPILER_TIME_PASS_START(ctx, passID);
         }
         else
         {
-            COMPILER_TIME_PASS_END(ctx, igcPass);
+            COMPILER_TIME_PASS_END(ctx, passID);
         }
     }
     return false;
 }
 
+bool TimeStatsFunctionCounter::runOnFunction(Function&) {
+    if (mode == STATS_COUNTER_START)
+    {
+        COMPILER_TIME_PASS_START(ctx, passID);
+    }
+    else
+    {
+        COMPILER_TIME_PASS_END(ctx, passID);
+    }
+    return false;
+}
+
+namespace {
+    class TraceFunctionMarker : public FunctionPass {
+        const char* traceName = nullptr;
+
+    public:
+        static char ID;
+
+        TraceFunctionMarker() : FunctionPass(ID) {
+            initializeTraceFunctionMarkerPass(*PassRegistry::getPassRegistry());
+        }
+
+        TraceFunctionMarker(const char* _traceName) : FunctionPass(ID), traceName(_traceName) {
+            initializeTraceFunctionMarkerPass(*PassRegistry::getPassRegistry());
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesAll();
+        }
+
+        bool runOnFunction(Function& F) override;
+    };
+
+    class TraceModuleMarker : public ModulePass {
+        CodeGenContext* ctx = nullptr;
+        const char* traceName = nullptr;
+
+    public:
+        static char ID;
+
+        TraceModuleMarker() : ModulePass(ID) {
+            initializeTraceModuleMarkerPass(*PassRegistry::getPassRegistry());
+        }
+
+        TraceModuleMarker(CodeGenContext* _ctx, const char* _traceName) : ModulePass(ID), ctx(_ctx), traceName(_traceName) {
+            initializeTraceModuleMarkerPass(*PassRegistry::getPassRegistry());
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesAll();
+        }
+
+        bool runOnModule(Module&) override;
+    };
+} // End anonymous namespace
+
+Pass* IGC::createTraceMarkerPass(CodeGenContext* ctx, const char* traceName, bool isFunctionPass)
+{
+    if (isFunctionPass)
+    {
+        return new TraceFunctionMarker(traceName);
+    }
+    return new TraceModuleMarker(ctx, traceName);
+}
+
+char TraceFunctionMarker::ID = 0;
+char TraceModuleMarker::ID = 0;
+
+namespace IGC {
+    IGC_INITIALIZE_PASS_BEGIN(TraceFunctionMarker, "trace-function-marker", "Compile trace function pass marker", false, false)
+        IGC_INITIALIZE_PASS_END(TraceFunctionMarker, "trace-function-marker", "Compile trace function pass marker", false, false)
+    IGC_INITIALIZE_PASS_BEGIN(TraceModuleMarker, "trace-module-marker", "Compile trace module pass marker", false, false)
+        IGC_INITIALIZE_PASS_END(TraceModuleMarker, "trace-module-marker", "Compile trace module pass marker", false, false)
+}
+
+bool TraceFunctionMarker::runOnFunction(Function& F) {
+    CompileTrace::Tracer& tracer = CompileTrace::Tracer::get();
+    if (!traceName)
+    {
+        tracer.beginEvent();
+        return false;
+    }
+
+    // Function passes run back to back on one function, so the interned name
+    // is almost always the one of the previous event.
+    static thread_local const Function* lastFunc = nullptr;
+    static thread_local const char* lastName = nullptr;
+    if (&F != lastFunc || F.getName() != lastName)
+    {
+        lastFunc = &F;
+        lastName = tracer.intern(F.getName().str());
+    }
+    tracer.endEvent(traceName, "pass", nullptr, 0, lastName);
+    return false;
+}
+
+bool TraceModuleMarker::runOnModule(Module&) {
+    CompileTrace::Tracer& tracer = CompileTrace::Tracer::get();
+    if (!traceName)
+    {
+        tracer.beginEvent();
+    }
+    else
+    {
+        tracer.endEvent(traceName, "pass", "hash", ctx->hash.getAsmHash());
+    }
+    return false;
+}
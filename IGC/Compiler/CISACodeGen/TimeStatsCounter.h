@@ -47,6 +47,18 @@ namespace IGC {
     };
 
     llvm::ModulePass* createTimeStatsCounterPass(CodeGenContext* _ctx, COMPILE_TIME_INTERVALS _interval, TimeStatsCounterStartEndMode _mode);
-    llvm::ModulePass* createTimeStatsIGCPass(CodeGenContext* _ctx, std::string _igcPass, TimeStatsCounterStartEndMode _mode);
+    // _passID is the PassTimerRegistry ID of the timed pass. Function passes
+    // get a function pass counter so that they stay batched per function.
+    llvm::Pass* createTimeStatsIGCPass(CodeGenContext* _ctx, unsigned _passID, TimeStatsCounterStartEndMode _mode, bool isFunctionPass);
     void initializeTimeStatsCounterPass(llvm::PassRegistry&);
+    void initializeTimeStatsFunctionCounterPass(llvm::PassRegistry&);
+
+    // Markers around a function or module pass added by IGCPassManager while
+    // compile tracing is enabled: the begin marker (no name) opens the trace
+    // event of the pass, the end marker records it under traceName. Function
+    // markers run per function, so they keep function passes batched and
+    // record one event per kernel.
+    llvm::Pass* createTraceMarkerPass(CodeGenContext* ctx, const char* traceName, bool isFunctionPass);
+    void initializeTraceFunctionMarkerPass(llvm::PassRegistry&);
+    void initializeTraceModuleMarkerPass(llvm::PassRegistry&);
 } // End namespace IGC
@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
+#include "Compiler/CISACodeGen/SIMDPredictor.hpp"
 #include "Compiler/CodeGenPublic.h"
 #include "Probe/Assertion.h"
 
@@ -419,6 +420,10 @@ namespace IGC
             }
             shader->FillProgram(pKernelProgram);
             pKernelProgram->SIMDInfo = cgCtx->GetSIMDInfo();
+            if (SIMDPredictor::isLogging())
+            {
+                SIMDPredictor::logSelection(shader);
+            }
 
 
             // free allocated memory for the remaining kernels
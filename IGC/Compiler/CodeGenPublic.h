@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/debug/Debug.hpp"
 #include "common/debug/Dump.hpp"
 #include <set>
+#include <deque>
 #include <string.h>
 #include "Compiler/CISACodeGen/ShaderUnits.hpp"
 #include "Compiler/CISACodeGen/Platform.hpp"
@@ -854,6 +855,10 @@ namespace IGC
         // Record previous simd for code patching
         CShader* m_prevShader = nullptr;
 
+        // Shaders whose vISA finalization is running on a worker thread,
+        // oldest first (see ConcurrentSIMDFinalize)
+        std::deque<CShader*> m_pendingCompiles;
+
         // For IR dump after pass
         unsigned     m_numPasses = 0;
         bool m_threadCombiningOptDone = false;
@@ -106,6 +106,7 @@ void initializePromoteStatelessToBindless(llvm::PassRegistry&);
 void initializePullConstantHeuristicsPass(llvm::PassRegistry&);
 void initializeScalarizerCodeGenPass(llvm::PassRegistry&);
 void initializeReduceLocalPointersPass(llvm::PassRegistry&);
+void initializeRemoveFinishedKernelsPass(llvm::PassRegistry&);
 void initializeReplaceUnsupportedIntrinsicsPass(llvm::PassRegistry&);
 void initializePreCompiledFuncImportPass(llvm::PassRegistry&);
 void initializePurgeMetaDataUtilsPass(llvm::PassRegistry&);
@@ -38,6 +38,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringSet.h>
 #include <llvm/Linker/Linker.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/ValueMapper.h>
@@ -64,12 +65,103 @@ IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
 IGC_INITIALIZE_PASS_END(BIImport, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
+BiFSymbolTable::BiFSymbolTable(const Module& M)
+{
+    // Named global values reachable from the operands of U, looking through
+    // constant expressions and aggregates.
+    SmallPtrSet<const Value*, 32> Visited;
+    SmallVector<const Value*, 32> Worklist;
+    auto CollectRefs = [&](const User* U, std::vector<StringRef>& Refs)
+    {
+        Worklist.append(U->op_begin(), U->op_end());
+        while (!Worklist.empty())
+        {
+            const Value* V = Worklist.pop_back_val();
+            if (!Visited.insert(V).second)
+            {
+                continue;
+            }
+            if (auto* GV = dyn_cast<GlobalValue>(V))
+            {
+                if (GV->hasName() && !GV->getName().startswith("llvm."))
+                {
+                    Refs.push_back(intern(GV->getName()));
+                }
+            }
+            else if (auto* C = dyn_cast<Constant>(V))
+            {
+                Worklist.append(C->op_begin(), C->op_end());
+            }
+        }
+    };
+
+    for (const Function& F : M)
+    {
+        if (F.isDeclaration())
+        {
+            continue;
+        }
+        Symbol& Sym = m_Symbols[F.getName()];
+        Visited.clear();
+        for (const_inst_iterator it = inst_begin(F), e = inst_end(F); it != e; ++it)
+        {
+            const Instruction* I = &*it;
+            if (auto* pInstCall = dyn_cast<CallInst>(I))
+            {
+                const Function* pCalledFunc = pInstCall->getCalledFunction();
+                if (pCalledFunc && !pCalledFunc->isIntrinsic() && Visited.insert(pCalledFunc).second)
+                {
+                    Sym.Callees.push_back(intern(pCalledFunc->getName()));
+                }
+            }
+            CollectRefs(I, Sym.Refs);
+        }
+    }
+
+    for (const GlobalVariable& GV : M.globals())
+    {
+        if (GV.isDeclaration())
+        {
+            continue;
+        }
+        Visited.clear();
+        CollectRefs(&GV, m_Symbols[GV.getName()].Refs);
+        if (GV.hasAppendingLinkage() || GV.getName().startswith("llvm."))
+        {
+            m_Roots.push_back(intern(GV.getName()));
+        }
+    }
+
+    for (const GlobalAlias& GA : M.aliases())
+    {
+        Visited.clear();
+        CollectRefs(&GA, m_Symbols[GA.getName()].Refs);
+    }
+}
+
+const BiFSymbolTable::Symbol* BiFSymbolTable::lookup(StringRef Name) const
+{
+    auto it = m_Symbols.find(Name);
+    return it == m_Symbols.end() ? nullptr : &it->second;
+}
+
+StringRef BiFSymbolTable::intern(StringRef Name)
+{
+    return m_Names.insert(Name).first->getKey();
+}
+
 char BIImport::ID = 0;
 
-BIImport::BIImport(std::unique_ptr<Module> pGenericModule, std::unique_ptr<Module> pSizeModule) :
+BIImport::BIImport(
+    std::unique_ptr<Module> pGenericModule,
+    std::unique_ptr<Module> pSizeModule,
+    const BiFSymbolTable* pGenericSymbols,
+    const BiFSymbolTable* pSizeSymbols) :
     ModulePass(ID),
     m_GenericModule(std::move(pGenericModule)),
-    m_SizeModule(std::move(pSizeModule))
+    m_SizeModule(std::move(pSizeModule)),
+    m_GenericSymbols(pGenericSymbols),
+    m_SizeSymbols(pSizeSymbols)
 {
     initializeBIImportPass(*PassRegistry::getPassRegistry());
 }
@@ -302,6 +394,153 @@ static bool materialized_use_empty(const Value* v)
     return v->materialized_use_begin() == v->use_end();
 }
 
+unsigned BIImport::MaterializeBuiltins(Module& M)
+{
+    IGC_ASSERT(nullptr != m_GenericSymbols);
+
+    // Same lookup order as GetBuiltinFunction2: generic module first.
+    auto Resolve = [&](StringRef Name, Module*& pBuiltinModule) -> const BiFSymbolTable::Symbol*
+    {
+        if (const BiFSymbolTable::Symbol* pSym = m_GenericSymbols->lookup(Name))
+        {
+            pBuiltinModule = m_GenericModule.get();
+            return pSym;
+        }
+        if (m_SizeModule)
+        {
+            if (const BiFSymbolTable::Symbol* pSym = m_SizeSymbols->lookup(Name))
+            {
+                pBuiltinModule = m_SizeModule.get();
+                return pSym;
+            }
+        }
+        return nullptr;
+    };
+
+    auto AddKMPLockAttrs = [](Function* pFunc)
+    {
+        if (pFunc->getName().startswith("__builtin_IB_kmp_"))
+        {
+            pFunc->addFnAttr(llvm::Attribute::NoInline);
+            pFunc->addFnAttr("KMPLOCK");
+        }
+    };
+
+    // Builtins are only marked as such when they are reached through a call,
+    // as the explicit traversal does; anything else they refer to is still
+    // imported.
+    StringSet<> visited;
+    StringSet<> called;
+    SmallVector<StringRef, 64> worklist;
+    auto Visit = [&](StringRef Name, bool isCall)
+    {
+        if (isCall)
+        {
+            called.insert(Name);
+        }
+        if (visited.insert(Name).second)
+        {
+            worklist.push_back(Name);
+        }
+    };
+
+    for (auto& func : M)
+    {
+        TFunctionsVec calledFuncs;
+        GetCalledFunctions(&func, calledFuncs);
+        for (auto* pCallee : calledFuncs)
+        {
+            if (pCallee->isDeclaration())
+            {
+                Visit(pCallee->getName(), true);
+            }
+            else
+            {
+                AddKMPLockAttrs(pCallee);
+            }
+        }
+    }
+    for (StringRef Root : m_GenericSymbols->getRoots())
+    {
+        Visit(Root, false);
+    }
+    if (m_SizeModule)
+    {
+        for (StringRef Root : m_SizeSymbols->getRoots())
+        {
+            Visit(Root, false);
+        }
+    }
+
+    SmallVector<Function*, 64> imported;
+    while (!worklist.empty())
+    {
+        StringRef Name = worklist.pop_back_val();
+        Module* pBuiltinModule = nullptr;
+        const BiFSymbolTable::Symbol* pSym = Resolve(Name, pBuiltinModule);
+        if (!pSym)
+        {
+            continue;
+        }
+
+        Function* pFunc = pBuiltinModule->getFunction(Name);
+        if (pFunc && pFunc->isMaterializable())
+        {
+            if (Error Err = pFunc->materialize())
+            {
+                handleAllErrors(std::move(Err), [&](ErrorInfoBase& EIB) {
+                    errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+                });
+                IGC_ASSERT_MESSAGE(0, "Failed to materialize Global Variables");
+                continue;
+            }
+            imported.push_back(pFunc);
+        }
+
+        for (StringRef Callee : pSym->Callees)
+        {
+            Visit(Callee, true);
+        }
+        for (StringRef Ref : pSym->Refs)
+        {
+            Visit(Ref, false);
+        }
+    }
+
+    for (Function* pFunc : imported)
+    {
+        if (called.count(pFunc->getName()))
+        {
+            pFunc->addAttribute(AttributeList::FunctionIndex, llvm::Attribute::Builtin);
+            AddKMPLockAttrs(pFunc);
+        }
+    }
+    return (unsigned)imported.size();
+}
+
+void BIImport::RemoveUnusedGlobals(Module& BuiltinModule, const Module& M)
+{
+    // Only what GlobalDCE would remove after linking anyway. Erasing a
+    // global can leave the globals in its initializer unused, so repeat.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto I = BuiltinModule.global_begin(), E = BuiltinModule.global_end(); I != E; )
+        {
+            GlobalVariable* GV = &*I++;
+            GV->removeDeadConstantUsers();
+            if (GV->use_empty() &&
+                GV->isDiscardableIfUnused() &&
+                !M.getNamedValue(GV->getName()))
+            {
+                GV->eraseFromParent();
+                changed = true;
+            }
+        }
+    }
+}
+
 void BIImport::WriteElfHeaderToMap(DenseMap<StringRef, int>& Map, char* pData, size_t dataSize)
 {
     //Data from pData is layed out as follows.....
@@ -530,53 +769,65 @@ bool BIImport::runOnModule(Module& M)
         }
     }
 
-    std::function<void(Function*)> Explore = [&](Function* pRoot) -> void
+    unsigned numImported = 0;
+    const bool useSymbolTables = m_GenericSymbols && (!m_SizeModule || m_SizeSymbols);
+    if (useSymbolTables)
     {
-        TFunctionsVec calledFuncs;
-        GetCalledFunctions(pRoot, calledFuncs);
-
-        for (auto* pCallee : calledFuncs)
+        numImported = MaterializeBuiltins(M);
+    }
+    else
+    {
+        std::function<void(Function*)> Explore = [&](Function* pRoot) -> void
         {
-            Function* pFunc = nullptr;
-            if (pCallee->isDeclaration())
-            {
-                auto funcName = pCallee->getName();
-                Function* pSrcFunc = GetBuiltinFunction2(funcName);
-                if (!pSrcFunc) continue;
-                pFunc = pSrcFunc;
-            }
-            else
-            {
-                pFunc = pCallee;
-            }
+            TFunctionsVec calledFuncs;
+            GetCalledFunctions(pRoot, calledFuncs);
 
-            if (pFunc->isMaterializable())
+            for (auto* pCallee : calledFuncs)
             {
-                if (Error Err = pFunc->materialize()) {
-                    std::string Msg;
-                    handleAllErrors(std::move(Err), [&](ErrorInfoBase& EIB) {
-                        errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
-                    });
-                    IGC_ASSERT_MESSAGE(0, "Failed to materialize Global Variables");
+                Function* pFunc = nullptr;
+                if (pCallee->isDeclaration())
+                {
+                    auto funcName = pCallee->getName();
+                    Function* pSrcFunc = GetBuiltinFunction2(funcName);
+                    if (!pSrcFunc) continue;
+                    pFunc = pSrcFunc;
                 }
-                else {
-                    pFunc->addAttribute(AttributeList::FunctionIndex, llvm::Attribute::Builtin);
-                    Explore(pFunc);
+                else
+                {
+                    pFunc = pCallee;
                 }
-            }
 
-            if (pFunc->getName().startswith("__builtin_IB_kmp_"))
-            {
-                pFunc->addFnAttr(llvm::Attribute::NoInline);
-                pFunc->addFnAttr("KMPLOCK");
+                if (pFunc->isMaterializable())
+                {
+                    if (Error Err = pFunc->materialize()) {
+                        std::string Msg;
+                        handleAllErrors(std::move(Err), [&](ErrorInfoBase& EIB) {
+                            errs() << "===> Materialize Failure: " << EIB.message().c_str() << '\n';
+                        });
+                        IGC_ASSERT_MESSAGE(0, "Failed to materialize Global Variables");
+                    }
+                    else {
+                        pFunc->addAttribute(AttributeList::FunctionIndex, llvm::Attribute::Builtin);
+                        ++numImported;
+                        Explore(pFunc);
+                    }
+                }
+
+                if (pFunc->getName().startswith("__builtin_IB_kmp_"))
+                {
+                    pFunc->addFnAttr(llvm::Attribute::NoInline);
+                    pFunc->addFnAttr("KMPLOCK");
+                }
             }
-        }
-    };
+        };
 
-    for (auto& func : M)
-    {
-        Explore(&func);
+        for (auto& func : M)
+        {
+            Explore(&func);
+        }
     }
+    COMPILER_COUNTER_ADD(getAnalysis<CodeGenContextWrapper>().getCodeGenContext(),
+        COUNTER_OCL_BiFFunctionsImported, numImported);
 
     // nuke the unused functions so we can materializeAll() quickly
     auto CleanUnused = [](Module* Module)
@@ -600,6 +851,10 @@ bool BIImport::runOnModule(Module& M)
     if (Error err = m_GenericModule->materializeAll()) {
         IGC_ASSERT_MESSAGE(0, "materializeAll failed for generic builtin module");
     }
+    if (useSymbolTables)
+    {
+        RemoveUnusedGlobals(*m_GenericModule, M);
+    }
 
     if (ld.linkInModule(std::move(m_GenericModule)))
     {
@@ -613,11 +868,26 @@ bool BIImport::runOnModule(Module& M)
         {
             IGC_ASSERT_MESSAGE(0, "materializeAll failed for size_t builtin module");
         }
+        if (useSymbolTables)
+        {
+            RemoveUnusedGlobals(*m_SizeModule, M);
+        }
 
-        if (ld.linkInModule(std::move(m_SizeModule)))
+        // Most programs need nothing from the size_t module, and linking
+        // what is left of it (declarations only) would not change M.
+        auto isDefinition = [](const GlobalValue& GV) { return !GV.isDeclaration(); };
+        const bool hasDefinitions =
+            std::any_of(m_SizeModule->begin(), m_SizeModule->end(), isDefinition) ||
+            std::any_of(m_SizeModule->global_begin(), m_SizeModule->global_end(), isDefinition) ||
+            !m_SizeModule->alias_empty();
+        if (!useSymbolTables || hasDefinitions)
         {
-            IGC_ASSERT_MESSAGE(0, "Error linking size_t builtin module");
+            if (ld.linkInModule(std::move(m_SizeModule)))
+            {
+                IGC_ASSERT_MESSAGE(0, "Error linking size_t builtin module");
+            }
         }
+        m_SizeModule.reset();
     }
 
     InitializeBIFlags(M);
@@ -838,9 +1108,12 @@ void BIImport::InitializeBIFlags(Module& M)
 
 extern "C" llvm::ModulePass* createBuiltInImportPass(
     std::unique_ptr<Module> pGenericModule,
-    std::unique_ptr<Module> pSizeModule)
+    std::unique_ptr<Module> pSizeModule,
+    const BiFSymbolTable* pGenericSymbols,
+    const BiFSymbolTable* pSizeSymbols)
 {
-    return new BIImport(std::move(pGenericModule), std::move(pSizeModule));
+    return new BIImport(std::move(pGenericModule), std::move(pSizeModule),
+        pGenericSymbols, pSizeSymbols);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
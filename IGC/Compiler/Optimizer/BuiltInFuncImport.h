@@ -30,6 +30,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "AdaptorOCL/CLElfLib/ElfReader.h"
@@ -40,6 +42,40 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace IGC
 {
+    /// Index of a builtin module: the global values that each of its
+    /// definitions refers to. It is built once per process from a fully
+    /// materialized copy of the module, so that BIImport finds the builtins a
+    /// program needs without scanning or materializing any other builtin.
+    class BiFSymbolTable
+    {
+    public:
+        struct Symbol
+        {
+            /// Functions the definition calls directly
+            std::vector<llvm::StringRef> Callees;
+            /// Other global values it refers to, e.g. through its initializer
+            /// or by taking their address
+            std::vector<llvm::StringRef> Refs;
+        };
+
+        explicit BiFSymbolTable(const llvm::Module& M);
+
+        /// The symbol the module defines as Name, or nullptr if it does not
+        /// define Name.
+        const Symbol* lookup(llvm::StringRef Name) const;
+
+        /// Definitions that are kept whether they are referenced or not,
+        /// e.g. the appending llvm.used list.
+        const std::vector<llvm::StringRef>& getRoots() const { return m_Roots; }
+
+    private:
+        llvm::StringRef intern(llvm::StringRef Name);
+
+        llvm::StringSet<> m_Names;
+        llvm::StringMap<Symbol> m_Symbols;
+        std::vector<llvm::StringRef> m_Roots;
+    };
+
     /// This pass imports built-in functions from source module to destination module.
     class BIImport : public llvm::ModulePass
     {
@@ -53,7 +89,9 @@ namespace IGC
 
         /// @brief Constructor
         BIImport(std::unique_ptr<llvm::Module> pGenericModule = nullptr,
-            std::unique_ptr<llvm::Module> pSizeModule = nullptr);
+            std::unique_ptr<llvm::Module> pSizeModule = nullptr,
+            const BiFSymbolTable* pGenericSymbols = nullptr,
+            const BiFSymbolTable* pSizeSymbols = nullptr);
 
         /// @brief analyses used
         virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override
@@ -94,6 +132,15 @@ namespace IGC
         static llvm::Function* GetBuiltinFunction(llvm::StringRef funcName, llvm::Module* GenericModule);
         llvm::Function* GetBuiltinFunction2(llvm::StringRef funcName) const;
 
+        /// @brief  Materialize the builtins reachable from the calls in M, using
+        ///         the symbol tables to find them.
+        /// @return Number of builtins materialized.
+        unsigned MaterializeBuiltins(llvm::Module& M);
+
+        /// @brief  Erase the global variables of a fully materialized builtin
+        ///         module that nothing refers to, so they are not linked.
+        static void RemoveUnusedGlobals(llvm::Module& BuiltinModule, const llvm::Module& M);
+
         /// @brief  Read elf Header file that is constructed by Build Packager and write to a DenseMap.
         static void WriteElfHeaderToMap(llvm::DenseMap<llvm::StringRef, int>& Map, char* pData, size_t dataSize);
 
@@ -101,12 +148,17 @@ namespace IGC
         /// Builtin module - contains the source function definition to import
         std::unique_ptr<llvm::Module> m_GenericModule;
         std::unique_ptr<llvm::Module> m_SizeModule;
+        /// Symbol tables of the builtin modules, if they were indexed
+        const BiFSymbolTable* m_GenericSymbols;
+        const BiFSymbolTable* m_SizeSymbols;
     };
 
 } // namespace IGC
 
 extern "C" llvm::ModulePass* createBuiltInImportPass(
-    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule);
+    std::unique_ptr<llvm::Module> pGenericModule, std::unique_ptr<llvm::Module> pSizeModule,
+    const IGC::BiFSymbolTable* pGenericSymbols = nullptr,
+    const IGC::BiFSymbolTable* pSizeSymbols = nullptr);
 
 namespace IGC
 {
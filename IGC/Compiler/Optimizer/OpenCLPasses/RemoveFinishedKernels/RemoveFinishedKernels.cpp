@@ -0,0 +1,126 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Compiler/Optimizer/OpenCLPasses/RemoveFinishedKernels/RemoveFinishedKernels.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/CommandLine.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// The retry manager is only filled in by codegen; tests name the kernels
+// that still have to be compiled here instead.
+static cl::list<std::string> RetryKernels(
+    "igc-retry-kernels", cl::CommaSeparated, cl::ZeroOrMore,
+    cl::desc("Kernels left to compile on retry (for testing)"), cl::Hidden);
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-remove-finished-kernels"
+#define PASS_DESCRIPTION "Remove kernels already compiled on a previous try"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(RemoveFinishedKernels, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(RemoveFinishedKernels, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char RemoveFinishedKernels::ID = 0;
+
+RemoveFinishedKernels::RemoveFinishedKernels() : ModulePass(ID)
+{
+    initializeRemoveFinishedKernelsPass(*PassRegistry::getPassRegistry());
+}
+
+bool RemoveFinishedKernels::runOnModule(Module& M)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableIncrementalOCLRetry))
+    {
+        return false;
+    }
+
+    MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    CodeGenContext* pCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+
+    std::set<std::string> retrySet(RetryKernels.begin(), RetryKernels.end());
+    if (retrySet.empty())
+    {
+        retrySet = pCtx->m_retryManager.kernelSet;
+    }
+    if (retrySet.empty())
+    {
+        // Not a retry: nothing has been compiled yet.
+        return false;
+    }
+
+    SmallVector<Function*, 16> finished;
+    for (auto& F : M)
+    {
+        if (isEntryFunc(pMdUtils, &F) &&
+            F.use_empty() &&
+            !isIntelSymbolTableVoidProgram(&F) &&
+            retrySet.count(F.getName().str()) == 0)
+        {
+            finished.push_back(&F);
+        }
+    }
+
+    if (finished.empty())
+    {
+        return false;
+    }
+
+    // Globals only referenced by the finished kernels would be removed by
+    // GlobalDCE in OptimizeIR, leaving dangling keys in
+    // inlineProgramScopeOffsets. The finished kernels still relocate against
+    // them and the program scope buffer layout must not change, so keep them.
+    if (!modMD->inlineProgramScopeOffsets.empty())
+    {
+        SmallVector<GlobalValue*, 16> programScopeGlobals;
+        for (auto& global : modMD->inlineProgramScopeOffsets)
+        {
+            programScopeGlobals.push_back(global.first);
+        }
+        IGC::appendToUsed(M, programScopeGlobals);
+    }
+
+    for (auto* F : finished)
+    {
+        IGCMetaDataHelper::removeFunction(*pMdUtils, *modMD, F);
+        F->eraseFromParent();
+    }
+    pMdUtils->save(M.getContext());
+    return true;
+}
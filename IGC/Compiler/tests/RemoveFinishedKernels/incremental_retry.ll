@@ -0,0 +1,70 @@
+;===================== begin_copyright_notice ==================================
+
+;Copyright (c) 2017 Intel Corporation
+
+;Permission is hereby granted, free of charge, to any person obtaining a
+;copy of this software and associated documentation files (the
+;"Software"), to deal in the Software without restriction, including
+;without limitation the rights to use, copy, modify, merge, publish,
+;distribute, sublicense, and/or sell copies of the Software, and to
+;permit persons to whom the Software is furnished to do so, subject to
+;the following conditions:
+
+;The above copyright notice and this permission notice shall be included
+;in all copies or substantial portions of the Software.
+
+;THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+;OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+;MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+;IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+;CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+;TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+;SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+;======================= end_copyright_notice ==================================
+; RUN: env IGC_EnableIncrementalOCLRetry=1 igc_opt -igc-programscope-constant-analysis -igc-remove-finished-kernels -igc-retry-kernels=spilling -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+; RUN: env IGC_EnableIncrementalOCLRetry=0 igc_opt -igc-programscope-constant-analysis -igc-remove-finished-kernels -igc-retry-kernels=spilling -S %s -o %t.off.ll
+; RUN: FileCheck %s --check-prefix=OFF --input-file=%t.off.ll
+
+; On an incremental retry only @spilling is compiled again. @done already has
+; its output from the first try, so it is dropped; the program scope constant
+; it alone reads must stay allocated for its relocations.
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v16:16:16-v24:32:32-v32:32:32-v48:64:64-v64:64:64-v96:128:128-v128:128:128-v192:256:256-v256:256:256-v512:512:512-v1024:1024:1024-n8:16:32"
+
+@table = addrspace(2) constant [4 x i32] [i32 1, i32 2, i32 3, i32 4], align 4
+
+; CHECK: @llvm.used = appending global {{.*}} @table
+; CHECK-NOT: define void @done
+; CHECK: define void @spilling
+; CHECK: define void @Intel_Symbol_Table_Void_Program
+
+; OFF-NOT: @llvm.used
+; OFF: define void @done
+; OFF: define void @spilling
+; OFF: define void @Intel_Symbol_Table_Void_Program
+
+define void @done(i32 addrspace(1)* %dst, i32 %i) {
+  %p = getelementptr inbounds [4 x i32], [4 x i32] addrspace(2)* @table, i32 0, i32 %i
+  %v = load i32, i32 addrspace(2)* %p, align 4
+  store i32 %v, i32 addrspace(1)* %dst, align 4
+  ret void
+}
+
+define void @spilling(i32 addrspace(1)* %dst, i32 %v) {
+  store i32 %v, i32 addrspace(1)* %dst, align 4
+  ret void
+}
+
+define void @Intel_Symbol_Table_Void_Program() {
+  ret void
+}
+
+!igc.functions = !{!0, !3, !4}
+!0 = !{void (i32 addrspace(1)*, i32)* @done, !1}
+!1 = !{!2}
+!2 = !{!"function_type", i32 0}
+!3 = !{void (i32 addrspace(1)*, i32)* @spilling, !1}
+!4 = !{void ()* @Intel_Symbol_Table_Void_Program, !1}
@@ -809,15 +809,18 @@ void GenXLiveness::moveUnifiedRet(Function *OldF, Function *NewF)
  * after the hole is returned. If the number is before the first
  * segment, the first segment is returned. If the number is after the
  * last segment, end() is returned.
+ *
+ * The search is restricted to the segments from From onwards, which lets
+ * interference checks resume from where their previous search ended.
  */
-LiveRange::iterator LiveRange::find(unsigned Pos)
+LiveRange::iterator LiveRange::find(unsigned Pos, iterator From)
 {
-  size_t Len = size();
+  size_t Len = end() - From;
   if (!Len)
     return end();
-  if (Pos > Segments[Len - 1].getEnd())
+  if (Pos > getEnd())
     return end();
-  iterator I = begin();
+  iterator I = From;
   do {
     size_t Mid = Len >> 1;
     if (Pos <= I[Mid].getEnd())
@@ -975,46 +978,69 @@ bool GenXLiveness::twoAddrInterfere(LiveRange *LR1, LiveRange *LR2)
 bool GenXLiveness::getSingleInterferenceSites(LiveRange *LR1, LiveRange *LR2,
     SmallVectorImpl<unsigned> *Sites)
 {
+  if (!LR1->size() || !LR2->size())
+    return false;
+  // Segments are sorted, so two live ranges whose overall spans do not
+  // overlap cannot interfere. This rejects most candidate pairs without
+  // walking any segments.
+  if (LR1->getStart() >= LR2->getEnd() || LR2->getStart() >= LR1->getEnd())
+    return false;
+  // Interference needs a non-weak segment in one LR to overlap a segment in
+  // the other, which can only happen in a bucket where the summaries of both
+  // have the matching category bit set.
+  unsigned Shift = getSummaryShift();
+  const LiveRange::Summary &Sum1 = LR1->getSummary(Shift);
+  const LiveRange::Summary &Sum2 = LR2->getSummary(Shift);
+  if ((Sum1.NonWeak & Sum2.Any).none() && (Sum1.Any & Sum2.NonWeak).none())
+    return false;
   // Swap if necessary to make LR1 the one with more segments.
   if (LR1->size() < LR2->size())
     std::swap(LR1, LR2);
-  auto Idx2 = LR2->begin(), End2 = LR2->end();
-  // Find segment in LR1 that contains or is the next after the start
-  // of the first segment in LR2, including the case that the start of
-  // the LR2 segment abuts the end of the LR1 segment.
-  auto Idx1 = LR1->find(Idx2->getStart()), End1 = LR1->end();
-  if (Idx1 == End1)
-    return false;
-  for (;;) {
-    // Check for overlap.
-    if (Idx1->getStart() < Idx2->getStart()) {
-      if (Idx1->getEnd() > Idx2->getStart())
-        if (checkIfOverlappingSegmentsInterfere(LR1, Idx1, LR2, Idx2)) {
-          // Idx1 overlaps Idx2. Check if it is a single number overlap that can
-          // be pushed into Sites.
-          if (!Sites || Idx1->getEnd() != Idx2->getStart() + 1)
-            return true;
-          Sites->push_back(Idx2->getStart());
-        }
-    } else {
-      if (Idx1->getStart() < Idx2->getEnd())
-        if (checkIfOverlappingSegmentsInterfere(LR1, Idx1, LR2, Idx2)) {
-          // Idx2 overlaps Idx1. Check if it is a single number overlap that can
-          // be pushed into Sites.
-          if (!Sites || Idx2->getEnd() != Idx1->getStart() + 1)
-            return true;
-          Sites->push_back(Idx1->getStart());
-        }
-    }
-    // Advance whichever one has the lowest End.
-    if (Idx1->getEnd() < Idx2->getEnd()) {
-      if (++Idx1 == End1)
-        return false;
-    } else {
-      if (++Idx2 == End2)
-        return false;
+  // For each segment in LR2, binary search LR1's sorted segments for the
+  // ones that overlap it. Each search starts where the previous one ended,
+  // as LR2's segments are sorted too.
+  auto Idx1 = LR1->begin(), End1 = LR1->end();
+  for (auto Idx2 = LR2->begin(), End2 = LR2->end(); Idx2 != End2; ++Idx2) {
+    // Find the first segment in LR1 that ends after the start of Idx2. It
+    // and the segments after it that start before the end of Idx2 overlap it.
+    Idx1 = LR1->find(Idx2->getStart() + 1, Idx1);
+    if (Idx1 == End1)
+      return false;
+    for (auto Ovl1 = Idx1; Ovl1 != End1 && Ovl1->getStart() < Idx2->getEnd();
+         ++Ovl1) {
+      if (!checkIfOverlappingSegmentsInterfere(LR1, Ovl1, LR2, Idx2))
+        continue;
+      // Check if it is a single number overlap that can be pushed into Sites.
+      if (!Sites)
+        return true;
+      if (Ovl1->getStart() < Idx2->getStart()) {
+        if (Ovl1->getEnd() != Idx2->getStart() + 1)
+          return true;
+        Sites->push_back(Idx2->getStart());
+      } else {
+        if (Idx2->getEnd() != Ovl1->getStart() + 1)
+          return true;
+        Sites->push_back(Ovl1->getStart());
+      }
     }
   }
+  return false;
+}
+
+/***********************************************************************
+ * getSummaryShift : get the bucket size for live range summaries
+ *
+ * Buckets are made just big enough for the summary bits to cover the whole
+ * numbering. Numbers beyond that wrap around, which only makes the summary
+ * less precise.
+ */
+unsigned GenXLiveness::getSummaryShift() const
+{
+  unsigned LastNum = Numbering ? Numbering->getLastNumber() : 0;
+  unsigned Shift = 0;
+  while ((LastNum >> Shift) >= LiveRange::SummaryBits)
+    ++Shift;
+  return Shift;
 }
 
 /***********************************************************************
@@ -1591,6 +1617,7 @@ void LiveRange::addSegment(Segment Seg)
     // New segment is completely in a hole just before i.
     Segments.insert(i, Seg);
   }
+  invalidateSummary();
   IGC_ASSERT(testLiveRanges());
 }
 
@@ -1602,6 +1629,7 @@ void LiveRange::setSegmentsFrom(LiveRange *Other)
 {
   Segments.clear();
   Segments.append(Other->Segments.begin(), Other->Segments.end());
+  invalidateSummary();
 }
 
 /***********************************************************************
@@ -1610,6 +1638,7 @@ void LiveRange::setSegmentsFrom(LiveRange *Other)
 void LiveRange::addSegments(LiveRange *LR2)
 {
   Segments.append(LR2->Segments.begin(), LR2->Segments.end());
+  invalidateSummary();
 }
 
 /***********************************************************************
@@ -1617,6 +1646,7 @@ void LiveRange::addSegments(LiveRange *LR2)
  *      and merge overlapping/adjacent ones
  */
 void LiveRange::sortAndMerge() {
+  invalidateSummary();
   std::sort(Segments.begin(), Segments.end());
 
   // Ensure that there are no duplicate segments:
@@ -1709,19 +1739,31 @@ void LiveRange::prepareFuncs(FunctionGroupAnalysis *FGA) {
       DefFunc = Arg->getParent();
 
     if (DefFunc)
-      Funcs.insert(FGA->getSubGroup(DefFunc)
+      addFunc(FGA->getSubGroup(DefFunc)
         ? FGA->getSubGroup(DefFunc)->getHead()
         : FGA->getGroup(DefFunc)->getHead());
 
     for (auto U : Val.getValue()->users())
       if (Instruction *UserInst = dyn_cast<Instruction>(U)) {
         auto F = UserInst->getFunction();
-        Funcs.insert(FGA->getSubGroup(F) ? FGA->getSubGroup(F)->getHead()
-                                         : FGA->getGroup(F)->getHead());
+        addFunc(FGA->getSubGroup(F) ? FGA->getSubGroup(F)->getHead()
+                                    : FGA->getGroup(F)->getHead());
       }
   }
 }
 
+/***********************************************************************
+ * LiveRange::addFunc : add a function to the Funcs set
+ *
+ * An LR spans very few kernel/stack functions, so Funcs is a small vector
+ * kept sorted by pointer, which iterates in the same order a std::set would.
+ */
+void LiveRange::addFunc(Function *F) {
+  auto I = std::lower_bound(Funcs.begin(), Funcs.end(), F);
+  if (I == Funcs.end() || *I != F)
+    Funcs.insert(I, F);
+}
+
 /***********************************************************************
  * LiveRange::getLength : add up the number of instructions covered by this LR
  */
@@ -1736,6 +1778,37 @@ unsigned LiveRange::getLength(bool WithWeak)
   return Length;
 }
 
+/***********************************************************************
+ * LiveRange::getSummary : get the summary with buckets of 1 << Shift numbers
+ *
+ * The summary is rebuilt if the segments changed since it was last built,
+ * or if it was built with a different bucket size.
+ */
+const LiveRange::Summary &LiveRange::getSummary(unsigned Shift)
+{
+  if (Sum.Shift == Shift)
+    return Sum;
+  Sum.Any.reset();
+  Sum.NonWeak.reset();
+  for (auto i = begin(), e = end(); i != e; ++i) {
+    // An empty segment still overlaps a segment around its start, so it
+    // takes the bucket of its start.
+    unsigned First = i->getStart() >> Shift;
+    unsigned Last = (std::max(i->getEnd(), i->getStart() + 1) - 1) >> Shift;
+    std::bitset<SummaryBits> Bits;
+    if (Last - First + 1 >= SummaryBits)
+      Bits.set();
+    else
+      for (unsigned Bucket = First; Bucket <= Last; ++Bucket)
+        Bits.set(Bucket % SummaryBits);
+    Sum.Any |= Bits;
+    if (!i->isWeak())
+      Sum.NonWeak |= Bits;
+  }
+  Sum.Shift = Shift;
+  return Sum;
+}
+
 /***********************************************************************
  * LiveRange::print : print the live range
  */
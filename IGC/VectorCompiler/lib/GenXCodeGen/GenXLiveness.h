@@ -181,6 +181,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "llvm/IR/ValueHandle.h"
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/MapVector.h"
+#include <bitset>
 #include <map>
 #include <set>
 #include <string>
@@ -364,13 +365,29 @@ public:
 // its def and uses need.
 class LiveRange {
   friend class llvm::GenXLiveness;
+public:
+  // Summary : a coarse picture of where the LR is live, used to reject
+  // interference checks without walking segments. Instruction numbers are
+  // grouped into buckets of 1 << Shift numbers, wrapping around after
+  // SummaryBits buckets, and there is one bitvector per segment category
+  // with a bit set for each bucket that has a segment of that category.
+  static constexpr unsigned SummaryBits = 256;
+  struct Summary {
+    std::bitset<SummaryBits> Any;     // any segment
+    std::bitset<SummaryBits> NonWeak; // strong or phicpy segment
+    unsigned Shift = ~0U;             // ~0U if not built
+  };
+private:
   typedef SmallVector<Segment, 2> Segments_t;
   Segments_t Segments;
   typedef SmallVector<AssertingSV, 2> Values_t;
   Values_t Values;
+  // summary of Segments, built on demand and dropped when they change
+  Summary Sum;
+  void invalidateSummary() { Sum.Shift = ~0U; }
 public:
-  // kernel/stack functions that this LR spans across
-  std::set<llvm::Function*> Funcs;
+  // kernel/stack functions that this LR spans across, sorted and unique
+  SmallVector<llvm::Function *, 2> Funcs;
   unsigned Category :8;
   unsigned LogAlignment :7;
   bool DisallowCASC: 1; // disallow call arg special coalescing
@@ -384,7 +401,7 @@ public:
   const_iterator begin() const { return Segments.begin(); }
   const_iterator end() const { return Segments.end(); }
   unsigned size() const { return Segments.size(); }
-  void resize(unsigned len) { Segments.resize(len); }
+  void resize(unsigned len) { Segments.resize(len); invalidateSummary(); }
   // Iterator forwarders for Values.
   // This is complicated by the Values vector containing AssertingSV, but the
   // iterator wants to dereference to a Simplevalue.
@@ -406,10 +423,16 @@ public:
   // find : return iterator to segment containing Num (including the case
   // of being equal to the segment's End), or, if in a hole, the
   // iterator of the next segment, or, if at end, end().
-  iterator find(unsigned Num);
-  void clear() { Segments.clear(); Values.clear(); }
-  void push_back(Segment Seg) { Segments.push_back(Seg); }
-  void push_back(unsigned S, unsigned E) { Segments.push_back(Segment(S, E)); }
+  iterator find(unsigned Num) { return find(Num, begin()); }
+  // find : as above, but only search the segments from From onwards
+  iterator find(unsigned Num, iterator From);
+  // getStart : start of the first segment; the LR must not be empty
+  unsigned getStart() const { return Segments.front().getStart(); }
+  // getEnd : end of the last segment; the LR must not be empty
+  unsigned getEnd() const { return Segments.back().getEnd(); }
+  void clear() { Segments.clear(); Values.clear(); invalidateSummary(); }
+  void push_back(Segment Seg) { Segments.push_back(Seg); invalidateSummary(); }
+  void push_back(unsigned S, unsigned E) { push_back(Segment(S, E)); }
   SimpleValue addValue(SimpleValue V) { Values.push_back(V); return V; }
   // contains : test whether live range contains instruction number
   bool contains(unsigned Num) {
@@ -442,8 +465,12 @@ public:
   // prepareFuncs : fill the Funcs set with kernel or stack functions which this
   //    LR is alive in
   void prepareFuncs(FunctionGroupAnalysis *FGA);
+  // addFunc : add a function to the Funcs set
+  void addFunc(llvm::Function *F);
   // getLength : add up the number of instructions covered by this LR
   unsigned getLength(bool WithWeak);
+  // getSummary : get the summary with buckets of 1 << Shift numbers
+  const Summary &getSummary(unsigned Shift);
   // debug dump/print
   void dump() const;
   void print(raw_ostream &OS) const;
@@ -642,6 +669,7 @@ private:
   void rebuildLiveRangeForValue(genx::LiveRange *LR, genx::SimpleValue SV);
   genx::LiveRange *visitPropagateSLRs(Function *F);
   void merge(genx::LiveRange *LR1, genx::LiveRange *LR2);
+  unsigned getSummaryShift() const;
 };
 
 void initializeGenXLivenessPass(PassRegistry &);
@@ -55,6 +55,9 @@ public:
     // write the ELF file into OS, return the number of written bytes
     uint64_t write();
 
+    // return the number of bytes write would write, without writing them
+    uint64_t getSize();
+
 private:
     typedef ZEELFObjectBuilder::Section Section;
     typedef ZEELFObjectBuilder::StandardSection StandardSection;
@@ -319,6 +322,20 @@ uint64_t ZEELFObjectBuilder::finalize(llvm::raw_pwrite_stream& os)
     return w.write();
 }
 
+uint64_t ZEELFObjectBuilder::getBinarySize()
+{
+    IGC_ASSERT(nullptr != m_zeInfoSection);
+    m_zeInfoSection->m_text.clear();
+    llvm::raw_string_ostream os(m_zeInfoSection->m_text);
+    llvm::yaml::Output yout(os);
+    yout << m_zeInfoSection->getZeInfo();
+    os.flush();
+
+    llvm::raw_null_ostream nulls;
+    ELFWriter w(nulls, *this);
+    return w.getSize();
+}
+
 std::string ZEELFObjectBuilder::getSectionNameBySectionID(SectionID id)
 {
     // do linear search that we assume there won't be too many sections
@@ -471,10 +488,16 @@ uint64_t ELFWriter::writeSymTab()
 uint64_t ELFWriter::writeZEInfo()
 {
     uint64_t start_off = m_W.OS.tell();
-    // serialize ze_info contents
-    llvm::yaml::Output yout(m_W.OS);
     IGC_ASSERT(nullptr != m_ObjBuilder.m_zeInfoSection);
-    yout << m_ObjBuilder.m_zeInfoSection->getZeInfo();
+    const std::string& text = m_ObjBuilder.m_zeInfoSection->m_text;
+    if (!text.empty()) {
+        // already serialized by getBinarySize
+        m_W.OS << text;
+    } else {
+        // serialize ze_info contents
+        llvm::yaml::Output yout(m_W.OS);
+        yout << m_ObjBuilder.m_zeInfoSection->getZeInfo();
+    }
 
     return m_W.OS.tell() - start_off;
 }
@@ -686,6 +709,59 @@ uint64_t ELFWriter::write()
     return m_W.OS.tell() - start;
 }
 
+uint64_t ELFWriter::getSize()
+{
+    createSectionHdrEntries();
+    uint64_t size = is64Bit() ? sizeof(ELF::Elf64_Ehdr) : sizeof(ELF::Elf32_Ehdr);
+
+    // sizes of the sections as writeSections writes them
+    for (SectionHdrEntry& entry : m_SectionHdrEntries) {
+        switch(entry.type) {
+        case ELF::SHT_PROGBITS:
+        case SHT_ZEBIN_SPIRV: {
+            const StandardSection* const stdsect =
+                static_cast<const StandardSection*>(entry.section);
+            IGC_ASSERT(nullptr != stdsect);
+            size += stdsect->m_size + stdsect->m_padding;
+            break;
+        }
+        case ELF::SHT_SYMTAB: {
+            // add symbol names in the order writeSymTab does, so that the
+            // string table below has its final size
+            for (ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_localSymbols)
+                m_StrTabBuilder.add(StringRef(sym.name()));
+            for (ZEELFObjectBuilder::Symbol& sym : m_ObjBuilder.m_globalSymbols)
+                m_StrTabBuilder.add(StringRef(sym.name()));
+            // including the first null symbol
+            size += (m_ObjBuilder.m_localSymbols.size() +
+                m_ObjBuilder.m_globalSymbols.size() + 1) * getSymTabEntSize();
+            break;
+        }
+        case ELF::SHT_REL: {
+            const RelocSection* const relocSec =
+                static_cast<const RelocSection*>(entry.section);
+            IGC_ASSERT(nullptr != relocSec);
+            size += relocSec->m_Relocations.size() * getRelocTabEntSize();
+            break;
+        }
+        case SHT_ZEBIN_ZEINFO:
+            size += m_ObjBuilder.m_zeInfoSection->m_text.size();
+            break;
+        default:
+            // SHT_NOBITS and SHT_NULL take no space, SHT_STRTAB is added once
+            // all strings are in
+            break;
+        }
+    }
+
+    m_StrTabBuilder.finalizeInOrder();
+    size += m_StrTabBuilder.getSize();
+
+    size += m_SectionHdrEntries.size() *
+        (is64Bit() ? sizeof(ELF::Elf64_Shdr) : sizeof(ELF::Elf32_Shdr));
+    return size;
+}
+
 ELFWriter::SectionHdrEntry& ELFWriter::createNullSectionHdrEntry()
 {
     m_SectionHdrEntries.emplace_back(SectionHdrEntry());
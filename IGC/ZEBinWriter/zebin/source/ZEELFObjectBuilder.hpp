@@ -202,6 +202,11 @@ public:
     // return number of written bytes
     uint64_t finalize(llvm::raw_pwrite_stream& os);
 
+    // getBinarySize - Return the number of bytes finalize will write. It is
+    // computed from the section sizes, with the ze_info section serialized
+    // once here and reused by finalize
+    uint64_t getBinarySize();
+
 private:
     class Section {
     public:
@@ -258,6 +263,9 @@ private:
         zeInfoContainer& getZeInfo()
         { return m_zeinfo; }
 
+        // the serialized ze_info, empty until getBinarySize sets it
+        std::string m_text;
+
     private:
         zeInfoContainer& m_zeinfo;
     };
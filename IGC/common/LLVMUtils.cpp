@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "common/shaderOverride.hpp"
 #include "common/IntrinsicAnnotator.hpp"
 #include "common/LLVMUtils.h"
+#include "common/CompileTrace.h"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IRReader/IRReader.h>
@@ -92,16 +93,35 @@ void IGCPassManager::add(Pass *P)
         return;
     }
 
-    if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
+    PassKind kind = P->getPassKind();
+
+    const bool timePass = m_pContext->m_compilerTimeStats && m_pContext->m_compilerTimeStats->isPerPassEnabled();
+    unsigned passTimerID = 0;
+    if (timePass)
+    {
+        passTimerID = PassTimerRegistry::getID(m_name + '_' + std::string(P->getPassName()));
+        PassManager::add(createTimeStatsIGCPass(m_pContext, passTimerID, STATS_COUNTER_START, kind == PT_Function));
+    }
+
+    // Only function and module passes are traced: markers of other kinds
+    // would split the batching of the passes around them.
+    const char* traceName = nullptr;
+    if (CompileTrace::isEnabled() && (kind == PT_Function || kind == PT_Module))
     {
-        PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_START));
+        traceName = CompileTrace::Tracer::get().intern(m_name + '_' + std::string(P->getPassName()));
+        PassManager::add(createTraceMarkerPass(m_pContext, nullptr, kind == PT_Function));
     }
 
     PassManager::add(P);
 
-    if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
+    if (traceName)
+    {
+        PassManager::add(createTraceMarkerPass(m_pContext, traceName, kind == PT_Function));
+    }
+
+    if (timePass)
     {
-        PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_END));
+        PassManager::add(createTimeStatsIGCPass(m_pContext, passTimerID, STATS_COUNTER_END, kind == PT_Function));
     }
 
     if(IGC_IS_FLAG_ENABLED(ShaderDumpEnableAll))
@@ -43,8 +43,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <iomanip>
 #include <sstream>
 #include <iostream>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 #include "Probe/Assertion.h"
 
+#if defined( _WIN32 )
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 #if GET_TIME_STATS
 // Functions exposed by VISA lib API
 extern "C" int64_t getTimerTicks(unsigned int idx);
@@ -52,6 +63,9 @@ extern "C" double getTimerCounts(unsigned int idx);
 extern "C" void getTimerNames(char* timerName, unsigned int idx);
 extern "C" unsigned int getTimerHits(unsigned int idx);
 extern "C" unsigned int getTotalTimers();
+extern "C" unsigned int getTotalMemOwners();
+extern "C" const char* getMemOwnerName(unsigned int idx);
+extern "C" uint64_t getMemOwnerPeakBytes(unsigned int idx);
 #endif
 
 namespace {
@@ -451,6 +465,13 @@ const char* g_cCompTimeIntervals[MAX_COMPILE_TIME_INTERVALS+1] =
 #undef DEFINE_TIME_STAT
 };
 
+const char* g_cCompCounters[MAX_COMPILE_COUNTERS+1] =
+{
+#define DEFINE_COUNTER_STAT( enumName, stringName ) stringName,
+#include "counterStats.def"
+#undef DEFINE_COUNTER_STAT
+};
+
 std::string str(COMPILE_TIME_INTERVALS cti)
 {
     switch (cti)
@@ -553,6 +574,108 @@ int parentIntervalDepth( COMPILE_TIME_INTERVALS cti )
 
 #if GET_TIME_STATS
 
+namespace {
+    struct PassTimerNames
+    {
+        std::mutex lock;
+        // A deque keeps the names in place as new ones are registered
+        std::deque<std::string> names;
+        std::unordered_map<std::string, unsigned> ids;
+    };
+
+    PassTimerNames& getPassTimerNames()
+    {
+        // Never destroyed: compiles may still be running at process exit
+        static PassTimerNames* names = new PassTimerNames();
+        return *names;
+    }
+
+    /// Spread TimeStatsPerPassSampleRate percent of the compiles evenly
+    bool samplePerPassTimers()
+    {
+        static std::atomic<uint64_t> compileCount(0);
+        const uint64_t rate = std::min<uint64_t>(IGC_GET_FLAG_VALUE(TimeStatsPerPassSampleRate), 100);
+        if (rate == 0)
+        {
+            return false;
+        }
+        const uint64_t n = compileCount++;
+        return (n * rate) / 100 != ((n + 1) * rate) / 100;
+    }
+
+    std::mutex g_perPassFileLock;
+
+    /// IDs of the passes that were timed, sorted by name, so that CSV columns
+    /// depend neither on registration order nor on passes of other compiles
+    std::vector<unsigned> getTimedPasses(const std::vector<PerPassTimeStat>& stats)
+    {
+        std::vector<unsigned> passIDs;
+        for (unsigned i = 0; i < stats.size(); i++)
+        {
+            if (stats[i].PassHitCount != 0)
+            {
+                passIDs.push_back(i);
+            }
+        }
+        std::sort(passIDs.begin(), passIDs.end(), [](unsigned A, unsigned B)
+        {
+            return strcmp(PassTimerRegistry::getName(A), PassTimerRegistry::getName(B)) < 0;
+        });
+        return passIDs;
+    }
+
+    /// Peak resident set size of the process in bytes
+    uint64_t getPeakRSS()
+    {
+#if defined( _WIN32 )
+        PROCESS_MEMORY_COUNTERS counters;
+        if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+        // kilobytes on Linux
+        return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+    }
+}
+
+unsigned PassTimerRegistry::getID(const std::string& name)
+{
+    PassTimerNames& PTN = getPassTimerNames();
+    std::lock_guard<std::mutex> guard(PTN.lock);
+    auto it = PTN.ids.find(name);
+    if (it != PTN.ids.end())
+    {
+        return it->second;
+    }
+    unsigned passID = (unsigned)PTN.names.size();
+    PTN.names.push_back(name);
+    PTN.ids.emplace(name, passID);
+    return passID;
+}
+
+const char* PassTimerRegistry::getName(unsigned passID)
+{
+    PassTimerNames& PTN = getPassTimerNames();
+    std::lock_guard<std::mutex> guard(PTN.lock);
+    IGC_ASSERT(passID < PTN.names.size());
+    return PTN.names[passID].c_str();
+}
+
+unsigned PassTimerRegistry::size()
+{
+    PassTimerNames& PTN = getPassTimerNames();
+    std::lock_guard<std::mutex> guard(PTN.lock);
+    return (unsigned)PTN.names.size();
+}
+
 TimeStats::TimeStats()
     : m_isPostProcessed(false)
     , m_totalShaderCount(0)
@@ -561,14 +684,26 @@ TimeStats::TimeStats()
     std::fill(std::begin(m_wallclockStart), std::end(m_wallclockStart), 0);
     std::fill(std::begin(m_elapsedTime),    std::end(m_elapsedTime),    0);
     std::fill(std::begin(m_hitCount),       std::end(m_hitCount),       0);
+    std::fill(std::begin(m_counters),       std::end(m_counters),       0);
     m_freq = iSTD::GetTimestampFrequency();
 
-    m_PassTimeStatsMap.clear();
+    m_MemEnabled = IGC_IS_FLAG_ENABLED(EnableMemAccounting);
+    std::fill(std::begin(m_memPeakStart),  std::end(m_memPeakStart),  0);
+    std::fill(std::begin(m_memPeakGrowth), std::end(m_memPeakGrowth), 0);
+
+    // Compiles are sampled when they start TIME_TOTAL, so that summary
+    // objects, which are only summed into, do not take up samples.
+    m_PerPassSampled = false;
+    m_PerPassEnabled = IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS);
+    if (m_PerPassEnabled)
+    {
+        // Size for the passes known so far so that recording rarely grows it
+        m_PassTimeStats.resize(PassTimerRegistry::size());
+    }
 }
 
 TimeStats::~TimeStats()
 {
-    m_PassTimeStatsMap.clear();
 }
 
 void TimeStats::recordVISATimers()
@@ -579,13 +714,67 @@ void TimeStats::recordVISATimers()
         m_elapsedTime[TIME_VISA_TOTAL+i] += getTimerTicks(i);
         m_hitCount[TIME_VISA_TOTAL + i] = getTimerHits(i);
     }
+    if (m_MemEnabled)
+    {
+        m_visaMemPeak.resize(getTotalMemOwners());
+        for (unsigned int i = 0; i < getTotalMemOwners(); ++i)
+        {
+            m_visaMemPeak[i] = std::max(m_visaMemPeak[i], getMemOwnerPeakBytes(i));
+        }
+    }
+}
+
+void TimeStats::captureVISATimers(VISATimerValues& values)
+{
+    values.ticks.resize(getTotalTimers());
+    values.hits.resize(getTotalTimers());
+    for (unsigned int i = 0; i < getTotalTimers(); ++i)
+    {
+        values.ticks[i] = getTimerTicks(i);
+        values.hits[i] = getTimerHits(i);
+    }
+    values.memPeaks.resize(getTotalMemOwners());
+    for (unsigned int i = 0; i < getTotalMemOwners(); ++i)
+    {
+        values.memPeaks[i] = getMemOwnerPeakBytes(i);
+    }
+}
+
+void TimeStats::recordVISATimers(const VISATimerValues& values)
+{
+    for (unsigned int i = 0; i < values.ticks.size(); ++i)
+    {
+        m_elapsedTime[TIME_VISA_TOTAL + i] += values.ticks[i];
+        m_hitCount[TIME_VISA_TOTAL + i] = values.hits[i];
+    }
+    if (m_MemEnabled)
+    {
+        m_visaMemPeak.resize(values.memPeaks.size());
+        for (unsigned int i = 0; i < values.memPeaks.size(); ++i)
+        {
+            m_visaMemPeak[i] = std::max(m_visaMemPeak[i], values.memPeaks[i]);
+        }
+    }
 }
 
 void TimeStats::recordTimerStart( COMPILE_TIME_INTERVALS compileInterval )
 {
     IGC_ASSERT(0 <= compileInterval);
     IGC_ASSERT(compileInterval < MAX_COMPILE_TIME_INTERVALS);
+    if (compileInterval == TIME_TOTAL && !m_PerPassSampled)
+    {
+        m_PerPassSampled = true;
+        if (!m_PerPassEnabled && samplePerPassTimers())
+        {
+            m_PerPassEnabled = true;
+            m_PassTimeStats.resize(PassTimerRegistry::size());
+        }
+    }
     m_wallclockStart[ compileInterval ] = iSTD::GetTimestampCounter();
+    if (m_MemEnabled)
+    {
+        m_memPeakStart[ compileInterval ] = getPeakRSS();
+    }
 }
 
 void TimeStats::recordTimerEnd( COMPILE_TIME_INTERVALS compileInterval )
@@ -594,6 +783,12 @@ void TimeStats::recordTimerEnd( COMPILE_TIME_INTERVALS compileInterval )
     IGC_ASSERT(compileInterval < MAX_COMPILE_TIME_INTERVALS);
     m_elapsedTime[ compileInterval ] += iSTD::GetTimestampCounter() - m_wallclockStart[ compileInterval ];
     m_hitCount[ compileInterval ]++;
+    if (m_MemEnabled)
+    {
+        // The process peak only ever grows, so what the interval adds to it
+        // is what the interval itself needed beyond earlier peaks.
+        m_memPeakGrowth[ compileInterval ] += getPeakRSS() - m_memPeakStart[ compileInterval ];
+    }
 }
 
 uint64_t TimeStats::getCompileTime( COMPILE_TIME_INTERVALS compileInterval ) const
@@ -610,6 +805,27 @@ uint64_t TimeStats::getCompileHit( COMPILE_TIME_INTERVALS compileInterval ) cons
     return m_hitCount[ compileInterval ];
 }
 
+void TimeStats::recordCounter( COMPILE_COUNTERS counter, uint64_t n )
+{
+    IGC_ASSERT(0 <= counter);
+    IGC_ASSERT(counter < MAX_COMPILE_COUNTERS);
+    m_counters[ counter ] += n;
+}
+
+uint64_t TimeStats::getCounter( COMPILE_COUNTERS counter ) const
+{
+    IGC_ASSERT(0 <= counter);
+    IGC_ASSERT(counter < MAX_COMPILE_COUNTERS);
+    return m_counters[ counter ];
+}
+
+uint64_t TimeStats::getMemPeakGrowth( COMPILE_TIME_INTERVALS compileInterval ) const
+{
+    IGC_ASSERT(0 <= compileInterval);
+    IGC_ASSERT(compileInterval < MAX_COMPILE_TIME_INTERVALS);
+    return m_memPeakGrowth[ compileInterval ];
+}
+
 void TimeStats::sumWith( const TimeStats* pOther )
 {
     // Add pOther's compile time's to us
@@ -617,42 +833,35 @@ void TimeStats::sumWith( const TimeStats* pOther )
     {
         m_elapsedTime[ i ] += pOther->m_elapsedTime[ i ];
         m_hitCount[ i ]    += pOther->m_hitCount[ i ];
+        m_memPeakGrowth[ i ] += pOther->m_memPeakGrowth[ i ];
+    }
+    for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+    {
+        m_counters[ i ] += pOther->m_counters[ i ];
+    }
+
+    if (m_visaMemPeak.size() < pOther->m_visaMemPeak.size())
+    {
+        m_visaMemPeak.resize(pOther->m_visaMemPeak.size());
+    }
+    for (size_t i = 0; i < pOther->m_visaMemPeak.size(); i++)
+    {
+        m_visaMemPeak[i] = std::max(m_visaMemPeak[i], pOther->m_visaMemPeak[i]);
     }
 
     m_totalShaderCount++;
 
     m_PassTotalTicks += pOther->m_PassTotalTicks;
 
-    if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
+    // Pass IDs are process wide, so the stats of the same pass line up
+    if (m_PassTimeStats.size() < pOther->m_PassTimeStats.size())
     {
-        if (m_PassTimeStatsMap.empty())
-        {
-            m_PassTimeStatsMap.insert(pOther->m_PassTimeStatsMap.begin(), pOther->m_PassTimeStatsMap.end());
-        }
-        else
-        {
-            std::map<std::string, PerPassTimeStat>::const_iterator fromIter;
-            std::map<std::string, PerPassTimeStat>::iterator toIter;
-
-            for (fromIter = pOther->m_PassTimeStatsMap.begin(); fromIter != pOther->m_PassTimeStatsMap.end(); fromIter++)
-            {
-                toIter = m_PassTimeStatsMap.find(fromIter->first);
-                if (toIter != m_PassTimeStatsMap.end())
-                {
-                    // If the pass is already included in the combined list, add the numbers
-                    toIter->second.PassHitCount += fromIter->second.PassHitCount;
-                    toIter->second.PassElapsedTime += fromIter->second.PassElapsedTime;
-                }
-                else
-                {
-                    // Add new pass from this run to the combined list
-                    PerPassTimeStat stat;
-                    stat.PassElapsedTime = fromIter->second.PassElapsedTime;
-                    stat.PassHitCount = fromIter->second.PassHitCount;
-                    m_PassTimeStatsMap.insert(std::pair<std::string, PerPassTimeStat>(fromIter->first, stat));
-                }
-            }
-        }
+        m_PassTimeStats.resize(pOther->m_PassTimeStats.size());
+    }
+    for (size_t i = 0; i < pOther->m_PassTimeStats.size(); i++)
+    {
+        m_PassTimeStats[i].PassHitCount += pOther->m_PassTimeStats[i].PassHitCount;
+        m_PassTimeStats[i].PassElapsedTime += pOther->m_PassTimeStats[i].PassElapsedTime;
     }
 }
 
@@ -709,6 +918,8 @@ void TimeStats::printSumTime() const
     }
 
     pp.printSumTimeTable(llvm::dbgs());
+    pp.printCounterTable(llvm::dbgs());
+    pp.printVISAMemTable(llvm::dbgs());
 }
 
 bool TimeStats::skipTimer( int i ) const
@@ -750,6 +961,10 @@ void TimeStats::printSumTimeCSV(const char* outputFile) const
                 fprintf(fileName, "%s,", g_cCompTimeIntervals[i] );
             }
         }
+        for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+        {
+            fprintf(fileName, "%s,", g_cCompCounters[i] );
+        }
         fprintf(fileName, "\n");
     }
 
@@ -757,7 +972,7 @@ void TimeStats::printSumTimeCSV(const char* outputFile) const
     {
         fprintf(fileName, "%s,%d,", IGC::Debug::GetShaderCorpusName(), m_totalShaderCount );
 
-        // print ticks
+        // print ticks, then the counters
         for (int i=0;i<MAX_COMPILE_TIME_INTERVALS;i++)
         {
             if( !skipTimer( i ) )
@@ -765,6 +980,10 @@ void TimeStats::printSumTimeCSV(const char* outputFile) const
                 fprintf(fileName, "%jd,", getCompileTime(static_cast<COMPILE_TIME_INTERVALS>(i)) );
             }
         }
+        for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+        {
+            fprintf(fileName, "%ju,", m_counters[i] );
+        }
         fprintf(fileName, "\n");
 
         if( !IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsCoarse, TIME_STATS_COARSE))
@@ -792,6 +1011,17 @@ void TimeStats::printSumTimeCSV(const char* outputFile) const
                 fprintf(fileName, "%ju,", m_hitCount[i] );
             }
             fprintf(fileName, "\n");
+
+            if (m_MemEnabled)
+            {
+                // print peak resident set size growth in bytes
+                fprintf(fileName, "peak rss growth,," );
+                for (int i=0;i<MAX_COMPILE_TIME_INTERVALS;i++)
+                {
+                    fprintf(fileName, "%ju,", m_memPeakGrowth[i] );
+                }
+                fprintf(fileName, "\n");
+            }
         }
 
         fclose(fileName);
@@ -802,7 +1032,7 @@ void TimeStats::printPerPassSumTimeCSV(const char* outputFile) const
 {
     IGC_ASSERT_MESSAGE(m_isPostProcessed, "Print functions should only be called on a Post-Processed TimeStats object");
 
-    if (m_PassTimeStatsMap.empty())
+    if (m_PassTimeStats.empty())
     {
         return;
     }
@@ -817,27 +1047,27 @@ void TimeStats::printPerPassSumTimeCSV(const char* outputFile) const
     }
 
     FILE* fileName = fopen(outputFile, "a");
-    std::map<std::string, PerPassTimeStat>::const_iterator iter;
 
+    const std::vector<unsigned> passIDs = getTimedPasses(m_PassTimeStats);
     if (!fileExist && fileName)
     {
         fprintf(fileName, "Frequency,%ju\n\n", m_freq);
         fprintf(fileName, "corpus name,passes count,Total,");
 
-        for (iter = m_PassTimeStatsMap.begin(); iter != m_PassTimeStatsMap.end(); iter++)
+        for (unsigned passID : passIDs)
         {
-            fprintf(fileName, "%s,", iter->first.c_str());
+            fprintf(fileName, "%s,", PassTimerRegistry::getName(passID));
         }
         fprintf(fileName, "\n");
     }
 
     if (fileName)
     {
-        fprintf(fileName, "%s,%d,%ju,", IGC::Debug::GetShaderCorpusName(), (int)m_PassTimeStatsMap.size(), m_PassTotalTicks);
+        fprintf(fileName, "%s,%d,%ju,", IGC::Debug::GetShaderCorpusName(), (int)passIDs.size(), m_PassTotalTicks);
 
-        for (iter = m_PassTimeStatsMap.begin(); iter != m_PassTimeStatsMap.end(); iter++)
+        for (unsigned passID : passIDs)
         {
-            fprintf(fileName, "%jd,", iter->second.PassElapsedTime);
+            fprintf(fileName, "%jd,", m_PassTimeStats[passID].PassElapsedTime);
         }
 
         fprintf(fileName, "\n");
@@ -845,45 +1075,25 @@ void TimeStats::printPerPassSumTimeCSV(const char* outputFile) const
     }
 }
 
-void TimeStats::recordPerPassTimerStart(std::string PassName)
+void TimeStats::recordPerPassTimerStart(unsigned passID)
 {
-    IGC_ASSERT(!PassName.empty());
-
-    std::map<std::string, PerPassTimeStat>::iterator iter = m_PassTimeStatsMap.find(PassName);
-    if (iter == m_PassTimeStatsMap.end())
+    if (passID >= m_PassTimeStats.size())
     {
-        PerPassTimeStat stat;
-        stat.PassElapsedTime = 0;
-        stat.PassHitCount = 0;
-        stat.PassClockStart = iSTD::GetTimestampCounter();
-
-        m_PassTimeStatsMap.insert(std::pair<std::string, PerPassTimeStat>(PassName, stat));
-    }
-    else
-    {
-        iter->second.PassClockStart = iSTD::GetTimestampCounter();
+        m_PassTimeStats.resize(passID + 1);
     }
+    m_PassTimeStats[passID].PassClockStart = iSTD::GetTimestampCounter();
 }
 
-void TimeStats::recordPerPassTimerEnd(std::string PassName)
+void TimeStats::recordPerPassTimerEnd(unsigned passID)
 {
-    IGC_ASSERT(!PassName.empty());
-
-    std::map<std::string, PerPassTimeStat>::iterator iter = m_PassTimeStatsMap.find(PassName);
+    IGC_ASSERT_MESSAGE(passID < m_PassTimeStats.size(), "Pass timer ended without being started");
 
-    if (iter == m_PassTimeStatsMap.end())
-    {
-        std::cerr << "Invalid Pass " << PassName << std::endl;
-    }
-    else
-    {
-        uint64_t start = iter->second.PassClockStart;
-        uint64_t elapsed = iSTD::GetTimestampCounter() - start;
+    PerPassTimeStat& stat = m_PassTimeStats[passID];
+    uint64_t elapsed = iSTD::GetTimestampCounter() - stat.PassClockStart;
 
-        iter->second.PassHitCount += 1;
-        iter->second.PassElapsedTime += elapsed;
-        m_PassTotalTicks += elapsed;
-    }
+    stat.PassHitCount += 1;
+    stat.PassElapsedTime += elapsed;
+    m_PassTotalTicks += elapsed;
 }
 
 namespace {
@@ -927,18 +1137,27 @@ void TimeStats::printSumTimeTable( llvm::raw_ostream & OS ) const
     const unsigned secsCol  = ticksCol + colWidth + 2;   //<! Location of the first character of the seconds column
     const unsigned percCol  =  secsCol + colWidth + 2;   //<! Location of the first character of the percent column
     const unsigned hitCol   =  percCol + colWidth + 2;   //<! Location of the first character of the hit column
+    const unsigned peakCol  =   hitCol + colWidth + 2;   //<! Location of the first character of the peak rss growth column
 
     // table header
     FS.PadToColumn(ticksCol) << "ticks";
     FS.PadToColumn( secsCol) << "seconds";
     FS.PadToColumn( percCol) << "percent";
     FS.PadToColumn(  hitCol) << "hits";
+    if (m_MemEnabled)
+    {
+        FS.PadToColumn(peakCol) << "peak +MB";
+    }
     FS << "\n";
     const std::string bar(colWidth+1,'-');
     FS.PadToColumn(ticksCol) << bar;
     FS.PadToColumn( secsCol) << bar;
     FS.PadToColumn( percCol) << bar;
     FS.PadToColumn(  hitCol) << bar;
+    if (m_MemEnabled)
+    {
+        FS.PadToColumn(peakCol) << bar;
+    }
     FS << "\n";
 
     // table body
@@ -962,6 +1181,10 @@ void TimeStats::printSumTimeTable( llvm::raw_ostream & OS ) const
                     FS.PadToColumn(secsCol) << str(intervalTicks / (double)m_freq, colWidth, 4);
                     FS.PadToColumn(percCol) << str(intervalTicks / (double)getCompileTime(TIME_TOTAL) * 100.0, colWidth, 2);
                     FS.PadToColumn(percCol) << str(m_hitCount[i], colWidth);
+                    if (m_MemEnabled)
+                    {
+                        FS.PadToColumn(peakCol) << str(m_memPeakGrowth[i] / (1024.0 * 1024.0), colWidth, 2);
+                    }
                     FS << "\n";
                 }
             }
@@ -990,6 +1213,10 @@ void TimeStats::printSumTimeTable( llvm::raw_ostream & OS ) const
                     FS.PadToColumn(secsCol) << str(intervalTicks / (double)m_freq, colWidth, 4);
                     FS.PadToColumn(percCol) << str(intervalTicks / (double)getCompileTime(TIME_TOTAL) * 100.0, colWidth, 2);
                     FS.PadToColumn(percCol) << str(m_hitCount[i], colWidth);
+                    if (m_MemEnabled)
+                    {
+                        FS.PadToColumn(peakCol) << str(m_memPeakGrowth[i] / (1024.0 * 1024.0), colWidth, 2);
+                    }
                     FS << "\n";
                 }
             }
@@ -1001,9 +1228,71 @@ void TimeStats::printSumTimeTable( llvm::raw_ostream & OS ) const
     OS.flush();
 }
 
+void TimeStats::printCounterTable(llvm::raw_ostream& OS) const
+{
+    if (std::all_of(std::begin(m_counters), std::end(m_counters),
+        [](uint64_t count) { return count == 0; }))
+    {
+        return;
+    }
+
+    llvm::formatted_raw_ostream FS(OS);
+
+    const unsigned colWidth = 8;                      //<! Width of each of the data columns
+    const unsigned startCol = 4;                      //<! Spacing to the left of the whole table
+    const unsigned countCol = 50;                     //<! Location of the first character of the count column
+
+    FS << "Counters:\n";
+    FS.PadToColumn(countCol) << "count";
+    FS << "\n";
+    FS.PadToColumn(countCol) << std::string(colWidth + 1, '-');
+    FS << "\n";
+    for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+    {
+        if (m_counters[i])
+        {
+            FS.PadToColumn(startCol) << g_cCompCounters[i];
+            FS.PadToColumn(countCol) << str(m_counters[i], colWidth);
+            FS << "\n";
+        }
+    }
+    FS << "\n";
+    FS.flush();
+    OS.flush();
+}
+
+void TimeStats::printVISAMemTable(llvm::raw_ostream& OS) const
+{
+    if (!m_MemEnabled || m_visaMemPeak.empty())
+    {
+        return;
+    }
+
+    llvm::formatted_raw_ostream FS(OS);
+
+    const unsigned colWidth = 8;                      //<! Width of each of the data columns
+    const unsigned startCol = 4;                      //<! Spacing to the left of the whole table
+    const unsigned peakCol = 50;                      //<! Location of the first character of the peak column
+
+    FS << "vISA memory owners:\n";
+    FS.PadToColumn(peakCol) << "peak MB";
+    FS << "\n";
+    FS.PadToColumn(peakCol) << std::string(colWidth + 1, '-');
+    FS << "\n";
+    for (unsigned i = 0; i < m_visaMemPeak.size(); i++)
+    {
+        FS.PadToColumn(startCol) << getMemOwnerName(i);
+        FS.PadToColumn(peakCol) << str(m_visaMemPeak[i] / (1024.0 * 1024.0), colWidth, 2);
+        FS << "\n";
+    }
+    FS << "\n";
+    FS.flush();
+    OS.flush();
+}
+
 void TimeStats::printPerPassSumTime(llvm::raw_ostream& OS) const
 {
-    if (m_PassTimeStatsMap.empty())
+    if (m_PassTimeStats.empty())
     {
         return;
     }
@@ -1011,7 +1300,7 @@ void TimeStats::printPerPassSumTime(llvm::raw_ostream& OS) const
     llvm::formatted_raw_ostream FS(OS);
 
     FS << "\n";
-    FS << "PassesCount:  " << m_PassTimeStatsMap.size() << " IGC/LLVM passes\n";
+    FS << "PassesCount:  " << m_PassTimeStats.size() << " IGC/LLVM passes\n";
     FS << "Total Ticks:  " << m_PassTotalTicks << " ticks\n";
 
     const unsigned colWidth = 8;                      //<! Width of each of the data columns
@@ -1031,17 +1320,17 @@ void TimeStats::printPerPassSumTime(llvm::raw_ostream& OS) const
     FS.PadToColumn(hitCol) << bar;
     FS << "\n";
 
-    PerPassTimeStat stat;
-    uint64_t ticks = 0;
-    std::map<std::string, PerPassTimeStat>::const_iterator iter;
-
-    for (iter = m_PassTimeStatsMap.begin(); iter != m_PassTimeStatsMap.end(); iter++)
+    for (unsigned i = 0; i < m_PassTimeStats.size(); i++)
     {
-        stat = iter->second;
-        ticks = stat.PassElapsedTime;
+        const PerPassTimeStat& stat = m_PassTimeStats[i];
+        if (stat.PassHitCount == 0)
+        {
+            continue;
+        }
+        uint64_t ticks = stat.PassElapsedTime;
 
         // pass ticks % hit
-        FS.PadToColumn(startCol) << iter->first.substr(0, ticksCol - startCol - 1);
+        FS.PadToColumn(startCol) << llvm::StringRef(PassTimerRegistry::getName(i)).substr(0, ticksCol - startCol - 1);
         FS.PadToColumn(ticksCol) << str(ticks, colWidth);
         FS.PadToColumn(percCol) << str(ticks / (double)m_PassTotalTicks * 100.0, colWidth, 2);
         FS.PadToColumn(percCol) << str(stat.PassHitCount, colWidth);
@@ -1086,6 +1375,10 @@ void TimeStats::printTimeCSV( std::string const& corpusName ) const
                 fprintf(fileName, "%s,", g_cCompTimeIntervals[i] );
             }
         }
+        for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+        {
+            fprintf(fileName, "%s,", g_cCompCounters[i] );
+        }
         fprintf(fileName, "\n");
     }
 
@@ -1100,6 +1393,10 @@ void TimeStats::printTimeCSV( std::string const& corpusName ) const
                 fprintf(fileName, "%jd,", getCompileTime(interval));
             }
         }
+        for (int i = 0; i < MAX_COMPILE_COUNTERS; i++)
+        {
+            fprintf(fileName, "%ju,", m_counters[i]);
+        }
 
         fprintf(fileName, "\n");
         fclose(fileName);
@@ -1111,7 +1408,7 @@ void TimeStats::printPerPassTimeCSV(std::string const& corpusName) const
 {
     IGC_ASSERT_MESSAGE(m_isPostProcessed, "Print functions should only be called on a Post-Processed TimeStats object");
 
-    if (m_PassTimeStatsMap.empty())
+    if (m_PassTimeStats.empty())
     {
         return;
     }
@@ -1134,27 +1431,26 @@ void TimeStats::printPerPassTimeCSV(std::string const& corpusName) const
 
     FILE* fileName = fopen(outputFile, "a");
 
+    const std::vector<unsigned> passIDs = getTimedPasses(m_PassTimeStats);
     if (!fileExist && fileName)
     {
         fprintf(fileName, "Frequency:%ju,", m_freq);
 
-        std::map<std::string, PerPassTimeStat>::const_iterator iter;
         fprintf(fileName, "Passes Count,Total,");
-        for (iter = m_PassTimeStatsMap.begin(); iter != m_PassTimeStatsMap.end(); iter++)
+        for (unsigned passID : passIDs)
         {
-            fprintf(fileName, "%s,", iter->first.c_str());
+            fprintf(fileName, "%s,", PassTimerRegistry::getName(passID));
         }
         fprintf(fileName, "\n");
     }
 
     if (fileName)
     {
-        fprintf(fileName, "%s.isa,%d,%ju,", corpusName.c_str(), (int)m_PassTimeStatsMap.size(), m_PassTotalTicks);
-        std::map<std::string, PerPassTimeStat>::const_iterator iter;
+        fprintf(fileName, "%s.isa,%d,%ju,", corpusName.c_str(), (int)passIDs.size(), m_PassTotalTicks);
 
-        for (iter = m_PassTimeStatsMap.begin(); iter != m_PassTimeStatsMap.end(); iter++)
+        for (unsigned passID : passIDs)
         {
-            fprintf(fileName, "%jd,", iter->second.PassElapsedTime);
+            fprintf(fileName, "%jd,", m_PassTimeStats[passID].PassElapsedTime);
         }
 
         fprintf(fileName, "\n");
@@ -1162,6 +1458,49 @@ void TimeStats::printPerPassTimeCSV(std::string const& corpusName) const
     }
 }
 
+void TimeStats::printPerPassTime(ShaderType type, ShaderHash hash, void* context) const
+{
+    const char* outputFile = IGC_GET_REGKEYSTRING(TimeStatsPerPassFile);
+    if (!m_PerPassEnabled || m_PassTimeStats.empty() || outputFile == nullptr || outputFile[0] == '\0')
+    {
+        return;
+    }
+
+    std::string shaderName = IGC::Debug::DumpName(IGC::Debug::GetShaderOutputName()).Type(type).Hash(hash).StagedInfo(context).str();
+    if (shaderName.find_last_of("\\/") != std::string::npos)
+    {
+        shaderName = shaderName.substr(shaderName.find_last_of("\\/") + 1);
+    }
+
+    // One record per shader and pass so that files from runs with different
+    // pipelines can be concatenated and aggregated by any CSV tool
+    std::lock_guard<std::mutex> guard(g_perPassFileLock);
+    FILE* fileName = fopen(outputFile, "a");
+    if (!fileName)
+    {
+        return;
+    }
+    fseek(fileName, 0, SEEK_END);
+    if (ftell(fileName) == 0)
+    {
+        fprintf(fileName, "shader,pass,hits,ns\n");
+    }
+    for (unsigned i = 0; i < m_PassTimeStats.size(); i++)
+    {
+        const PerPassTimeStat& stat = m_PassTimeStats[i];
+        if (stat.PassHitCount == 0)
+        {
+            continue;
+        }
+        fprintf(fileName, "%s,%s,%ju,%ju\n",
+            shaderName.c_str(),
+            PassTimerRegistry::getName(i),
+            stat.PassHitCount,
+            (uint64_t)(stat.PassElapsedTime / (double)m_freq * 1000000000.0));
+    }
+    fclose(fileName);
+}
+
 TimeStats TimeStats::postProcess() const
 {
     TimeStats copy(*this);
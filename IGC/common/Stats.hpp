@@ -45,6 +45,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace llvm
 {
@@ -206,6 +207,15 @@ enum COMPILE_TIME_INTERVALS
 
 extern const char* g_cCompTimeIntervals[MAX_COMPILE_TIME_INTERVALS+1];
 
+enum COMPILE_COUNTERS
+{
+#define DEFINE_COUNTER_STAT( enumName, stringName ) enumName,
+#include "counterStats.def"
+#undef DEFINE_COUNTER_STAT
+};
+
+extern const char* g_cCompCounters[MAX_COMPILE_COUNTERS+1];
+
 std::string str( COMPILE_TIME_INTERVALS cti );
 COMPILE_TIME_INTERVALS interval(std::string const& str);
 bool isVISATimer( COMPILE_TIME_INTERVALS cti );
@@ -217,11 +227,23 @@ int parentIntervalDepth( COMPILE_TIME_INTERVALS cti );
 
 #if GET_TIME_STATS
 
+/// Process-wide IDs of the per-pass timers. A pass is registered once when it
+/// is added to a pass manager; timing it then only indexes a flat array.
+class PassTimerRegistry
+{
+public:
+    /// Get the ID of name, registering it on first use
+    static unsigned getID(const std::string& name);
+    static const char* getName(unsigned passID);
+    /// Number of IDs registered so far
+    static unsigned size();
+};
+
 struct PerPassTimeStat
 {
     uint64_t PassClockStart = 0;
     uint64_t PassElapsedTime = 0;
-    int PassHitCount = 0;
+    uint64_t PassHitCount = 0;
 };
 
 class TimeStats
@@ -233,6 +255,19 @@ public:
     /// Capture the VISA timer values for the most recent call to VISABuilder::compile()
     void recordVISATimers();
 
+    /// VISA timer values of one call to VISABuilder::compile()
+    struct VISATimerValues
+    {
+        std::vector<int64_t> ticks;
+        std::vector<unsigned int> hits;
+        std::vector<uint64_t> memPeaks;
+    };
+    /// VISA timers are per thread; save the calling thread's values so that
+    /// a compile run on a worker thread can be recorded once it is joined
+    static void captureVISATimers(VISATimerValues& values);
+    /// Record VISA timer values saved by captureVISATimers()
+    void recordVISATimers(const VISATimerValues& values);
+
     /// Mark that a particular timer has started timing
     void recordTimerStart( COMPILE_TIME_INTERVALS compileInterval );
     /// Mark that a particular timer has finished timing
@@ -243,6 +278,11 @@ public:
     /// Get the number of times a particular timer was triggered
     uint64_t getCompileHit( COMPILE_TIME_INTERVALS compileInterval ) const;
 
+    /// Add n to a particular event counter
+    void recordCounter( COMPILE_COUNTERS counter, uint64_t n );
+    /// Get the value of a particular event counter
+    uint64_t getCounter( COMPILE_COUNTERS counter ) const;
+
     /// Print the accumulated times for a single shader
     void printTime( ShaderType type, ShaderHash hash, void* context) const;
     void printTime( ShaderType type, ShaderHash hash ) const;
@@ -250,10 +290,17 @@ public:
     void printSumTime() const;
     /// Print the times for all passes
     void printPerPassSumTime( llvm::raw_ostream& OS ) const;
+    /// Append the per-pass times of a single shader to TimeStatsPerPassFile
+    void printPerPassTime( ShaderType type, ShaderHash hash, void* context = nullptr ) const;
 
     /// Add other's statistics to this
     void sumWith( const TimeStats* pOther );
 
+    /// True if memory is accounted along with the timers (EnableMemAccounting)
+    bool isMemEnabled() const { return m_MemEnabled; }
+    /// Get how much a particular timer's intervals raised the process peak resident set size
+    uint64_t getMemPeakGrowth( COMPILE_TIME_INTERVALS compileInterval ) const;
+
     /// Get the time elapsed in nanoseconds
     uint64_t getCompileTimeNS(COMPILE_TIME_INTERVALS compileInterval) const
     {
@@ -268,8 +315,11 @@ public:
                 (double)m_freq * 1000.0;
     }
 
-    void recordPerPassTimerStart(std::string PassName);
-    void recordPerPassTimerEnd(std::string PassName);
+    /// True if passes are timed for this compile: always with
+    /// DumpTimeStatsPerPass, else for TimeStatsPerPassSampleRate percent of them
+    bool isPerPassEnabled() const { return m_PerPassEnabled; }
+    void recordPerPassTimerStart(unsigned passID);
+    void recordPerPassTimerEnd(unsigned passID);
 
 private:
     /// \deprecated Print aggregate times for multiple shaders in csv format
@@ -283,6 +333,10 @@ private:
     void printTimeCSV( std::string const& corpusName ) const;
     void printPerPassTimeCSV( std::string const& corpusName ) const;
     void printPerPassSumTimeCSV(const char* fileName) const;
+    /// Print the peak bytes of the vISA memory owners
+    void printVISAMemTable( llvm::raw_ostream& OS ) const;
+    /// Print the event counters that were bumped
+    void printCounterTable( llvm::raw_ostream& OS ) const;
 
     // Return a copy of *this, with Unaccounted timer values filled in
     TimeStats postProcess() const;
@@ -292,11 +346,20 @@ private:
     uint64_t m_wallclockStart[MAX_COMPILE_TIME_INTERVALS];   //!< Most recent starting time of the timer
     uint64_t m_elapsedTime[MAX_COMPILE_TIME_INTERVALS];      //!< Running total of time measured by the timer
     uint64_t m_hitCount[MAX_COMPILE_TIME_INTERVALS];         //!< Number of times a timer was started
+    uint64_t m_counters[MAX_COMPILE_COUNTERS];               //!< Running totals of the event counters
     uint64_t m_freq;
 
-    // Per Pass timestats
+    // Memory accounting
+    bool     m_MemEnabled;
+    uint64_t m_memPeakStart[MAX_COMPILE_TIME_INTERVALS];    //!< Process peak resident set size when the timer was last started
+    uint64_t m_memPeakGrowth[MAX_COMPILE_TIME_INTERVALS];   //!< Running total of the process peak resident set size growth measured by the timer
+    std::vector<uint64_t> m_visaMemPeak;                    //!< Peak bytes per vISA memory owner
+
+    // Per Pass timestats, indexed by PassTimerRegistry ID
+    bool m_PerPassEnabled;
+    bool m_PerPassSampled;                                  //!< Has this compile been offered to TimeStatsPerPassSampleRate yet?
     uint64_t m_PassTotalTicks;
-    std::map<std::string, PerPassTimeStat> m_PassTimeStatsMap;
+    std::vector<PerPassTimeStat> m_PassTimeStats;
 };
 
 #define COMPILER_TIME_GETNS(pointer, timerName) \
@@ -320,20 +383,29 @@ private:
         } \
     } while (0)
 
-#define COMPILER_TIME_PASS_START( pointer, name ) \
+#define COMPILER_COUNTER_ADD( pointer, counter, n ) \
+    do \
+    { \
+        if( (pointer) && (pointer)->m_compilerTimeStats ) \
+        { \
+                (pointer)->m_compilerTimeStats->recordCounter( counter, n ); \
+        } \
+    } while (0)
+
+#define COMPILER_TIME_PASS_START( pointer, passID ) \
     do \
     { \
         if( (pointer) && (pointer)->m_compilerTimeStats ) \
         { \
-                (pointer)->m_compilerTimeStats->recordPerPassTimerStart( name );  \
+                (pointer)->m_compilerTimeStats->recordPerPassTimerStart( passID );  \
         } \
     } while (0)
-#define COMPILER_TIME_PASS_END( pointer, name ) \
+#define COMPILER_TIME_PASS_END( pointer, passID ) \
     do \
     { \
         if( (pointer) && (pointer)->m_compilerTimeStats ) \
         { \
-                (pointer)->m_compilerTimeStats->recordPerPassTimerEnd( name ); \
+                (pointer)->m_compilerTimeStats->recordPerPassTimerEnd( passID ); \
         } \
     } while (0)
 
@@ -449,6 +521,7 @@ private:
                 (pointer)->m_compilerTimeStats->printTime( \
                     __VA_ARGS__ ); \
             } \
+            (pointer)->m_compilerTimeStats->printPerPassTime( __VA_ARGS__ ); \
         } \
     } while (0)
 
@@ -456,6 +529,7 @@ private:
 
 #   define COMPILER_TIME_START( pointer, value ) do { } while (0)
 #   define COMPILER_TIME_END( pointer, value ) do { } while (0)
+#   define COMPILER_COUNTER_ADD( pointer, counter, n ) do { } while (0)
 #   define COMPILER_TIME_PRINT( pointer, shaderType, shaderhash ) do { } while (0)
 #   define COMPILER_TIME_SUM( pointerDst, pointerSrc ) do { } while (0)
 #   define COMPILER_TIME_SUM2( pointerDst, pointerSrc ) do { } while (0)
@@ -0,0 +1,396 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// Compile-time tracing shared by IGC and vISA.
+//
+// Every thread records complete events (name, category, begin and end time)
+// into its own fixed-size ring buffer without taking any lock; once a ring is
+// full its oldest events are overwritten. When a thread exits its ring goes
+// back to a free list and is reused by the next thread that records, so the
+// number of rings is bounded by the number of threads recording at once
+// rather than by the number of threads ever started. While tracing is
+// disabled recording costs a single relaxed load.
+//
+// flush() appends the events recorded since the previous flush to the trace
+// file in Chrome's JSON array format, which chrome://tracing and Perfetto
+// open as is (the closing bracket is optional in that format).
+//
+// Event names, categories and argument names are not copied: pass string
+// literals or strings returned by intern().
+namespace CompileTrace
+{
+    inline uint64_t now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        const char* detail;     // optional string argument
+        const char* argName;    // optional numeric argument
+        uint64_t arg;
+        uint64_t begin;         // ns
+        uint64_t end;           // ns
+    };
+
+    // Single producer (the owning thread), single consumer (flush() under
+    // the tracer lock).
+    class ThreadBuffer
+    {
+    public:
+        static const uint64_t Capacity = 1 << 14;
+        static const unsigned MaxDepth = 64;
+
+        explicit ThreadBuffer(uint32_t tid) : m_tid(tid), m_events(new Event[Capacity]) {}
+
+        void push(const Event& e)
+        {
+            uint64_t head = m_head.load(std::memory_order_relaxed);
+            m_events[head & (Capacity - 1)] = e;
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        // Begin times of events opened with Tracer::beginEvent().
+        uint64_t m_stack[MaxDepth];
+        unsigned m_depth = 0;
+
+    private:
+        friend class Tracer;
+
+        const uint32_t m_tid;
+        std::unique_ptr<Event[]> m_events;
+        std::atomic<uint64_t> m_head{ 0 };
+        uint64_t m_flushed = 0;
+    };
+
+    class Tracer
+    {
+    public:
+        static Tracer& get()
+        {
+            // Never destroyed: worker threads may still record at exit.
+            static Tracer* T = new Tracer();
+            return *T;
+        }
+
+        bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        // Start recording; events are appended to path on flush(). The first
+        // path set in a process wins.
+        void enable(const char* path)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (m_path.empty())
+            {
+                m_path = path;
+            }
+            m_enabled.store(true, std::memory_order_relaxed);
+        }
+
+        void record(const char* name, const char* category, uint64_t begin, uint64_t end,
+            const char* argName = nullptr, uint64_t arg = 0, const char* detail = nullptr)
+        {
+            Event e = { name, category, detail, argName, arg, begin, end };
+            threadBuffer().push(e);
+        }
+
+        // Open an event on this thread; the matching endEvent() records it.
+        // Used where begin and end are not in one C++ scope, e.g. passes.
+        void beginEvent()
+        {
+            ThreadBuffer& TB = threadBuffer();
+            if (TB.m_depth < ThreadBuffer::MaxDepth)
+            {
+                TB.m_stack[TB.m_depth] = now();
+            }
+            ++TB.m_depth;
+        }
+
+        void endEvent(const char* name, const char* category,
+            const char* argName = nullptr, uint64_t arg = 0, const char* detail = nullptr)
+        {
+            ThreadBuffer& TB = threadBuffer();
+            if (TB.m_depth == 0)
+            {
+                return;
+            }
+            --TB.m_depth;
+            if (TB.m_depth < ThreadBuffer::MaxDepth)
+            {
+                Event e = { name, category, detail, argName, arg, TB.m_stack[TB.m_depth], now() };
+                TB.push(e);
+            }
+        }
+
+        // Return a copy of str that lives as long as the tracer.
+        const char* intern(const std::string& str)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            return m_strings.insert(str).first->c_str();
+        }
+
+        void flush()
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (m_path.empty())
+            {
+                return;
+            }
+
+            FILE* f = fopen(m_path.c_str(), "ab");
+            if (!f)
+            {
+                return;
+            }
+            fseek(f, 0, SEEK_END);
+            if (ftell(f) == 0)
+            {
+                fputs("[\n", f);
+            }
+
+            std::vector<Event> events;
+            for (auto& TB : m_buffers)
+            {
+                uint64_t head = TB->m_head.load(std::memory_order_acquire);
+                uint64_t first = std::max(TB->m_flushed,
+                    head > ThreadBuffer::Capacity ? head - ThreadBuffer::Capacity : 0);
+                events.clear();
+                for (uint64_t i = first; i < head; ++i)
+                {
+                    events.push_back(TB->m_events[i & (ThreadBuffer::Capacity - 1)]);
+                }
+                // Drop the events the owner may have overwritten meanwhile,
+                // seqlock style: the fence orders the copies above before the
+                // head reload. The owner writes slot newHead before publishing
+                // newHead + 1, and that slot aliases index newHead - Capacity,
+                // so that index may be half-written as well.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                uint64_t newHead = TB->m_head.load(std::memory_order_relaxed);
+                uint64_t valid = newHead + 1 > ThreadBuffer::Capacity ?
+                    newHead + 1 - ThreadBuffer::Capacity : 0;
+                for (uint64_t i = first; i < head; ++i)
+                {
+                    if (i >= valid)
+                    {
+                        write(f, events[i - first], TB->m_tid);
+                    }
+                }
+                TB->m_flushed = head;
+            }
+            fclose(f);
+        }
+
+    private:
+        Tracer() : m_pid(getPid()) {}
+
+        // Returns the thread's ring to the free list when the thread exits.
+        // Events it has not flushed yet stay in the ring and are written by
+        // the next flush.
+        struct BufferOwner
+        {
+            ThreadBuffer* TB = nullptr;
+            ~BufferOwner()
+            {
+                if (TB)
+                {
+                    Tracer::get().releaseBuffer(TB);
+                }
+            }
+        };
+
+        ThreadBuffer& threadBuffer()
+        {
+            static thread_local BufferOwner Owner;
+            if (!Owner.TB)
+            {
+                Owner.TB = acquireBuffer();
+            }
+            return *Owner.TB;
+        }
+
+        // Threads that reuse a ring also reuse its trace tid; they never
+        // overlap in time, so their events don't nest incorrectly.
+        ThreadBuffer* acquireBuffer()
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            if (!m_freeBuffers.empty())
+            {
+                ThreadBuffer* TB = m_freeBuffers.back();
+                m_freeBuffers.pop_back();
+                return TB;
+            }
+            m_buffers.emplace_back(new ThreadBuffer((uint32_t)m_buffers.size() + 1));
+            return m_buffers.back().get();
+        }
+
+        void releaseBuffer(ThreadBuffer* TB)
+        {
+            // Drop events the exiting thread opened but never closed.
+            TB->m_depth = 0;
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_freeBuffers.push_back(TB);
+        }
+
+        static unsigned getPid()
+        {
+#ifdef _WIN32
+            return (unsigned)_getpid();
+#else
+            return (unsigned)getpid();
+#endif
+        }
+
+        static void writeString(FILE* f, const char* str)
+        {
+            fputc('"', f);
+            for (const char* c = str; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    fputc('\\', f);
+                    fputc(*c, f);
+                }
+                else if ((unsigned char)*c < 0x20)
+                {
+                    fprintf(f, "\\u%04x", (unsigned)(unsigned char)*c);
+                }
+                else
+                {
+                    fputc(*c, f);
+                }
+            }
+            fputc('"', f);
+        }
+
+        void write(FILE* f, const Event& e, uint32_t tid) const
+        {
+            fputs("{\"name\":", f);
+            writeString(f, e.name);
+            fputs(",\"cat\":", f);
+            writeString(f, e.category);
+            fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u",
+                e.begin / 1000.0, (e.end - e.begin) / 1000.0, m_pid, tid);
+            if (e.argName || e.detail)
+            {
+                fputs(",\"args\":{", f);
+                if (e.argName)
+                {
+                    writeString(f, e.argName);
+                    fprintf(f, ":%llu", (unsigned long long)e.arg);
+                }
+                if (e.detail)
+                {
+                    fputs(e.argName ? ",\"detail\":" : "\"detail\":", f);
+                    writeString(f, e.detail);
+                }
+                fputc('}', f);
+            }
+            fputs("},\n", f);
+        }
+
+        std::atomic<bool> m_enabled{ false };
+        const unsigned m_pid;
+        std::mutex m_lock;
+        std::string m_path;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+        std::vector<ThreadBuffer*> m_freeBuffers;
+        std::unordered_set<std::string> m_strings;
+    };
+
+    inline bool isEnabled()
+    {
+        return Tracer::get().isEnabled();
+    }
+
+    // Flushes the trace when leaving the enclosing scope, e.g. a build.
+    class FlushScope
+    {
+    public:
+        FlushScope() {}
+        ~FlushScope()
+        {
+            if (isEnabled())
+            {
+                Tracer::get().flush();
+            }
+        }
+
+        FlushScope(const FlushScope&) = delete;
+        FlushScope& operator=(const FlushScope&) = delete;
+    };
+
+    // Records the enclosing C++ scope as one event.
+    class Scope
+    {
+    public:
+        Scope(const char* name, const char* category,
+            const char* argName = nullptr, uint64_t arg = 0, const char* detail = nullptr)
+            : m_name(name), m_category(category), m_detail(detail), m_argName(argName), m_arg(arg),
+            m_begin(isEnabled() ? now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (m_begin)
+            {
+                Tracer::get().record(m_name, m_category, m_begin, now(), m_argName, m_arg, m_detail);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_category;
+        const char* m_detail;
+        const char* m_argName;
+        uint64_t m_arg;
+        uint64_t m_begin;
+    };
+} // namespace CompileTrace
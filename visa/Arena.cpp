@@ -27,40 +27,182 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Arena.h"
 
 #ifdef COLLECT_ALLOCATION_STATS
-int numAllocations = 0;
-int numMallocCalls = 0;
-int totalAllocSize = 0;
-int totalMallocSize = 0;
-int numMemManagers = 0;
-int maxArenaLength = 0;
-int currentMallocSize = 0;
+std::atomic<int> numAllocations(0);
+std::atomic<int> numMallocCalls(0);
+std::atomic<int> totalAllocSize(0);
+std::atomic<int> totalMallocSize(0);
+std::atomic<int> numMemManagers(0);
+std::atomic<int> maxArenaLength(0);
+std::atomic<int> currentMallocSize(0);
 #endif
 using namespace vISA;
 
+namespace
+{
+    // Free arena chunks of the calling thread, one list per power-of-two
+    // data size. Only chunks whose data size is exactly one of the classes
+    // are pooled; other sizes are allocated and freed as they are, so that
+    // no arena is grown to fit a class.
+    struct ArenaChunkPool
+    {
+        static const unsigned minClassLog2 = 10;
+        static const unsigned maxClassLog2 = 20;
+        static const unsigned numClasses = maxClassLog2 - minClassLog2 + 1;
+        // Bound on the memory a thread keeps cached
+        static const size_t maxPooledBytes = 8 * 1024 * 1024;
+
+        unsigned char* freeChunks[numClasses] = {};
+        size_t pooledBytes = 0;
+
+        ~ArenaChunkPool();
+    };
+
+    // thread_local rather than _THREAD, since the pool frees its chunks
+    // when the thread exits
+    thread_local bool chunkPoolDestroyed = false;
+    thread_local ArenaChunkPool chunkPool;
+
+    // The pool of the calling thread, or null once it has been destroyed:
+    // arenas freed by other thread_local destructors are freed directly.
+    ArenaChunkPool* getChunkPool()
+    {
+        return chunkPoolDestroyed ? nullptr : &chunkPool;
+    }
+
+    ArenaChunkPool::~ArenaChunkPool()
+    {
+        chunkPoolDestroyed = true;
+        for (unsigned char*& chunk : freeChunks)
+        {
+            while (chunk)
+            {
+                unsigned char* next = *(unsigned char**)chunk;
+                delete [] chunk;
+                chunk = next;
+            }
+        }
+    }
+
+    // Size class of an arena data size, or numClasses if it is not pooled.
+    unsigned getChunkClass(size_t arenaDataSize)
+    {
+        for (unsigned i = 0; i < ArenaChunkPool::numClasses; i++)
+        {
+            if (arenaDataSize == (size_t)1 << (i + ArenaChunkPool::minClassLog2))
+            {
+                return i;
+            }
+        }
+        return ArenaChunkPool::numClasses;
+    }
+}
+
 void*
 ArenaHeader::AllocSpace(size_t size, size_t al)
 {
     assert(DefaultAlign(size_t(_nextByte)) == size_t(_nextByte));
 
-    void* allocSpace = (void*) AlignAddr((size_t) _nextByte, al);
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    // Bump from the aligned address, so that padding for alignments above
+    // the default is accounted for.
+    size_t padding = AlignAddr((size_t) _nextByte, al) - (size_t) _nextByte;
+    size = DefaultAlign(size);  // round up size so that next address is at least max aligned
 
-    if (size)
+    if (padding + size > (size_t)(_lastByte - _nextByte))
     {
-        size = DefaultAlign(size);  // round up size so that next address is at least max aligned
+        return 0;
+    }
 
-        if (_nextByte + size <= _lastByte) {
-            _nextByte += size;
-        }
-        else {
-            allocSpace = 0;
+    void* allocSpace = _nextByte + padding;
+    _nextByte += padding + size;
+    return allocSpace;
+}
+
+unsigned char*
+ArenaManager::AllocChunk(size_t arenaDataSize)
+{
+    unsigned chunkClass = getChunkClass(arenaDataSize);
+    if (chunkClass < ArenaChunkPool::numClasses)
+    {
+        ArenaChunkPool* pool = getChunkPool();
+        if (pool && pool->freeChunks[chunkClass])
+        {
+            unsigned char* chunk = pool->freeChunks[chunkClass];
+            pool->freeChunks[chunkClass] = *(unsigned char**)chunk;
+            pool->pooledBytes -= arenaDataSize;
+            return chunk;
         }
     }
-    else
+
+#ifdef COLLECT_ALLOCATION_STATS
+    numMallocCalls++;
+    totalMallocSize += (int)arenaDataSize;
+#endif
+    return new unsigned char[ArenaHeader::GetArenaSize(arenaDataSize)];
+}
+
+void
+ArenaManager::FreeChunk(unsigned char* chunk, size_t arenaDataSize)
+{
+    ArenaChunkPool* pool = getChunkPool();
+    unsigned chunkClass = getChunkClass(arenaDataSize);
+    if (pool && chunkClass < ArenaChunkPool::numClasses &&
+        pool->pooledBytes + arenaDataSize <= ArenaChunkPool::maxPooledBytes)
     {
-        allocSpace = 0;
+        *(unsigned char**)chunk = pool->freeChunks[chunkClass];
+        pool->freeChunks[chunkClass] = chunk;
+        pool->pooledBytes += arenaDataSize;
+        return;
     }
+    delete [] chunk;
+}
 
-    return allocSpace;
+ArenaHeader*
+ArenaManager::CreateArena(size_t size)
+{
+    size_t arenaDataSize = (size > _defaultArenaSize) ? size : _defaultArenaSize;
+    arenaDataSize = ArenaHeader::DefaultAlign(arenaDataSize);
+    unsigned char * arena = AllocChunk(arenaDataSize);
+
+    // An active MemOwnerScope takes precedence over the manager's owner
+    MemOwner owner = MemOwnerScope::current();
+    if (owner == MemOwner::Other)
+    {
+        owner = _owner;
+    }
+    MemAccounting::add(owner, ArenaHeader::GetArenaSize(arenaDataSize));
+
+    ArenaHeader* newArena = new (arena)ArenaHeader(arenaDataSize, _arenas, owner);
+    // Add new arena to the head of queue
+    if (_arenas != NULL)
+    {
+        newArena->_nextArena = _arenas;
+    }
+
+    _arenas = newArena;
+
+#ifdef COLLECT_ALLOCATION_STATS
+    currentMallocSize += (int)arenaDataSize;
+    int numArenas = 0;
+    for (ArenaHeader *tmpArena = _arenas; tmpArena != NULL; tmpArena = tmpArena->_nextArena)
+    {
+        numArenas++;
+    }
+    if (numArenas > maxArenaLength)
+    {
+        maxArenaLength = numArenas;
+    }
+    if (numArenas == 1)
+    {
+        numMemManagers++;
+    }
+#endif
+
+    return _arenas;
 }
 
 
@@ -70,12 +212,49 @@ ArenaManager::FreeArenas()
     while (_arenas)
     {
 #ifdef COLLECT_ALLOCATION_STATS
-        currentMallocSize -= _arenas->size;
+        currentMallocSize -= (int)_arenas->size;
 #endif
+        MemAccounting::sub(_arenas->owner, ArenaHeader::GetArenaSize(_arenas->size));
         unsigned char* killed = (unsigned char*) _arenas;
+        size_t killedSize = _arenas->size;
         _arenas = _arenas->_nextArena;
-        delete [] killed;
+        FreeChunk(killed, killedSize);
     }
 
     _arenas = 0;
 }
+
+void
+ArenaManager::Reset()
+{
+    ArenaHeader* largest = _arenas;
+    for (ArenaHeader* arena = _arenas; arena != NULL; arena = arena->_nextArena)
+    {
+        if (arena->size > largest->size)
+        {
+            largest = arena;
+        }
+    }
+
+    ArenaHeader* arena = _arenas;
+    while (arena)
+    {
+        ArenaHeader* next = arena->_nextArena;
+        if (arena != largest)
+        {
+#ifdef COLLECT_ALLOCATION_STATS
+            currentMallocSize -= (int)arena->size;
+#endif
+            MemAccounting::sub(arena->owner, ArenaHeader::GetArenaSize(arena->size));
+            FreeChunk((unsigned char*) arena, arena->size);
+        }
+        arena = next;
+    }
+
+    _arenas = largest;
+    if (_arenas)
+    {
+        _arenas->_nextArena = 0;
+        _arenas->_nextByte = _arenas->GetArenaData();
+    }
+}
@@ -26,8 +26,6 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 // A memory arena class implementation.
 
-// NOTE: Object requiring dword alignment is NOT supported.
-
 #ifndef _ARENA_H_
 #define _ARENA_H_
 
@@ -37,17 +35,20 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <cstddef>
 
 #include "Option.h"
+#include "MemAccounting.h"
 
 //#define COLLECT_ALLOCATION_STATS
 
 #ifdef COLLECT_ALLOCATION_STATS
-extern int numAllocations;
-extern int numMallocCalls;
-extern int totalAllocSize;
-extern int totalMallocSize;
-extern int numMemManagers;
-extern int maxArenaLength;
-extern int currentMallocSize;
+#include <atomic>
+// atomic since kernels may be compiled on several threads (-compileThreads)
+extern std::atomic<int> numAllocations;
+extern std::atomic<int> numMallocCalls;
+extern std::atomic<int> totalAllocSize;
+extern std::atomic<int> totalMallocSize;
+extern std::atomic<int> numMemManagers;
+extern std::atomic<int> maxArenaLength;
+extern std::atomic<int> currentMallocSize;
 #endif
 
 namespace vISA
@@ -59,9 +60,8 @@ namespace vISA
 
     public:
 
-        // FIXME: Currently there should be no type that needs 16-byte alignment.
-        // If such types exist in the future, either change this to __STDCPP_DEFAULT_NEW_ALIGNMENT__
-        // or use the overloaded alloc with align_val_t arg
+        // Alignment of every allocation. Types that need more should use the
+        // alloc overload taking an align_val_t.
         // We avoid using std::max_align_t here as it's 16 on some implementations and thus may waste memory
         static const size_t defaultAlign = 8;
 
@@ -99,7 +99,8 @@ namespace vISA
 
     private:
 
-        ArenaHeader(size_t dataSize, ArenaHeader* nextArena) : _nextArena(0), size(dataSize)
+        ArenaHeader(size_t dataSize, ArenaHeader* nextArena, MemOwner owner) :
+            _nextArena(0), size(dataSize), owner(owner)
         {
             _nextByte = GetArenaData();
             _lastByte = _nextByte + dataSize;
@@ -120,6 +121,7 @@ namespace vISA
         unsigned char* _nextByte;    // Char aligned
         unsigned char* _lastByte;    // Char aligned
         size_t size;
+        MemOwner owner;              // MemAccounting owner of this arena
     };
 
     class ArenaManager
@@ -130,9 +132,10 @@ namespace vISA
 
         // Functions
 
-        ArenaManager(size_t defaultArenaSize) :
+        ArenaManager(size_t defaultArenaSize, MemOwner owner) :
             _arenas(0),
-            _defaultArenaSize(defaultArenaSize)
+            _defaultArenaSize(defaultArenaSize),
+            _owner(owner)
         {
             CreateArena(_defaultArenaSize);
         }
@@ -142,6 +145,9 @@ namespace vISA
             FreeArenas();
         }
 
+        // Discard all allocations but keep the largest arena for reuse.
+        void Reset();
+
         void* AllocDataSpace(size_t size, size_t al)
         {
             // Do separate memory allocations of debugMemAlloc is set, to allow
@@ -157,7 +163,8 @@ namespace vISA
 
                 if (space == 0)
                 {
-                    CreateArena(size);
+                    // Arena data is only default aligned; leave room to align it.
+                    CreateArena(al > ArenaHeader::defaultAlign ? size + al - ArenaHeader::defaultAlign : size);
                     space = _arenas->AllocSpace(size, al);
                 }
 
@@ -166,56 +173,27 @@ namespace vISA
 
 #ifdef COLLECT_ALLOCATION_STATS
             numAllocations++;
-            totalAllocSize += size;
+            totalAllocSize += (int)size;
 #endif
 
             return space;
         }
 
-        ArenaHeader* CreateArena(size_t size)
-        {
-            size_t arenaDataSize = (size > _defaultArenaSize) ? size : _defaultArenaSize;
-            arenaDataSize = ArenaHeader::DefaultAlign(arenaDataSize);
-            unsigned char * arena =
-                new unsigned char[ArenaHeader::GetArenaSize(arenaDataSize)];
-
-            ArenaHeader* newArena = new (arena)ArenaHeader(arenaDataSize, _arenas);
-            // Add new arena to the head of queue
-            if (_arenas != NULL)
-            {
-                newArena->_nextArena = _arenas;
-            }
-
-            _arenas = newArena;
-
-#ifdef COLLECT_ALLOCATION_STATS
-            numMallocCalls++;
-            totalMallocSize += arenaDataSize;
-            currentMallocSize += arenaDataSize;
-            int numArenas = 0;
-            for (ArenaHeader *tmpArena = _arenas; tmpArena != NULL; tmpArena = tmpArena->_nextArena)
-            {
-                numArenas++;
-            }
-            if (numArenas > maxArenaLength)
-            {
-                maxArenaLength = numArenas;
-            }
-            if (numArenas == 1)
-            {
-                numMemManagers++;
-            }
-#endif
-
-            return _arenas;
-        }
+        ArenaHeader* CreateArena(size_t size);
 
         void FreeArenas();
 
+        // Arena chunks come from and go back to a per-thread pool, so that
+        // the many short-lived managers (liveness, RA iterations, scheduling)
+        // do not malloc and free the same blocks over and over.
+        static unsigned char* AllocChunk(size_t arenaDataSize);
+        static void FreeChunk(unsigned char* chunk, size_t arenaDataSize);
+
         // Data
 
         ArenaHeader * _arenas;
         const size_t  _defaultArenaSize;
+        const MemOwner _owner;
     };
 }
 #endif
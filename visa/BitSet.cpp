@@ -26,6 +26,31 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "BitSet.h"
 
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITSET_USE_SSE2
+#define BITSET_ELTS_PER_VECTOR (sizeof(__m128i) / sizeof(BITSET_ARRAY_TYPE))
+#endif
+
+// AVX2 is not part of the baseline, so those loops are compiled for it
+// separately and only called when the CPU supports it.
+#if defined(BITSET_USE_SSE2) && (defined(_MSC_VER) || \
+    ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))))
+#include <immintrin.h>
+#define BITSET_USE_AVX2
+#define BITSET_ELTS_PER_AVX2 (sizeof(__m256i) / sizeof(BITSET_ARRAY_TYPE))
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BITSET_AVX2_TARGET
+#else
+#define BITSET_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+#define BITSET_ELTS_PER_WORD (sizeof(uint64_t) / sizeof(BITSET_ARRAY_TYPE))
+
 void BitSet::create(unsigned size)
 {
     const unsigned newArraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
@@ -34,8 +59,7 @@ void BitSet::create(unsigned size)
 
     if (size == 0)
     {
-        free(m_BitSetArray);
-        m_Size = 0;
+        release();
         return;
     }
 
@@ -51,6 +75,10 @@ void BitSet::create(unsigned size)
     else
     {
         BITSET_ARRAY_TYPE*  ptr = (BITSET_ARRAY_TYPE*) malloc(newArraySize * sizeof(BITSET_ARRAY_TYPE));
+        if (!m_BitSetArray)
+        {
+            m_Owner = vISA::MemOwnerScope::current();
+        }
 
         if (ptr)
         {
@@ -78,10 +106,14 @@ void BitSet::create(unsigned size)
                 memset(ptr, 0, newArraySize * sizeof(BITSET_ARRAY_TYPE));
             }
 
-            free(m_BitSetArray);
+            release();
 
             m_BitSetArray = ptr;
             m_Size = size;
+            if (m_Owner != vISA::MemOwner::Other)
+            {
+                vISA::MemAccounting::add(m_Owner, arrayBytes(size));
+            }
         }
         else
         {
@@ -129,31 +161,190 @@ void BitSet::invert(void)
     }
 }
 
-template <typename T>
-void vector_and(T *__restrict__ p1, const T *const p2, unsigned n)
+#ifdef BITSET_USE_AVX2
+static bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    // The OS must save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2).
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+static unsigned maxBulkOpWidth()
+{
+#if defined(BITSET_USE_AVX2)
+    static const unsigned width = cpuHasAVX2() ? 256 : 128;
+    return width;
+#elif defined(BITSET_USE_SSE2)
+    return 128;
+#else
+    return 64;
+#endif
+}
+
+static unsigned bulkOpWidth = maxBulkOpWidth();
+
+unsigned BitSet::getBulkOpWidth()
+{
+    return bulkOpWidth;
+}
+
+void BitSet::setBulkOpWidth(unsigned bits)
+{
+    unsigned maxWidth = maxBulkOpWidth();
+    bulkOpWidth = bits >= 256 ? 256 : bits >= 128 ? 128 : 64;
+    if (bulkOpWidth > maxWidth)
+    {
+        bulkOpWidth = maxWidth;
+    }
+}
+
+// The bulk operations below are the inner loops of the liveness dataflow
+// fix-point. They process 256 or 128 bits at a time, depending on
+// getBulkOpWidth(), then 64-bit words, then the last element on its own.
+// Unaligned loads and stores are used throughout since the arrays come from
+// malloc and are only element aligned.
+enum class BulkOp { And, Or, Minus };
+
+template <BulkOp Op>
+static inline void scalarOp(BITSET_ARRAY_TYPE* p1, const BITSET_ARRAY_TYPE* p2, unsigned i, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    for (; i + BITSET_ELTS_PER_WORD <= n; i += BITSET_ELTS_PER_WORD)
     {
-        p1[i] &= p2[i];
+        uint64_t w1, w2;
+        memcpy(&w1, p1 + i, sizeof(w1));
+        memcpy(&w2, p2 + i, sizeof(w2));
+        w1 = Op == BulkOp::And ? (w1 & w2) : Op == BulkOp::Or ? (w1 | w2) : (w1 & ~w2);
+        memcpy(p1 + i, &w1, sizeof(w1));
+    }
+    for (; i < n; ++i)
+    {
+        p1[i] = Op == BulkOp::And ? (p1[i] & p2[i]) : Op == BulkOp::Or ? (p1[i] | p2[i]) : (p1[i] & ~p2[i]);
     }
 }
 
-template <typename T>
-void vector_or(T *__restrict__ p1, const T *const p2, unsigned n)
+#ifdef BITSET_USE_SSE2
+template <BulkOp Op>
+static inline unsigned sse2Op(BITSET_ARRAY_TYPE* p1, const BITSET_ARRAY_TYPE* p2, unsigned i, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    for (; i + BITSET_ELTS_PER_VECTOR <= n; i += BITSET_ELTS_PER_VECTOR)
     {
-        p1[i] |= p2[i];
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        // andnot computes ~v2 & v1
+        __m128i r = Op == BulkOp::And ? _mm_and_si128(v1, v2) :
+            Op == BulkOp::Or ? _mm_or_si128(v1, v2) : _mm_andnot_si128(v2, v1);
+        _mm_storeu_si128((__m128i*)(p1 + i), r);
     }
+    return i;
 }
+#endif
 
-template <typename T>
-void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
+#ifdef BITSET_USE_AVX2
+template <BulkOp Op>
+BITSET_AVX2_TARGET static unsigned avx2Op(BITSET_ARRAY_TYPE* p1, const BITSET_ARRAY_TYPE* p2, unsigned i, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    for (; i + BITSET_ELTS_PER_AVX2 <= n; i += BITSET_ELTS_PER_AVX2)
     {
-        p1[i] &= ~p2[i];
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(p1 + i));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*)(p2 + i));
+        __m256i r = Op == BulkOp::And ? _mm256_and_si256(v1, v2) :
+            Op == BulkOp::Or ? _mm256_or_si256(v1, v2) : _mm256_andnot_si256(v2, v1);
+        _mm256_storeu_si256((__m256i*)(p1 + i), r);
+    }
+    return i;
+}
+
+BITSET_AVX2_TARGET static bool avx2IsZero(const BITSET_ARRAY_TYPE* p, unsigned& i, unsigned n)
+{
+    for (; i + BITSET_ELTS_PER_AVX2 <= n; i += BITSET_ELTS_PER_AVX2)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        if (!_mm256_testz_si256(v, v))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+template <BulkOp Op>
+static void bulkOp(BITSET_ARRAY_TYPE *__restrict__ p1, const BITSET_ARRAY_TYPE *const p2, unsigned n)
+{
+    unsigned i = 0;
+#ifdef BITSET_USE_AVX2
+    if (bulkOpWidth == 256)
+    {
+        i = avx2Op<Op>(p1, p2, i, n);
+    }
+#endif
+#ifdef BITSET_USE_SSE2
+    if (bulkOpWidth >= 128)
+    {
+        i = sse2Op<Op>(p1, p2, i, n);
+    }
+#endif
+    scalarOp<Op>(p1, p2, i, n);
+}
+
+bool BitSet::isEmpty() const
+{
+    unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    unsigned i = 0;
+#ifdef BITSET_USE_AVX2
+    if (bulkOpWidth == 256 && !avx2IsZero(m_BitSetArray, i, arraySize))
+    {
+        return false;
+    }
+#endif
+#ifdef BITSET_USE_SSE2
+    if (bulkOpWidth >= 128)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + BITSET_ELTS_PER_VECTOR <= arraySize; i += BITSET_ELTS_PER_VECTOR)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(m_BitSetArray + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xFFFF)
+            {
+                return false;
+            }
+        }
+    }
+#endif
+    for (; i + BITSET_ELTS_PER_WORD <= arraySize; i += BITSET_ELTS_PER_WORD)
+    {
+        uint64_t w;
+        memcpy(&w, m_BitSetArray + i, sizeof(w));
+        if (w != 0)
+        {
+            return false;
+        }
+    }
+    for (; i < arraySize; i++)
+    {
+        if (m_BitSetArray[i] != 0)
+        {
+            return false;
+        }
     }
+    return true;
 }
 
 BitSet& BitSet::operator|=(const BitSet& other)
@@ -168,7 +359,7 @@ BitSet& BitSet::operator|=(const BitSet& other)
     }
 
     unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    vector_or(m_BitSetArray, other.m_BitSetArray, arraySize);
+    bulkOp<BulkOp::Or>(m_BitSetArray, other.m_BitSetArray, arraySize);
 
     return *this;
 }
@@ -178,7 +369,7 @@ BitSet& BitSet::operator-= (const BitSet &other)
     // do not grow the set for subtract
     unsigned size = m_Size < other.m_Size ? m_Size : other.m_Size;
     unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    vector_minus(m_BitSetArray, other.m_BitSetArray, arraySize);
+    bulkOp<BulkOp::Minus>(m_BitSetArray, other.m_BitSetArray, arraySize);
     return *this;
 }
 
@@ -187,7 +378,7 @@ BitSet& BitSet::operator&= (const BitSet &other)
     // do not grow the set for and
     unsigned size =  m_Size < other.m_Size ? m_Size : other.m_Size;
     unsigned arraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-    vector_and(m_BitSetArray, other.m_BitSetArray, arraySize);
+    bulkOp<BulkOp::And>(m_BitSetArray, other.m_BitSetArray, arraySize);
 
     //zero out the leftover bits if there are any
     unsigned myArraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
@@ -28,6 +28,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define _BITSET_H_
 
 #include "Mem_Manager.h"
+#include "MemAccounting.h"
 #include <cstdlib>
 #include <cstring>
 
@@ -42,11 +43,12 @@ class BitSet
 #define NUM_BITS_PER_ELT ( sizeof(BITSET_ARRAY_TYPE) * BITS_PER_BYTE )
 
 public:
-    BitSet() : m_BitSetArray(nullptr), m_Size(0) {}
+    BitSet() : m_BitSetArray(nullptr), m_Size(0), m_Owner(vISA::MemOwner::Other) {}
     BitSet(unsigned size, bool defaultValue)
     {
         m_BitSetArray = NULL;
         m_Size = 0;
+        m_Owner = vISA::MemOwner::Other;
 
         create(size);
         if (defaultValue)
@@ -55,7 +57,7 @@ public:
         }
     }
 
-    BitSet(const BitSet &other) : m_BitSetArray(nullptr), m_Size(0)
+    BitSet(const BitSet &other) : m_BitSetArray(nullptr), m_Size(0), m_Owner(vISA::MemOwner::Other)
     {
         copy(other);
     }
@@ -64,11 +66,12 @@ public:
     {
         m_BitSetArray = other.m_BitSetArray;
         m_Size = other.m_Size;
+        m_Owner = other.m_Owner;
         other.m_BitSetArray = nullptr;
         other.m_Size = 0;
     }
 
-    ~BitSet() { std::free(m_BitSetArray); }
+    ~BitSet() { release(); }
 
     void resize(unsigned size) { create(size); }
     void clear()
@@ -80,18 +83,7 @@ public:
     void setAll(void);
     void invert(void);
 
-    bool isEmpty() const
-    {
-        unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
-        for (unsigned i = 0; i < arraySize; i++)
-        {
-            if (m_BitSetArray[i] != 0)
-            {
-                return false;
-            }
-        }
-        return true;
-    }
+    bool isEmpty() const;
 
     bool isAllset() const
     {
@@ -297,6 +289,24 @@ public:
 
     unsigned getSize() const { return m_Size; }
 
+    // Calls f(index) for every set bit, in increasing order.
+    template <typename F>
+    void forEachSetBit(F f) const
+    {
+        unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+        for (unsigned i = 0; i < arraySize; i++)
+        {
+            BITSET_ARRAY_TYPE elt = m_BitSetArray[i];
+            for (unsigned bitIndex = 0; elt != 0; bitIndex++, elt >>= 1)
+            {
+                if (elt & 1)
+                {
+                    f(i * NUM_BITS_PER_ELT + bitIndex);
+                }
+            }
+        }
+    }
+
     bool operator==(const BitSet &other) const
     {
         if (m_Size == other.m_Size)
@@ -325,10 +335,15 @@ public:
 
     BitSet& operator=(BitSet&& other) noexcept
     {
-        m_BitSetArray = other.m_BitSetArray;
-        m_Size = other.m_Size;
-        other.m_BitSetArray = nullptr;
-        other.m_Size = 0;
+        if (this != &other)
+        {
+            release();
+            m_BitSetArray = other.m_BitSetArray;
+            m_Size = other.m_Size;
+            m_Owner = other.m_Owner;
+            other.m_BitSetArray = nullptr;
+            other.m_Size = 0;
+        }
 
         return *this;
     }
@@ -339,6 +354,7 @@ public:
         {
             std::swap(m_Size, other.m_Size);
             std::swap(m_BitSetArray, other.m_BitSetArray);
+            std::swap(m_Owner, other.m_Owner);
         }
     }
 
@@ -346,12 +362,38 @@ public:
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
 
+    // Width in bits of the chunks |=, &=, -= and isEmpty() work on: 256 with
+    // AVX2, 128 with SSE2, or 64-bit scalar words. It defaults to the widest
+    // the CPU supports; setBulkOpWidth() never goes above that.
+    static unsigned getBulkOpWidth();
+    static void setBulkOpWidth(unsigned bits);
+
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
 protected:
+    friend class SparseBitSet;
+
     BITSET_ARRAY_TYPE* m_BitSetArray;
     unsigned m_Size;
+    // The array is charged to the MemOwnerScope active when it was first
+    // allocated; it keeps that owner when it grows or is moved.
+    vISA::MemOwner m_Owner;
+
+    static size_t arrayBytes(unsigned size)
+    {
+        return (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT * sizeof(BITSET_ARRAY_TYPE);
+    }
+    void release()
+    {
+        if (m_BitSetArray && m_Owner != vISA::MemOwner::Other)
+        {
+            vISA::MemAccounting::sub(m_Owner, arrayBytes(m_Size));
+        }
+        std::free(m_BitSetArray);
+        m_BitSetArray = nullptr;
+        m_Size = 0;
+    }
 
     void create(unsigned size);
     void copy(const BitSet &other)
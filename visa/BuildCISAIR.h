@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <sstream>
 #include <cstdint>
+#include <thread>
 
 namespace vISA
 {
@@ -861,9 +862,17 @@ private:
 
     void emitFCPatchFile();
 
+    unsigned getNumCompileThreads() const;
+
     PWA_TABLE m_pWaTable;
     bool needsToFreeWATable = false;
 
+    // Platform and stepping are thread-local; Compile() re-establishes the
+    // ones the builder was created with when it runs on another thread.
+    std::thread::id m_creatorThread;
+    TARGET_PLATFORM m_platform = GENX_NONE;
+    const char* m_steppingStr = nullptr;
+
     void* gtpin_init = nullptr;
 
     // important messages that we should relay to the user
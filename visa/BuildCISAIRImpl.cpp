@@ -29,6 +29,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include <fstream>
 #include <list>
+#include <vector>
 
 #include "visa_igc_common_header.h"
 #include "Common_ISA.h"
@@ -42,6 +43,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "VISAKernel.h"
 #include "BinaryCISAEmission.h"
 #include "Timer.h"
+#include "WorkerThreads.h"
 #include "BinaryEncoding.h"
 #include "IsaDisassembly.h"
 
@@ -292,6 +294,10 @@ int CISA_IR_Builder::CreateBuilder(
         builder->InitVisaWaTable(platform, GetStepping());
     }
 
+    builder->m_creatorThread = std::this_thread::get_id();
+    builder->m_platform = getGenxPlatform();
+    builder->m_steppingStr = GetSteppingString();
+
     return VISA_SUCCESS;
 }
 
@@ -673,10 +679,47 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaFile)
 #endif
 }
 
+// Returns the number of threads kernels/functions may be compiled with,
+// or 1 if they have to be compiled serially.
+unsigned CISA_IR_Builder::getNumCompileThreads() const
+{
+    unsigned numThreads = vISA::getNumWorkerThreads(m_options.getuInt32Option(vISA_NumCompileThreads));
+    if (numThreads <= 1 || m_kernelsAndFunctions.size() <= 1)
+    {
+        return 1;
+    }
+
+    // a payload section copies the main kernel's declarations
+    if (m_options.getuInt32Option(vISA_CodePatch))
+    {
+        return 1;
+    }
+    for (auto func : m_kernelsAndFunctions)
+    {
+        if (func->getIsPayload())
+        {
+            return 1;
+        }
+    }
+    return numThreads;
+}
+
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
 int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_visa_only)
 {
+    if (std::this_thread::get_id() != m_creatorThread)
+    {
+        // The builder was created on another thread (e.g., IGC finalizing
+        // several SIMD variants concurrently). Only the compile itself is
+        // timed on this thread.
+        SetVisaPlatform(m_platform);
+        InitStepping();
+        SetStepping(m_steppingStr);
+        initTimer();
+        startTimer(TimerID::TOTAL);
+        startTimer(TimerID::BUILDER);
+    }
     stopTimer(TimerID::BUILDER);   // TIMER_BUILDER is started when builder is created
     int status = VISA_SUCCESS;
 
@@ -772,6 +815,26 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
 
         pseudoHeader.functions = (function_info_t*)mem.alloc(sizeof(function_info_t) * pseudoHeader.num_functions);
 
+        // Kernels and functions are optimized independently of each other,
+        // so with -compileThreads they are collected here and compiled on
+        // worker threads once all of them have been set up.
+        unsigned numCompileThreads = getNumCompileThreads();
+        std::vector<VISAKernelImpl*> parallelUnits;
+        if (numCompileThreads > 1)
+        {
+            for (auto func : m_kernelsAndFunctions)
+            {
+                // constructFlowGraph() turns off scalar jmp for CM on fused EU
+                // platforms; do it up front so the workers never write the
+                // shared options.
+                if (func->getIRBuilder()->hasFusedEU() &&
+                    func->getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM)
+                {
+                    m_options.setOptionInternally(vISA_EnableScalarJmp, false);
+                }
+            }
+        }
+
         int i;
         unsigned int k = 0;
         VISAKernelImpl* mainKernel = nullptr;
@@ -805,6 +868,12 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
                 kernel->getKernel()->Declares = mainKernel->getKernel()->Declares;
             }
 
+            if (numCompileThreads > 1)
+            {
+                parallelUnits.push_back(kernel);
+                continue;
+            }
+
             int status =  kernel->compileFastPath();
             if (status != VISA_SUCCESS)
             {
@@ -812,6 +881,35 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
                 return status;
             }
         }
+
+        if (!parallelUnits.empty())
+        {
+            std::vector<int> unitStatus(parallelUnits.size(), VISA_SUCCESS);
+            for (auto func : parallelUnits)
+            {
+                func->getIRBuilder()->setBufferCriticalMsg(true);
+            }
+            vISA::runOnWorkerThreads(numCompileThreads, parallelUnits.size(), [&](size_t idx)
+            {
+                unitStatus[idx] = parallelUnits[idx]->compileFastPath();
+            });
+            for (auto func : parallelUnits)
+            {
+                func->getIRBuilder()->setBufferCriticalMsg(false);
+                func->getIRBuilder()->flushCriticalMsg();
+            }
+
+            // report the first failure in list order, regardless of which
+            // worker finished first
+            for (int unitResult : unitStatus)
+            {
+                if (unitResult != VISA_SUCCESS)
+                {
+                    stopTimer(TimerID::TOTAL);
+                    return unitResult;
+                }
+            }
+        }
         // Here we change the payload section as the main kernel in m_kernelsAndFunctions
         // During stitching, all functions will be cloned and stitched to the main kernel.
         // Demoting the shader body to a function type makes it intact
@@ -888,7 +986,7 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
         }
 
         // stitch functions and compile to gen binary
-        for (auto func : mainFunctions)
+        auto compileMainFunction = [&](VISAKernelImpl* func)
         {
             unsigned int genxBufferSize = 0;
 
@@ -903,8 +1001,45 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
                 func->computeAndEmitDebugInfo(subFunctions);
             }
             restoreFCallState(func->getKernel(), origFCallFRet);
+        };
 
+        // Without functions to stitch, each main function is compiled on its
+        // own. RA turns off local RA in the shared options for 3D kernels
+        // with subroutines, so those keep being compiled serially.
+        bool compileMainFunctionsInParallel =
+            numCompileThreads > 1 && subFunctions.empty() && mainFunctions.size() > 1;
+        for (auto func : mainFunctions)
+        {
+            if (func->getKernel()->fg.getNumFuncs() > 0 &&
+                func->getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D)
+            {
+                compileMainFunctionsInParallel = false;
+            }
+        }
 
+        if (compileMainFunctionsInParallel)
+        {
+            std::vector<VISAKernelImpl*> units(mainFunctions.begin(), mainFunctions.end());
+            for (auto func : units)
+            {
+                func->getIRBuilder()->setBufferCriticalMsg(true);
+            }
+            vISA::runOnWorkerThreads(numCompileThreads, units.size(), [&](size_t idx)
+            {
+                compileMainFunction(units[idx]);
+            });
+            for (auto func : units)
+            {
+                func->getIRBuilder()->setBufferCriticalMsg(false);
+                func->getIRBuilder()->flushCriticalMsg();
+            }
+        }
+        else
+        {
+            for (auto func : mainFunctions)
+            {
+                compileMainFunction(func);
+            }
         }
 
 
@@ -3232,9 +3367,19 @@ void CISA_IR_Builder::CISA_post_file_parse()
 // place it here so that internal Gen_IR files don't have to include VISAKernel.h
 std::stringstream& IR_Builder::criticalMsgStream()
 {
+    if (bufferCriticalMsg)
+    {
+        return kernelCriticalMsg;
+    }
     return const_cast<CISA_IR_Builder*>(parentBuilder)->criticalMsgStream();
 }
 
+void IR_Builder::flushCriticalMsg()
+{
+    const_cast<CISA_IR_Builder*>(parentBuilder)->criticalMsgStream() << kernelCriticalMsg.str();
+    kernelCriticalMsg.str("");
+}
+
 
 
 
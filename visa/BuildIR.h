@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <list>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 
 #include "Gen4_IR.hpp"
@@ -456,6 +457,11 @@ private:
 
     const CISA_IR_Builder* parentBuilder = nullptr;
 
+    // While kernels are compiled concurrently their critical messages are
+    // buffered here and flushed to the parent builder in kernel order.
+    bool bufferCriticalMsg = false;
+    std::stringstream kernelCriticalMsg;
+
     // stores all metadata ever allocated
     Mem_Manager            metadataMem;
     std::vector<Metadata*> allMDs;
@@ -494,6 +500,8 @@ public:
     void dump(std::ostream &os); // not const because G4_INST::emit isn't :(
 
     std::stringstream& criticalMsgStream();
+    void setBufferCriticalMsg(bool val) { bufferCriticalMsg = val; }
+    void flushCriticalMsg();
 
     const USE_DEF_ALLOCATOR& getAllocator() const { return useDefAllocator; }
 
@@ -45,6 +45,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "DebugInfo.h"
 #include <random>
 #include <chrono>
+#include <atomic>
 
 #include "BinaryEncodingIGA.h"
 #include "iga/IGALibrary/api/iga.h"
@@ -255,7 +256,7 @@ G4_BB* FlowGraph::createNewBBWithLabel(const char* LabelPrefix, int Lineno, int
     return newBB;
 }
 
-static int globalCount = 1;
+static std::atomic<int> globalCount(1);
 int64_t FlowGraph::insertDummyUUIDMov()
 {
     // Here when -addKernelId is passed
@@ -273,8 +274,7 @@ int64_t FlowGraph::insertDummyUUIDMov()
         for (auto bb : BBs)
         {
             uint32_t seed = (uint32_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            std::mt19937 mt_rand(seed * globalCount);
-            globalCount++;
+            std::mt19937 mt_rand(seed * globalCount++);
 
             G4_DstRegRegion* nullDst = builder->createNullDst(Type_UD);
             int64_t uuID = (int64_t)mt_rand();
@@ -557,8 +557,11 @@ void FlowGraph::constructFlowGraph(INST_LIST& instlist)
 {
     MUST_BE_TRUE(!instlist.empty(), ERROR_SYNTAX("empty instruction list"));
 
+    // The options are shared by all kernels of the builder and may be read
+    // concurrently (-compileThreads), so only write them if needed.
     if (builder->hasFusedEU() &&
-        getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM)
+        getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM &&
+        getKernel()->getOption(vISA_EnableScalarJmp))
     {
         getKernel()->getOptions()->setOptionInternally(vISA_EnableScalarJmp, false);
     }
@@ -142,6 +142,133 @@ namespace vISA
 
         bool operator!=(const std_arena_based_allocator & a) const { return !operator==(a); }
     };
+
+    // Arena allocator for instruction list nodes. Erased nodes are put on a
+    // free list and handed out again, so passes that keep rebuilding
+    // instruction lists (e.g., the schedulers) reuse nodes instead of growing
+    // the arena. The free list is kept out of line, so the memory of an
+    // erased node stays intact until the node is reused.
+    //
+    // Only allocators made by createShared() (the kernel's, copied into the
+    // BB lists and the builder's instList) own a free list, and a free list
+    // is always paired with the arena it was created with. Allocators still
+    // all compare equal, as std::list requires for splicing nodes between
+    // lists (e.g., when Stitch_Compiled_Units appends the callees' blocks to
+    // the kernel). Recyclable nodes therefore carry a header with the arena
+    // they came from, and an erased node only goes on the free list if it
+    // came from the arena of the list it is erased from; any other node is
+    // left to its arena, as before.
+    struct InstListFreeNodes
+    {
+        // Free nodes by size in units of ArenaHeader::defaultAlign; only
+        // single-object allocations of small types are recycled.
+        static const size_t numSizeClasses = 8;
+        std::vector<void*> nodes[numSizeClasses];
+    };
+
+    template <class T>
+    class inst_list_node_allocator : public std_arena_based_allocator<T>
+    {
+        typedef InstListFreeNodes FreeNodes;
+        std::shared_ptr<FreeNodes> freeNodes;
+
+        static const size_t headerSize = ArenaHeader::defaultAlign;
+
+        static size_t sizeClass()
+        {
+            return ArenaHeader::DefaultAlign(sizeof(T)) / ArenaHeader::defaultAlign;
+        }
+
+        static bool isRecyclable(size_t n)
+        {
+            return n == 1 && sizeClass() < FreeNodes::numSizeClasses;
+        }
+
+        static Mem_Manager*& origin(void* p)
+        {
+            return *(Mem_Manager**)((char*)p - headerSize);
+        }
+
+    public:
+        typedef typename std_arena_based_allocator<T>::pointer pointer;
+        typedef typename std_arena_based_allocator<T>::size_type size_type;
+
+        inst_list_node_allocator() : std_arena_based_allocator<T>()
+        {
+        }
+
+        static inst_list_node_allocator createShared()
+        {
+            inst_list_node_allocator alloc;
+            alloc.freeNodes = std::make_shared<FreeNodes>();
+            return alloc;
+        }
+
+        inst_list_node_allocator(const inst_list_node_allocator& other)
+            : std_arena_based_allocator<T>(other), freeNodes(other.freeNodes)
+        {
+        }
+
+        template <class U>
+        inst_list_node_allocator(const inst_list_node_allocator<U>& other)
+            : std_arena_based_allocator<T>(other), freeNodes(other.freeNodes)
+        {
+        }
+
+        template <class U>
+        inst_list_node_allocator& operator=(const inst_list_node_allocator<U>& other)
+        {
+            this->mem_manager_ptr = other.mem_manager_ptr;
+            freeNodes = other.freeNodes;
+            return *this;
+        }
+
+        inst_list_node_allocator& operator=(const inst_list_node_allocator& other)
+        {
+            this->mem_manager_ptr = other.mem_manager_ptr;
+            freeNodes = other.freeNodes;
+            return *this;
+        }
+
+        template <class U>
+        struct rebind { typedef inst_list_node_allocator<U> other; };
+
+        template <class U> friend class inst_list_node_allocator;
+
+        pointer allocate(size_type n, const void * hint = 0)
+        {
+            if (!isRecyclable(n))
+            {
+                return std_arena_based_allocator<T>::allocate(n, hint);
+            }
+            if (freeNodes)
+            {
+                auto& nodes = freeNodes->nodes[sizeClass()];
+                if (!nodes.empty())
+                {
+                    void* node = nodes.back();
+                    nodes.pop_back();
+                    return (pointer)node;
+                }
+            }
+            Mem_Manager* arena = this->mem_manager_ptr.get();
+            void* node = (char*)arena->alloc(headerSize + sizeof(T)) + headerSize;
+            origin(node) = arena;
+            return (pointer)node;
+        }
+
+        void deallocate(void* p, size_type n)
+        {
+            if (isRecyclable(n) && freeNodes && origin(p) == this->mem_manager_ptr.get())
+            {
+                freeNodes->nodes[sizeClass()].push_back(p);
+            }
+        }
+
+        bool operator==(const inst_list_node_allocator&) const { return true; }
+
+        bool operator!=(const inst_list_node_allocator& other) const { return !operator==(other); }
+    };
 }
 void resetRightBound(vISA::G4_Operand* opnd);
 
@@ -238,7 +365,7 @@ inline const char* MathOpNames[16] =
 };
 
 
-typedef vISA::std_arena_based_allocator<vISA::G4_INST*> INST_LIST_NODE_ALLOCATOR;
+typedef vISA::inst_list_node_allocator<vISA::G4_INST*> INST_LIST_NODE_ALLOCATOR;
 
 typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>           INST_LIST;
 typedef std::list<vISA::G4_INST*, INST_LIST_NODE_ALLOCATOR>::iterator INST_LIST_ITER;
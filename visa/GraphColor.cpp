@@ -33,12 +33,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <sstream>
 #include "Timer.h"
 #include <fstream>
+#include <iomanip>
 #include <algorithm>
+#include <climits>
+#include <iterator>
 #include "LocalRA.h"
 #include "LinearScanRA.h"
+#include "WorkerThreads.h"
 #include "DebugInfo.h"
 #include "SpillCleanup.h"
 #include "Rematerialization.h"
+#include "LoopVarSplit.h"
 #include "RPE.h"
 #include "Optimizer.h"
 #include <cmath>  // sqrt
@@ -71,6 +76,57 @@ Interference::Interference(LivenessAnalysis* l, LiveRange**& lr, unsigned n, uns
 {
 }
 
+unsigned int* Interference::allocateTile(unsigned tileIdx)
+{
+    unsigned int* tile = new unsigned int[tileSize * tileRowWords](); // zero-initialize
+    tiles[tileIdx] = tile;
+    numAllocatedTiles++;
+    return tile;
+}
+
+void Interference::freeTiles()
+{
+    if (!tiles)
+    {
+        return;
+    }
+    size_t numTiles = (size_t)numTileCols * (maxId / tileSize + 1);
+    for (size_t i = 0; i < numTiles; i++)
+    {
+        delete[] tiles[i];
+        tiles[i] = nullptr;
+    }
+    numAllocatedTiles = 0;
+}
+
+size_t Interference::getMemoryUsage() const
+{
+    size_t size = 0;
+    if (useTiledMatrix())
+    {
+        size_t numTiles = (size_t)numTileCols * (maxId / tileSize + 1);
+        size += numTiles * sizeof(tiles[0]) +
+            (size_t)numAllocatedTiles * tileSize * tileRowWords * sizeof(unsigned int);
+    }
+    else if (useDenseMatrix())
+    {
+        size += (size_t)rowSize * maxId * sizeof(unsigned int);
+    }
+    else
+    {
+        // rough per-entry cost of an unordered_set node
+        for (auto&& row : sparseMatrix)
+        {
+            size += row.bucket_count() * sizeof(void*) + row.size() * (sizeof(uint32_t) + 2 * sizeof(void*));
+        }
+    }
+    for (auto&& neighbors : sparseIntf)
+    {
+        size += neighbors.capacity() * sizeof(unsigned int);
+    }
+    return size;
+}
+
 inline bool Interference::varSplitCheckBeforeIntf(unsigned v1, unsigned v2)
 {
     const LiveRange * l1 = lrs[v1];
@@ -1532,7 +1588,7 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
     if (useDenseMatrix())
     {
         unsigned col = v2 / BITS_DWORD;
-        return matrix[v1 * rowSize + col] & (1 << (v2 % BITS_DWORD));
+        return getInterferenceBlk(v1, col) & (1 << (v2 % BITS_DWORD));
     }
     else
     {
@@ -1597,6 +1653,11 @@ inline void Interference::filterSplitDclares(unsigned startIdx, unsigned endIdx,
 //
 void Interference::buildInterferenceWithLive(BitSet& live, unsigned i)
 {
+    if (!recordsEdges())
+    {
+        return;
+    }
+
     bool is_partial = lrs[i]->getIsPartialDcl();
     bool is_splitted = lrs[i]->getIsSplittedDcl();
     unsigned n = 0;
@@ -2088,7 +2149,7 @@ void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* i
     if (regVar->isRegAllocPartaker())
     {
         unsigned id = ((G4_RegVar*)regVar)->getId();
-        lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);
+        updateLiveRange(LiveRangeUpdate::RefCount, id, refCount);
 
         buildInterferenceWithLive(live, id);
         updateLiveness(live, id, false);
@@ -2124,7 +2185,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
         if (!inst->isPseudoKill() &&
             !inst->isLifeTimeEnd())
         {
-            lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);  // update reference count
+            updateLiveRange(LiveRangeUpdate::RefCount, id, refCount);  // update reference count
 
             buildInterferenceWithLive(live, id);
             if (lrs[id]->getIsSplittedDcl())
@@ -2139,7 +2200,16 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
         //
         if (kernel.fg.isPseudoVCADcl(lrs[id]->getDcl()))
         {
-            addCalleeSaveBias(live);
+            if (parallelScan)
+            {
+                curShard->calleeSaveLive.push_back(live);
+                updateLiveRange(LiveRangeUpdate::CalleeSaveBias, id,
+                    (unsigned)curShard->calleeSaveLive.size() - 1);
+            }
+            else
+            {
+                addCalleeSaveBias(live);
+            }
         }
         //
         // if the write does not cover the whole dst region, we should continue let the
@@ -2162,7 +2232,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
         }
 
         // Indirect defs are actually uses of address reg
-        lrs[id]->checkForInfiniteSpillCost(bb, i);
+        updateLiveRange(LiveRangeUpdate::InfiniteSpillCost, id, 0, 0, bb, i);
     }
     else if (dst->isIndirect() && liveAnalysis->livenessClass(G4_GRF))
     {
@@ -2254,7 +2324,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 if (dst->getBase()->isRegAllocPartaker() && !dst->getBase()->asRegVar()->isPhyRegAssigned())
                 {
                     int dstId = dst->getBase()->asRegVar()->getId();
-                    lrs[dstId]->markForbidden(kernel.getNumRegTotal() - 1, 1);
+                    updateLiveRange(LiveRangeUpdate::Forbidden, dstId, kernel.getNumRegTotal() - 1, 1);
                 }
             }
         }
@@ -2295,7 +2365,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 if (srcRegion->getBase()->isRegAllocPartaker())
                 {
                     unsigned id = ((G4_RegVar*)(srcRegion)->getBase())->getId();
-                    lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    updateLiveRange(LiveRangeUpdate::RefCount, id, refCount); // update reference count
 
                     if (!inst->isLifeTimeEnd())
                     {
@@ -2309,16 +2379,16 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                     if (inst->isEOT() && liveAnalysis->livenessClass(G4_GRF))
                     {
                         //mark the liveRange as the EOT source
-                        lrs[id]->setEOTSrc();
+                        updateLiveRange(LiveRangeUpdate::EOTSrc, id);
                         if (builder.hasEOTGRFBinding())
                         {
-                            lrs[id]->markForbidden(0, kernel.getNumRegTotal() - 16);
+                            updateLiveRange(LiveRangeUpdate::Forbidden, id, 0, kernel.getNumRegTotal() - 16);
                         }
                     }
 
                     if (inst->isReturn())
                     {
-                        lrs[id]->setRetIp();
+                        updateLiveRange(LiveRangeUpdate::RetIp, id);
                     }
                 }
                 else if (srcRegion->isIndirect() && liveAnalysis->livenessClass(G4_GRF))
@@ -2364,7 +2434,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 unsigned id = flagReg->asRegVar()->getId();
                 if (flagReg->asRegVar()->isRegAllocPartaker())
                 {
-                    lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    updateLiveRange(LiveRangeUpdate::RefCount, id, refCount); // update reference count
                     buildInterferenceWithLive(live, id);
 
                     if (liveAnalysis->writeWholeRegion(bb, inst, flagReg))
@@ -2372,7 +2442,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                         updateLiveness(live, id, false);
                     }
 
-                    lrs[id]->checkForInfiniteSpillCost(bb, i);
+                    updateLiveRange(LiveRangeUpdate::InfiniteSpillCost, id, 0, 0, bb, i);
                 }
             }
             else
@@ -2393,7 +2463,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
             unsigned id = flagReg->asRegVar()->getId();
             if (flagReg->asRegVar()->isRegAllocPartaker())
             {
-                lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                updateLiveRange(LiveRangeUpdate::RefCount, id, refCount); // update reference count
                 live.set(id, true);
             }
         }
@@ -2406,16 +2476,111 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
     }
 }
 
-void Interference::computeInterference()
+_THREAD Interference::IntfShard* Interference::curShard = nullptr;
+
+void Interference::updateLiveRange(LiveRangeUpdate::Kind kind, unsigned id, unsigned arg0, unsigned arg1,
+    G4_BB* bb, std::list<G4_INST*>::reverse_iterator it)
+{
+    LiveRangeUpdate update = { kind, id, arg0, arg1, bb, it };
+    if (parallelScan)
+    {
+        curShard->updates.push_back(update);
+    }
+    else
+    {
+        applyLiveRangeUpdate(update);
+    }
+}
+
+void Interference::applyLiveRangeUpdate(const LiveRangeUpdate& update)
+{
+    LiveRange* lr = lrs[update.id];
+    switch (update.kind)
+    {
+    case LiveRangeUpdate::RefCount:
+        lr->setRefCount(lr->getRefCount() + update.arg0);
+        break;
+    case LiveRangeUpdate::Forbidden:
+        lr->markForbidden(update.arg0, update.arg1);
+        break;
+    case LiveRangeUpdate::EOTSrc:
+        lr->setEOTSrc();
+        break;
+    case LiveRangeUpdate::RetIp:
+        lr->setRetIp();
+        break;
+    case LiveRangeUpdate::InfiniteSpillCost:
+    {
+        auto it = update.it;
+        lr->checkForInfiniteSpillCost(update.bb, it);
+        break;
+    }
+    case LiveRangeUpdate::CalleeSaveBias:
+        // only logged by parallel scans, see buildInterferenceForBBs
+        addCalleeSaveBias(curShard->calleeSaveLive[update.arg0]);
+        break;
+    }
+}
+
+void Interference::buildInterferenceForBBs(const std::vector<bool>* cleanBBs)
 {
-    startTimer(TimerID::INTERFERENCE);
     //
     // create bool vector, live, to track live ranges that are currently live
     //
     BitSet live(maxId, false);
 
+    unsigned numThreads = getNumWorkerThreads(builder.getOptions()->getuInt32Option(vISA_NumIntfThreads));
+    if (numThreads > 1 && useDenseMatrix() && liveAnalysis->livenessClass(G4_GRF) &&
+        !builder.getOption(vISA_GenerateDebugInfo) && kernel.fg.getNumBB() >= 2 * numThreads)
+    {
+        // Each worker scans a range of consecutive BBs into its own shard.
+        // The edges of a BB only depend on its live-out set, so ORing the
+        // shards into the matrix gives the same matrix as the serial build.
+        // The live range updates are replayed in BB order, which is the
+        // order the serial build makes them in.
+        std::vector<G4_BB*> bbs(kernel.fg.begin(), kernel.fg.end());
+        // a few shards per thread to balance BBs of different sizes
+        size_t numShards = std::min<size_t>(bbs.size(), 4 * numThreads);
+        std::vector<IntfShard> shards(numShards);
+        parallelScan = true;
+        runOnWorkerThreads(numThreads, numShards, [&](size_t idx)
+        {
+            curShard = &shards[idx];
+            BitSet bbLive(maxId, false);
+            for (size_t i = idx * bbs.size() / numShards, e = (idx + 1) * bbs.size() / numShards; i < e; i++)
+            {
+                G4_BB* bb = bbs[i];
+                curShard->recordEdges = cleanBBs == nullptr || !(*cleanBBs)[bb->getId()];
+                bbLive.clear();
+                buildInterferenceAtBBExit(bb, bbLive);
+                buildInterferenceWithinBB(bb, bbLive);
+            }
+            curShard = nullptr;
+        });
+        parallelScan = false;
+
+        for (IntfShard& shard : shards)
+        {
+            for (const IntfShard::MatrixBits& word : shard.edges)
+            {
+                setMatrixBits(word.row, word.col, word.bits);
+            }
+            curShard = &shard;
+            for (const LiveRangeUpdate& update : shard.updates)
+            {
+                applyLiveRangeUpdate(update);
+            }
+            curShard = nullptr;
+        }
+        return;
+    }
+
     for (G4_BB *bb : kernel.fg)
     {
+        // Edges of a clean BB were seeded from the previous iteration. It is
+        // still scanned since the scan also sets ref counts, forbidden regs
+        // and infinite spill cost candidates on the new live ranges.
+        recordEdges = cleanBBs == nullptr || !(*cleanBBs)[bb->getId()];
         //
         // mark all live ranges dead
         //
@@ -2430,6 +2595,308 @@ void Interference::computeInterference()
 
         buildInterferenceWithinBB(bb, live);
     }
+    recordEdges = true;
+}
+
+void Interference::getEdges(std::vector<std::pair<unsigned, unsigned>>& edges) const
+{
+    edges.clear();
+    if (useDenseMatrix())
+    {
+        for (unsigned row = 0; row < maxId; row++)
+        {
+            for (unsigned j = (row + 1) / BITS_DWORD; j < rowSize; j++)
+            {
+                const unsigned* word = getMatrixWord(row, j, false);
+                if (word == nullptr)
+                {
+                    // skip the rest of a tile without edges
+                    j |= tileRowWords - 1;
+                    continue;
+                }
+                unsigned intfBlk = *word;
+                for (unsigned k = 0; intfBlk != 0 && k < BITS_DWORD; k++)
+                {
+                    unsigned v2 = j * BITS_DWORD + k;
+                    if ((intfBlk & (1 << k)) && v2 != row)
+                    {
+                        edges.emplace_back(row, v2);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (unsigned v1 = 0; v1 < maxId; v1++)
+        {
+            for (unsigned v2 : sparseMatrix[v1])
+            {
+                edges.emplace_back(v1, v2);
+            }
+        }
+    }
+}
+
+static uint64_t hashInstList(G4_BB* bb)
+{
+    // FNV-1a over the instruction pointers: inserted, removed or replaced
+    // instructions change the hash
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const G4_INST* inst : *bb)
+    {
+        hash ^= (uint64_t)(uintptr_t)inst;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+//
+// Seed the matrix with the per-BB edges recorded in the previous GRA iteration
+// and mark the BBs whose edges are unaffected by the code inserted since.
+// A var is changed if it is new in this iteration (spill/fill temps), got
+// spilled, or is live out of some BB where it wasn't before (or the other way
+// round), e.g. builtinR0 once spill code uses it as the message header.
+// A BB is clean if its instruction list is the same, the vars live out of it
+// are the same, and it doesn't reference or have live out a changed var and
+// has no indirect access or call. Edges of changed vars are not carried over.
+// Returns false if no BB is clean.
+//
+bool Interference::seedFromPrevIteration(std::vector<bool>& cleanBBs)
+{
+    const IntfSnapshot& prev = gra.prevIntf;
+    const unsigned noId = UINT_MAX;
+    unsigned numBB = kernel.fg.getNumBB();
+    if (prev.liveOut.size() != numBB)
+    {
+        return false;
+    }
+
+    std::unordered_map<const G4_Declare*, unsigned> curIds;
+    for (unsigned i = 0; i < maxId; i++)
+    {
+        curIds[lrs[i]->getDcl()] = i;
+    }
+
+    // vars not carried over from the previous iteration
+    unsigned numPrevIds = (unsigned)prev.dcls.size();
+    BitSet changed(maxId, true);
+    std::vector<unsigned> remap(numPrevIds, noId);
+    for (unsigned i = 0; i < numPrevIds; i++)
+    {
+        auto it = curIds.find(prev.dcls[i]);
+        if (it != curIds.end() && prev.spilled.count(prev.dcls[i]) == 0)
+        {
+            remap[i] = it->second;
+            changed.set(it->second, false);
+        }
+    }
+
+    // Live-out sets of this iteration in previous var ids. A var whose bit
+    // differs from the previous iteration in any BB has changed liveness.
+    std::vector<BitSet> liveOut(numBB);
+    std::vector<bool> sameLiveOut(numBB, true);
+    std::vector<unsigned> toPrev(maxId, noId);
+    for (unsigned i = 0; i < numPrevIds; i++)
+    {
+        if (remap[i] != noId)
+        {
+            toPrev[remap[i]] = i;
+        }
+    }
+    BitSet prevIdLiveOut(numPrevIds, false);
+    BitSet prevBBLiveOut(numPrevIds, false);
+    for (G4_BB* bb : kernel.fg)
+    {
+        unsigned id = bb->getId();
+        liveOut[id] = liveAnalysis->use_out[id];
+        liveOut[id] &= liveAnalysis->def_out[id];
+
+        prevIdLiveOut.clear();
+        liveOut[id].forEachSetBit([&](unsigned v)
+        {
+            if (v < maxId && toPrev[v] != noId)
+            {
+                prevIdLiveOut.set(toPrev[v], true);
+            }
+        });
+        prevBBLiveOut.clear();
+        prev.liveOut[id].forEachSetBit([&](unsigned prevId)
+        {
+            if (prevId < numPrevIds && remap[prevId] != noId)
+            {
+                prevBBLiveOut.set(prevId, true);
+            }
+        });
+        if (prevBBLiveOut != prevIdLiveOut)
+        {
+            sameLiveOut[id] = false;
+            BitSet diff = prevBBLiveOut;
+            diff -= prevIdLiveOut;
+            prevIdLiveOut -= prevBBLiveOut;
+            diff |= prevIdLiveOut;
+            diff.forEachSetBit([&](unsigned prevId) { changed.set(remap[prevId], true); });
+        }
+    }
+
+    auto isChanged = [&](G4_Operand* opnd)
+    {
+        if (opnd == nullptr || !opnd->getBase() || !opnd->getBase()->isRegAllocPartaker())
+        {
+            return false;
+        }
+        if (opnd->getRegAccess() != Direct)
+        {
+            return true;
+        }
+        unsigned id = opnd->getBase()->asRegVar()->getId();
+        return id >= maxId || changed.isSet(id);
+    };
+
+    cleanBBs.assign(numBB, false);
+    unsigned numClean = 0;
+    for (G4_BB* bb : kernel.fg)
+    {
+        unsigned id = bb->getId();
+        BitSet& bbLiveOut = liveOut[id];
+        bbLiveOut &= changed;
+        bool clean = sameLiveOut[id] && bbLiveOut.isEmpty() && hashInstList(bb) == prev.instHash[id];
+        for (auto it = bb->begin(), ie = bb->end(); clean && it != ie; ++it)
+        {
+            G4_INST* inst = *it;
+            if (inst->opcode() == G4_pseudo_fcall || isChanged(inst->getDst()))
+            {
+                clean = false;
+                break;
+            }
+            for (unsigned j = 0; j < G4_MAX_SRCS; j++)
+            {
+                G4_Operand* src = inst->getSrc(j);
+                if (src && src->isSrcRegRegion() && isChanged(src))
+                {
+                    clean = false;
+                    break;
+                }
+            }
+        }
+        cleanBBs[id] = clean;
+        numClean += clean ? 1 : 0;
+    }
+
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--incremental intf: " << numClean << " of " << numBB << " BBs reused\n";
+    }
+
+    if (numClean == 0)
+    {
+        return false;
+    }
+
+    for (auto&& edge : prev.edges)
+    {
+        unsigned v1 = remap[edge.first];
+        unsigned v2 = remap[edge.second];
+        if (v1 != noId && v2 != noId && !changed.isSet(v1) && !changed.isSet(v2))
+        {
+            checkAndSetIntf(v1, v2);
+        }
+    }
+    return true;
+}
+
+void Interference::recordForNextIteration() const
+{
+    IntfSnapshot& snapshot = gra.prevIntf;
+    snapshot.clear();
+    snapshot.dcls.resize(maxId);
+    for (unsigned i = 0; i < maxId; i++)
+    {
+        snapshot.dcls[i] = lrs[i]->getDcl();
+    }
+    getEdges(snapshot.edges);
+
+    unsigned numBB = kernel.fg.getNumBB();
+    snapshot.liveOut.resize(numBB);
+    snapshot.instHash.resize(numBB);
+    for (G4_BB* bb : kernel.fg)
+    {
+        unsigned id = bb->getId();
+        snapshot.liveOut[id] = liveAnalysis->use_out[id];
+        snapshot.liveOut[id] &= liveAnalysis->def_out[id];
+        snapshot.instHash[id] = hashInstList(bb);
+    }
+}
+
+//
+// Rebuild the per-BB edges from scratch and compare them with the incremental
+// result. The reference scan runs on copies of the live ranges so their ref
+// counts and spill cost candidacy are not updated twice.
+//
+void Interference::verifyIncrementalInterference()
+{
+    std::vector<LiveRange> shadowLRs;
+    std::vector<LiveRange*> shadowPtrs(maxId);
+    shadowLRs.reserve(maxId);
+    for (unsigned i = 0; i < maxId; i++)
+    {
+        shadowLRs.push_back(*lrs[i]);
+        shadowPtrs[i] = &shadowLRs.back();
+    }
+    LiveRange** shadow = shadowPtrs.data();
+
+    vISA::Mem_Manager mem(GRAPH_COLOR_MEM_SIZE);
+    Interference ref(liveAnalysis, shadow, maxId, splitStartId, splitNum, gra);
+    ref.init(mem);
+    ref.buildInterferenceForBBs(nullptr);
+
+    std::vector<std::pair<unsigned, unsigned>> expected, actual;
+    ref.getEdges(expected);
+    getEdges(actual);
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    if (expected == actual)
+    {
+        return;
+    }
+
+    std::vector<std::pair<unsigned, unsigned>> missing, extra;
+    std::set_difference(expected.begin(), expected.end(), actual.begin(), actual.end(),
+        std::back_inserter(missing));
+    std::set_difference(actual.begin(), actual.end(), expected.begin(), expected.end(),
+        std::back_inserter(extra));
+    auto dumpEdges = [this](const char* kind, const std::vector<std::pair<unsigned, unsigned>>& edges)
+    {
+        for (auto&& edge : edges)
+        {
+            std::cerr << "\t" << kind << " edge: " << lrs[edge.first]->getDcl()->getName() <<
+                " - " << lrs[edge.second]->getDcl()->getName() << "\n";
+        }
+    };
+    std::cerr << "Incremental interference mismatch in " << kernel.getName() << "\n";
+    dumpEdges("missing", missing);
+    dumpEdges("extra", extra);
+    MUST_BE_TRUE(false, "incremental interference differs from full rebuild");
+}
+
+void Interference::computeInterference()
+{
+    startTimer(TimerID::INTERFERENCE);
+
+    // Only the GRF coloring loop records and reuses edges.
+    bool canReuse = gra.incrementalIntf && liveAnalysis->livenessClass(G4_GRF);
+    std::vector<bool> cleanBBs;
+    bool incremental = canReuse && gra.prevIntf.valid && seedFromPrevIteration(cleanBBs);
+    buildInterferenceForBBs(incremental ? &cleanBBs : nullptr);
+    if (incremental && builder.getOption(vISA_VerifyIncrementalIntf))
+    {
+        verifyIncrementalInterference();
+    }
+    if (canReuse)
+    {
+        // becomes valid once the spill code of this iteration is inserted
+        recordForNextIteration();
+    }
 
     if (kernel.getInt32KernelAttr(Attributes::ATTR_Target) != VISA_3D ||
         kernel.fg.builder->getOption(vISA_enablePreemption) ||
@@ -2483,11 +2950,17 @@ void Interference::generateSparseIntfGraph()
         // Iterate over intf graph matrix
         for (unsigned int row = 0; row < numVars; row++)
         {
-            unsigned int rowOffset = row*rowSize;
             unsigned int colStart = (row + 1) / BITS_DWORD;
             for (unsigned int j = colStart; j < rowSize; j++)
             {
-                unsigned int intfBlk = getInterferenceBlk(rowOffset + j);
+                const unsigned int* word = getMatrixWord(row, j, false);
+                if (word == nullptr)
+                {
+                    // skip the rest of a tile without edges
+                    j |= tileRowWords - 1;
+                    continue;
+                }
+                unsigned int intfBlk = *word;
                 if (intfBlk != 0)
                 {
                     for (unsigned k = 0; k < BITS_DWORD; k++)
@@ -2540,8 +3013,33 @@ void Interference::generateSparseIntfGraph()
         float avgNeighbor = ((float)numNeighbor) / sparseIntf.size();
         std::cout << "\t--avg # neighbors: " << std::setprecision(6) << avgNeighbor << "\n";
         std::cout << "\t--max # neighbors: " << maxNeighbor << " (" << lrs[maxIndex]->getDcl()->getName() << ")\n";
+        std::cout << "\t--intf graph size: " << getMemoryUsage() << " bytes";
+        if (useTiledMatrix())
+        {
+            std::cout << " (" << numAllocatedTiles << " tiles)";
+        }
+        std::cout << "\n";
     }
 
+#if COMPILER_STATS_ENABLE
+    CompilerStats& stats = builder.getcompilerStats();
+    int64_t peakBytes = std::max(stats.GetI64("IntfGraphPeakBytes", kernel.getSimdSize()),
+        (int64_t)getMemoryUsage());
+    stats.SetI64("IntfGraphPeakBytes", peakBytes, kernel.getSimdSize());
+#endif
+
+    // The graph is at its largest here; account it until it is destroyed.
+    size_t usage = getMemoryUsage();
+    if (usage > accountedBytes)
+    {
+        MemAccounting::add(MemOwner::Interference, usage - accountedBytes);
+    }
+    else
+    {
+        MemAccounting::sub(MemOwner::Interference, accountedBytes - usage);
+    }
+    accountedBytes = usage;
+
     stopTimer(TimerID::INTERFERENCE);
 }
 
@@ -5343,7 +5841,7 @@ GraphColor::GraphColor(LivenessAnalysis& live, unsigned totalGRF, bool hybrid, b
     gra(live.gra), totalGRFRegCount(totalGRF), numVar(live.getNumSelectedVar()), numSplitStartID(live.getNumSplitStartID()), numSplitVar(live.getNumSplitVar()),
     intf(&live, lrs, live.getNumSelectedVar(), live.getNumSplitStartID(), live.getNumSplitVar(), gra), regPool(gra.regPool),
     builder(gra.builder), isHybrid(hybrid),
-    forceSpill(forceSpill_), mem(GRAPH_COLOR_MEM_SIZE),
+    forceSpill(forceSpill_), mem(GRAPH_COLOR_MEM_SIZE, MemOwner::Interference),
     kernel(gra.kernel), liveAnalysis(live)
 {
     spAddrRegSig = (unsigned*)mem.alloc(getNumAddrRegisters() * sizeof(unsigned));
@@ -5633,6 +6131,7 @@ void GraphColor::relaxNeighborDegreeGRF(LiveRange* lr)
 
                 if (lrs_it->getDegree() + lrs_it->getNumRegNeeded() <= availColor)
                 {
+                    constrainedHeap.remove(it);
                     unconstrainedWorklist.push_back(lrs_it);
                     lrs_it->setActive(false);
                 }
@@ -5666,6 +6165,7 @@ void GraphColor::relaxNeighborDegreeARF(LiveRange* lr)
 
                 if (lrs_it->getDegree() + lrs_it->getNumRegNeeded() <= availColor)
                 {
+                    constrainedHeap.remove(it);
                     unconstrainedWorklist.push_back(lrs_it);
                     lrs_it->setActive(false);
                 }
@@ -5681,37 +6181,37 @@ static bool compareSpillCost(LiveRange* lr1, LiveRange* lr2)
         (lr1->getSpillCost() == lr2->getSpillCost() && lr1->getVar()->getId() < lr2->getVar()->getId());
 }
 
+bool GraphColor::SpillCostLess::operator()(unsigned id1, unsigned id2) const
+{
+    return compareSpillCost(lrs[id1], lrs[id2]);
+}
+
 //
 // All nodes in work list are all contrained (whose degree > max color)
-// find one contrained node and move it to order list
+// find the one with the lowest spill cost and move it to order list
 //
 void GraphColor::removeConstrained()
 {
-    if (!constrainedWorklist.empty())
+    if (!constrainedHeap.empty())
     {
-        LiveRange* lr = constrainedWorklist.front();
-        constrainedWorklist.pop_front();
-
-        if (lr->getActive())
-        {
+        LiveRange* lr = lrs[constrainedHeap.pop()];
 
 #ifdef DEBUG_VERBOSE_ON
-            DEBUG_VERBOSE(".... Remove Constrained ");
-            lr->dump();
-            DEBUG_VERBOSE(std::endl);
+        DEBUG_VERBOSE(".... Remove Constrained ");
+        lr->dump();
+        DEBUG_VERBOSE(std::endl);
 #endif
 
-            if (liveAnalysis.livenessClass(G4_GRF))
-            {
-                relaxNeighborDegreeGRF(lr);
-            }
-            else
-            {
-                relaxNeighborDegreeARF(lr);
-            }
-            colorOrder.push_back(lr);
-            lr->setActive(false);
+        if (liveAnalysis.livenessClass(G4_GRF))
+        {
+            relaxNeighborDegreeGRF(lr);
         }
+        else
+        {
+            relaxNeighborDegreeARF(lr);
+        }
+        colorOrder.push_back(lr);
+        lr->setActive(false);
     }
 }
 
@@ -5728,30 +6228,31 @@ void GraphColor::determineColorOrdering()
 
     unsigned numUnassignedVar = liveAnalysis.getNumUnassignedVar();
 
+    if (const char* graphFile = builder.getOptions()->getOptionCstr(vISA_DumpSimplifyGraph))
+    {
+        dumpSimplifyGraph(graphFile);
+    }
+
     //
-    // create an array for sorting live ranges
+    // split the live ranges into the unconstrained worklist and the
+    // constrained heap
     //
-    std::vector<LiveRange*> sorted;
-    sorted.reserve(numUnassignedVar);
+    unconstrainedWorklist.clear();
+    unconstrainedWorklist.reserve(numUnassignedVar);
+    unconstrainedHead = 0;
+    std::vector<unsigned> constrained;
+    colorOrder.reserve(colorOrder.size() + numUnassignedVar);
+
     unsigned j = 0;
     for (unsigned i = 0; i < numVar; i++)
     {
-        if (lrs[i]->getPhyReg() == nullptr && !lrs[i]->getIsPartialDcl())
+        LiveRange* lr = lrs[i];
+        if (lr->getPhyReg() != nullptr || lr->getIsPartialDcl())
         {
-            sorted.push_back(lrs[i]);
-            j++;
+            continue;
         }
-    }
-    MUST_BE_TRUE(j == numUnassignedVar, ERROR_GRAPHCOLOR);
-
-    //
-    // sort the live range array
-    //
-    std::sort(sorted.begin(), sorted.end(), compareSpillCost);
+        j++;
 
-    for (unsigned i = 0; i < numUnassignedVar; i++)
-    {
-        LiveRange* lr = sorted[i];
         unsigned availColor = numColor;
         availColor = numColor - lr->getNumForbidden();
 
@@ -5762,32 +6263,44 @@ void GraphColor::determineColorOrdering()
         }
         else
         {
-            constrainedWorklist.push_back(lr);
+            constrained.push_back(i);
             lr->setActive(true);
         }
     }
+    MUST_BE_TRUE(j == numUnassignedVar, ERROR_GRAPHCOLOR);
+
+    //
+    // Unconstrained ranges are removed cheapest first. Constrained ones only
+    // need to be ordered as they are picked, which the heap does.
+    //
+    std::sort(unconstrainedWorklist.begin(), unconstrainedWorklist.end(), compareSpillCost);
+    constrainedHeap.reset(numVar, SpillCostLess{ lrs });
+    constrainedHeap.assign(constrained);
 
 #ifdef DEBUG_VERBOSE_ON
     DEBUG_VERBOSE("\nSPILL COST" << std::endl);
-    for (unsigned i = 0; i < numUnassignedVar; i++)
+    for (unsigned i = 0; i < numVar; i++)
     {
-        sorted[i]->dump();
-        DEBUG_VERBOSE("\t spillCost=" << sorted[i]->getSpillCost());
-        DEBUG_VERBOSE("\t degree=" << sorted[i]->getDegree());
-        DEBUG_VERBOSE("\t refCnt=" << sorted[i]->getRefCount());
-        DEBUG_VERBOSE("\t size=" << sorted[i]->getDcl()->getByteSize());
+        if (lrs[i]->getPhyReg() != nullptr || lrs[i]->getIsPartialDcl())
+        {
+            continue;
+        }
+        lrs[i]->dump();
+        DEBUG_VERBOSE("\t spillCost=" << lrs[i]->getSpillCost());
+        DEBUG_VERBOSE("\t degree=" << lrs[i]->getDegree());
+        DEBUG_VERBOSE("\t refCnt=" << lrs[i]->getRefCount());
+        DEBUG_VERBOSE("\t size=" << lrs[i]->getDcl()->getByteSize());
         DEBUG_VERBOSE(std::endl);
     }
     DEBUG_VERBOSE(std::endl);
 #endif
 
-    while (!constrainedWorklist.empty() ||
-        !unconstrainedWorklist.empty())
+    while (!constrainedHeap.empty() ||
+        unconstrainedHead < unconstrainedWorklist.size())
     {
-        while (!unconstrainedWorklist.empty())
+        while (unconstrainedHead < unconstrainedWorklist.size())
         {
-            LiveRange* lr = unconstrainedWorklist.front();
-            unconstrainedWorklist.pop_front();
+            LiveRange* lr = unconstrainedWorklist[unconstrainedHead++];
 
 #ifdef DEBUG_VERBOSE_ON
             DEBUG_VERBOSE(".... Remove Unconstrained ");
@@ -5810,6 +6323,59 @@ void GraphColor::determineColorOrdering()
     }
 }
 
+//
+// Append the graph the color order is computed from to fileName, in the
+// format vISABench's colororder benchmark replays:
+//   graph <nodes> <colors> <1 for GRF, which counts forbidden regs when relaxing>
+//   n <degree> <regs needed> <forbidden regs> <spill cost>   (one per node)
+//   e <from> <to> <weight>   removing from subtracts weight from to's degree
+//   end
+// Nodes are the unassigned live ranges in id order.
+//
+void GraphColor::dumpSimplifyGraph(const char* fileName)
+{
+    std::vector<unsigned> nodeIdx(numVar, UINT_MAX);
+    std::vector<LiveRange*> nodes;
+    for (unsigned i = 0; i < numVar; i++)
+    {
+        if (lrs[i]->getPhyReg() == nullptr && !lrs[i]->getIsPartialDcl())
+        {
+            nodeIdx[i] = (unsigned)nodes.size();
+            nodes.push_back(lrs[i]);
+        }
+    }
+
+    bool isGRF = liveAnalysis.livenessClass(G4_GRF);
+    std::ofstream out(fileName, std::ios::app);
+    out << "graph " << nodes.size() << " " << numColor << " " << isGRF << "\n";
+    out << std::setprecision(9);
+    for (LiveRange* lr : nodes)
+    {
+        out << "n " << lr->getDegree() << " " << lr->getNumRegNeeded() << " " <<
+            lr->getNumForbidden() << " " << lr->getSpillCost() << "\n";
+    }
+    for (LiveRange* lr : nodes)
+    {
+        // same filters as relaxNeighborDegreeGRF/ARF
+        if (lr->getIsPseudoNode() || (isGRF && lr->getIsPartialDcl()))
+        {
+            continue;
+        }
+        unsigned id = lr->getVar()->getId();
+        for (unsigned neighbor : intf.getSparseIntfForVar(id))
+        {
+            LiveRange* nlr = lrs[neighbor];
+            if (nodeIdx[neighbor] == UINT_MAX || nlr->getIsPseudoNode())
+            {
+                continue;
+            }
+            unsigned w = isGRF ? edgeWeightGRF(nlr, lr) : edgeWeightARF(nlr, lr);
+            out << "e " << nodeIdx[id] << " " << nodeIdx[neighbor] << " " << w << "\n";
+        }
+    }
+    out << "end\n";
+}
+
 void PhyRegUsage::updateRegUsage(LiveRange* lr)
 {
     G4_Declare* dcl = lr->getDcl();
@@ -9037,6 +9603,7 @@ void GlobalRA::addrRegAlloc()
         {
             std::cout << "--address RA iteration " << iterationNo << "\n";
         }
+        CompileTrace::Scope iterationScope("Address RA iteration", "vISA", "iteration", iterationNo);
         //
         // choose reg vars whose reg file kind is ARF
         //
@@ -9114,6 +9681,7 @@ void GlobalRA::flagRegAlloc()
         {
             std::cout << "--flag RA iteration " << iterationNo << "\n";
         }
+        CompileTrace::Scope iterationScope("Flag RA iteration", "vISA", "iteration", iterationNo);
 
         //
         // choose reg vars whose reg file kind is FLAG
@@ -9367,6 +9935,52 @@ bool canDoLRA(G4_Kernel& kernel)
     return ret;
 }
 
+// Report the scratch space used by spill code once it has been expanded and
+// record it, together with the weighted spill/fill count, in the jit info.
+void GlobalRA::updateSpillInfo(uint32_t spillSize, uint32_t GRFSpillFillCount)
+{
+    // this includes vISA's scratch space use only and does not include whatever IGC may use for private memory
+    uint32_t spillMemUsed = std::max(this->actualSpillSize, spillSize);
+    if (spillMemUsed)
+    {
+        builder.criticalMsgStream() << "Spill memory used = " << spillMemUsed << " bytes for kernel " <<
+            kernel.getName() << "\n Compiling kernel with spill code may degrade performance." <<
+            " Please consider rewriting the kernel to use less registers.\n";
+    }
+
+    // update jit metadata information for spill
+    if (auto jitInfo = builder.getJitInfo())
+    {
+        jitInfo->isSpill = spillMemUsed > 0;
+        jitInfo->hasStackcalls = kernel.fg.getHasStackCalls();
+
+        if (builder.kernel.fg.frameSizeInOWord != 0) {
+            // jitInfo->spillMemUsed is the entire visa stack size. Consider the caller/callee
+            // save size if having caller/callee save
+            // globalScratchOffset in unit of byte, others in Oword
+            //
+            //                               vISA stack
+            //  globalScratchOffset     -> ---------------------
+            //  FIXME: should be 0-based   |  spill            |
+            //                             |                   |
+            //  calleeSaveAreaOffset    -> ---------------------
+            //                             |  callee save      |
+            //  callerSaveAreaOffset    -> ---------------------
+            //                             |  caller save      |
+            //  paramOverflowAreaOffset -> ---------------------
+            jitInfo->spillMemUsed =
+                builder.kernel.fg.frameSizeInOWord * 16;
+
+            // reserve spillMemUsed #bytes before 8kb boundary
+            kernel.getGTPinData()->setScratchNextFree(8*1024 - kernel.getGTPinData()->getNumBytesScratchUse());
+        } else {
+            jitInfo->spillMemUsed = spillMemUsed;
+            kernel.getGTPinData()->setScratchNextFree(spillMemUsed);
+        }
+        jitInfo->numGRFSpillFill = GRFSpillFillCount;
+    }
+}
+
 //
 // graph coloring entry point.  returns nonzero if RA fails
 //
@@ -9431,6 +10045,7 @@ int GlobalRA::coloringRegAlloc()
     }
 
     bool fastCompile = (builder.getOption(vISA_FastCompileRA) || builder.getOption(vISA_HybridRAWithSpill)) && !hasStackCall;
+    uint32_t linearScanSpillSize = 0;
     if (!isReRAPass() && canDoLRA(kernel))
     {
         //Global linear scan RA
@@ -9446,11 +10061,10 @@ int GlobalRA::coloringRegAlloc()
             int  success = lra.doLinearScanRA();
             if (success == VISA_SUCCESS)
             {
-                // TODO: Get correct spillSize from LinearScanRA
-                unsigned int spillSize = 0;
-                expandSpillFillIntrinsics(spillSize);
+                expandSpillFillIntrinsics(lra.getSpillSize());
                 assignRegForAliasDcl();
                 computePhyReg();
+                updateSpillInfo(lra.getSpillSize(), lra.getGRFSpillFillCount());
                 if (builder.getOption(vISA_verifyLinearScan))
                 {
                     resetGlobalRAStates();
@@ -9476,6 +10090,12 @@ int GlobalRA::coloringRegAlloc()
             {
                 return VISA_SPILL;
             }
+
+            // Linear scan spills whatever it cannot assign, so it only gets
+            // here if it still spills after MAXIMAL_ITERATIONS. Graph coloring
+            // then takes over; spill code already inserted by linear scan stays
+            // in the program, so graph coloring must not reuse its slots.
+            linearScanSpillSize = lra.getSpillSize();
         }
         else if (builder.getOption(vISA_LocalRA) && !hasStackCall)
         {
@@ -9530,6 +10150,8 @@ int GlobalRA::coloringRegAlloc()
         nextSpillOffset += 32;
         scratchOffset += 32;
     }
+    nextSpillOffset = std::max(nextSpillOffset, linearScanSpillSize);
+    scratchOffset = std::max(scratchOffset, linearScanSpillSize);
 
     uint32_t GRFSpillFillCount = 0;
     uint32_t sendAssociatedGRFSpillFillCount = 0;
@@ -9541,13 +10163,19 @@ int GlobalRA::coloringRegAlloc()
     unsigned failSafeRAIteration = (builder.getOption(vISA_FastSpill) || fastCompile) ? fastCompileIter : FAIL_SAFE_RA_LIMIT;
 
     bool rematDone = false;
+    bool loopSplitDone = false;
     VarSplit splitPass(*this);
+    incrementalIntf = builder.getOption(vISA_IncrementalIntf);
+    prevIntf.clear();
+    incrementalLiveness = builder.getOption(vISA_IncrementalLiveness);
+    prevLiveness.clear();
     while (iterationNo < maxRAIterations)
     {
         if (builder.getOption(vISA_RATrace))
         {
             std::cout << "--GRF RA iteration " << iterationNo << "--" << kernel.getName() << "\n";
         }
+        CompileTrace::Scope iterationScope("GRF RA iteration", "vISA", "iteration", iterationNo);
         setIterNo(iterationNo);
 
         if (!builder.getOption(vISA_HybridRAWithSpill))
@@ -9667,6 +10295,7 @@ int GlobalRA::coloringRegAlloc()
                     (kernel.getOption(vISA_ForceRemat) || runRemat);
                 bool rematChange = false;
                 bool globalSplitChange = false;
+                bool loopSplitChange = false;
 
                 if (!rematDone &&
                     rematOn)
@@ -9716,7 +10345,23 @@ int GlobalRA::coloringRegAlloc()
                 }
 
                 if (iterationNo == 0 &&
-                    (rematChange || globalSplitChange))
+                    !loopSplitDone &&
+                    builder.getOption(vISA_LoopSplit) &&
+                    !kernel.getOption(vISA_Debug) &&
+                    !fastCompile)
+                {
+                    LoopVarSplit loopSplit(kernel, liveAnalysis, coloring, *this);
+                    loopSplit.run();
+                    loopSplitDone = true;
+                    loopSplitChange = loopSplit.getChangesMade();
+                    if (builder.getOption(vISA_RATrace))
+                    {
+                        std::cout << "\t--loop split: " << loopSplit.getNumSplits() << " variables\n";
+                    }
+                }
+
+                if (iterationNo == 0 &&
+                    (rematChange || globalSplitChange || loopSplitChange))
                 {
                     continue;
                 }
@@ -9802,7 +10447,6 @@ int GlobalRA::coloringRegAlloc()
                 bool success = spillGRF.insertSpillFillCode(&kernel, pointsToAnalysis);
                 nextSpillOffset = spillGRF.getNextOffset();
 
-
                 if (builder.getOption(vISA_RATrace))
                 {
                     auto&& spills = coloring.getSpilledLiveRanges();
@@ -9840,6 +10484,18 @@ int GlobalRA::coloringRegAlloc()
                     c.run();
                 }
 
+                if (incrementalIntf)
+                {
+                    // Spill code and its coalescing are the only IR changes
+                    // since the edges were recorded, so the next iteration
+                    // may reuse them for the BBs they left alone.
+                    for (auto lr : coloring.getSpilledLiveRanges())
+                    {
+                        prevIntf.spilled.insert(lr->getDcl());
+                    }
+                    prevIntf.valid = true;
+                }
+
                 if (iterationNo == FAIL_SAFE_RA_LIMIT)
                 {
                     if (coloring.getSpilledLiveRanges().size() < 2)
@@ -9917,6 +10573,11 @@ int GlobalRA::coloringRegAlloc()
         }
     }
 
+    incrementalIntf = false;
+    prevIntf.clear();
+    incrementalLiveness = false;
+    prevLiveness.clear();
+
     assignRegForAliasDcl();
     computePhyReg();
 
@@ -9951,46 +10612,7 @@ int GlobalRA::coloringRegAlloc()
         return VISA_SPILL;
     }
 
-    // this includes vISA's scratch space use only and does not include whatever IGC may use for private memory
-    uint32_t spillMemUsed = std::max(this->actualSpillSize, nextSpillOffset);
-    if (spillMemUsed)
-    {
-        builder.criticalMsgStream() << "Spill memory used = " << spillMemUsed << " bytes for kernel " <<
-            kernel.getName() << "\n Compiling kernel with spill code may degrade performance." <<
-            " Please consider rewriting the kernel to use less registers.\n";
-    }
-
-    // update jit metadata information for spill
-    if (auto jitInfo = builder.getJitInfo())
-    {
-        jitInfo->isSpill = spillMemUsed > 0;
-        jitInfo->hasStackcalls = kernel.fg.getHasStackCalls();
-
-        if (builder.kernel.fg.frameSizeInOWord != 0) {
-            // jitInfo->spillMemUsed is the entire visa stack size. Consider the caller/callee
-            // save size if having caller/callee save
-            // globalScratchOffset in unit of byte, others in Oword
-            //
-            //                               vISA stack
-            //  globalScratchOffset     -> ---------------------
-            //  FIXME: should be 0-based   |  spill            |
-            //                             |                   |
-            //  calleeSaveAreaOffset    -> ---------------------
-            //                             |  callee save      |
-            //  callerSaveAreaOffset    -> ---------------------
-            //                             |  caller save      |
-            //  paramOverflowAreaOffset -> ---------------------
-            jitInfo->spillMemUsed =
-                builder.kernel.fg.frameSizeInOWord * 16;
-
-            // reserve spillMemUsed #bytes before 8kb boundary
-            kernel.getGTPinData()->setScratchNextFree(8*1024 - kernel.getGTPinData()->getNumBytesScratchUse());
-        } else {
-            jitInfo->spillMemUsed = spillMemUsed;
-            kernel.getGTPinData()->setScratchNextFree(spillMemUsed);
-        }
-        jitInfo->numGRFSpillFill = GRFSpillFillCount;
-    }
+    updateSpillInfo(nextSpillOffset, GRFSpillFillCount);
 
     if (builder.getOption(vISA_LocalDeclareSplitInGlobalRA))
     {
@@ -37,6 +37,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RPE.h"
 #include "BitSet.h"
 #include "VarSplit.h"
+#include "IndexedHeap.h"
 
 #define BITS_DWORD 32
 #define SCRATCH_MSG_LIMIT (128 * 1024)
@@ -375,6 +376,71 @@ namespace vISA
         std::vector<std::unordered_set<uint32_t> > sparseMatrix;
         static const uint32_t denseMatrixLimit = 0x80000;
 
+        // From tiledMatrixLimit vars on, the bit matrix is not allocated as
+        // one block. Its upper half is split into tileSize x tileSize tiles
+        // that are allocated on the first edge set in them, so parts of the
+        // graph without edges take no memory.
+        static const uint32_t tiledMatrixLimit = 0x2000;
+        static const unsigned tileSize = 256;
+        static const unsigned tileRowWords = tileSize / BITS_DWORD;
+        unsigned numTileCols = 0;
+        std::unique_ptr<unsigned int*[]> tiles;
+        unsigned numAllocatedTiles = 0;
+        // Graph bytes currently reported to MemAccounting
+        size_t accountedBytes = 0;
+
+        unsigned int* allocateTile(unsigned tileIdx);
+        void freeTiles();
+
+        // Edges are dropped while this is false. Used when rescanning BBs
+        // whose edges were carried over from the previous GRA iteration.
+        bool recordEdges = true;
+        // Set while worker threads scan different BBs. Each worker then
+        // writes to its own shard (see IntfShard), and the shards are merged
+        // in BB order once all workers are done.
+        bool parallelScan = false;
+
+        // A live range update made by the scan of a BB. Workers log them
+        // instead of updating the shared live ranges, and the logs are
+        // replayed in BB order since some updates (e.g., the infinite spill
+        // cost check) read the ref count accumulated so far.
+        struct LiveRangeUpdate
+        {
+            enum Kind { RefCount, Forbidden, EOTSrc, RetIp, InfiniteSpillCost, CalleeSaveBias };
+            Kind kind;
+            unsigned id;
+            unsigned arg0;
+            unsigned arg1;
+            G4_BB* bb;
+            std::list<G4_INST*>::reverse_iterator it;
+        };
+
+        // Output of a worker scanning a contiguous range of BBs.
+        struct IntfShard
+        {
+            struct MatrixBits
+            {
+                unsigned row;
+                unsigned col;
+                unsigned bits;
+            };
+            std::vector<MatrixBits> edges;
+            std::vector<LiveRangeUpdate> updates;
+            // live sets of the CalleeSaveBias updates
+            std::vector<BitSet> calleeSaveLive;
+            bool recordEdges = true;
+        };
+        // Shard of the BBs scanned by the current thread during a parallel scan
+        static _THREAD IntfShard* curShard;
+
+        bool recordsEdges() const
+        {
+            return parallelScan ? curShard->recordEdges : recordEdges;
+        }
+        void updateLiveRange(LiveRangeUpdate::Kind kind, unsigned id, unsigned arg0 = 0, unsigned arg1 = 0,
+            G4_BB* bb = nullptr, std::list<G4_INST*>::reverse_iterator it = {});
+        void applyLiveRangeUpdate(const LiveRangeUpdate& update);
+
         static void updateLiveness(BitSet& live, uint32_t id, bool val)
         {
             live.set(id, val);
@@ -382,15 +448,22 @@ namespace vISA
 
         G4_Declare* getGRFDclForHRA(int GRFNum) const;
 
+        void buildInterferenceForBBs(const std::vector<bool>* cleanBBs);
+        bool seedFromPrevIteration(std::vector<bool>& cleanBBs);
+        void recordForNextIteration() const;
+        void verifyIncrementalInterference();
+
     public:
         Interference(LivenessAnalysis* l, LiveRange**& lr, unsigned n, unsigned ns, unsigned nm,
             GlobalRA& g);
 
         ~Interference()
         {
+            MemAccounting::sub(MemOwner::Interference, accountedBytes);
             if (useDenseMatrix())
             {
                 delete[] matrix;
+                freeTiles();
             }
         }
 
@@ -410,7 +483,13 @@ namespace vISA
 
         void init(vISA::Mem_Manager& m)
         {
-            if (useDenseMatrix())
+            if (useTiledMatrix())
+            {
+                numTileCols = (rowSize + tileRowWords - 1) / tileRowWords;
+                size_t numTiles = (size_t)numTileCols * (maxId / tileSize + 1);
+                tiles.reset(new unsigned int*[numTiles]()); // zero-initialize
+            }
+            else if (useDenseMatrix())
             {
                 auto N = (size_t)rowSize * (size_t)maxId;
                 matrix = new uint32_t[N](); // zero-initialize
@@ -421,16 +500,52 @@ namespace vISA
             }
         }
 
+        // True if edges are kept in a bit matrix, either flat or tiled.
         bool useDenseMatrix() const
         {
             return maxId < denseMatrixLimit;
         }
 
+        bool useTiledMatrix() const
+        {
+            return useDenseMatrix() && maxId >= tiledMatrixLimit;
+        }
+
+        // Returns the matrix word holding the bits for vars
+        // [col * BITS_DWORD, (col + 1) * BITS_DWORD) in row v1. For the tiled
+        // matrix, returns nullptr if the word's tile has no edges yet and
+        // create is false.
+        inline unsigned int* getMatrixWord(unsigned v1, unsigned col, bool create) const
+        {
+            if (!useTiledMatrix())
+            {
+                return &matrix[(size_t)v1 * rowSize + col];
+            }
+            unsigned tileIdx = (v1 / tileSize) * numTileCols + col / tileRowWords;
+            unsigned int* tile = tiles[tileIdx];
+            if (tile == nullptr)
+            {
+                if (!create)
+                {
+                    return nullptr;
+                }
+                tile = const_cast<Interference*>(this)->allocateTile(tileIdx);
+            }
+            return &tile[(v1 % tileSize) * tileRowWords + col % tileRowWords];
+        }
+
+        // Bytes currently used to store the graph.
+        size_t getMemoryUsage() const;
+
         // Clean data filled while computing interference.
         void clear()
         {
             sparseIntf.clear();
-            if (useDenseMatrix())
+            if (useTiledMatrix())
+            {
+                freeTiles();
+            }
+            else if (useDenseMatrix())
             {
                 auto N = (size_t)rowSize * (size_t)maxId;
                 std::memset(matrix, 0, N * sizeof(int));
@@ -446,22 +561,39 @@ namespace vISA
 
         void computeInterference();
         bool interfereBetween(unsigned v1, unsigned v2) const;
-        inline unsigned int getInterferenceBlk(unsigned idx) const
+        // Returns all edges (v1, v2) with v1 < v2 currently in the matrix.
+        void getEdges(std::vector<std::pair<unsigned, unsigned>>& edges) const;
+        inline unsigned int getInterferenceBlk(unsigned v1, unsigned col) const
         {
             assert(useDenseMatrix() && "matrix is not initialized");
-            return matrix != nullptr ? matrix[idx] : 0;
+            const unsigned int* word = getMatrixWord(v1, col, false);
+            return word != nullptr ? *word : 0;
         }
 
         const std::vector<unsigned int>& getSparseIntfForVar(unsigned int id) const { return sparseIntf[id]; }
 
+        inline void setMatrixBits(unsigned v1, unsigned col, unsigned int bits)
+        {
+            if (parallelScan)
+            {
+                curShard->edges.push_back({ v1, col, bits });
+                return;
+            }
+            *getMatrixWord(v1, col, true) |= bits;
+        }
+
         // Only upper-half matrix is now used in intf graph.
         inline void safeSetInterference(unsigned v1, unsigned v2)
         {
+            if (!recordsEdges())
+            {
+                return;
+            }
             // Assume v1 < v2
             if (useDenseMatrix())
             {
                 unsigned col = v2 / BITS_DWORD;
-                matrix[v1 * rowSize + col] |= 1 << (v2 % BITS_DWORD);
+                setMatrixBits(v1, col, 1 << (v2 % BITS_DWORD));
             }
             else
             {
@@ -471,13 +603,17 @@ namespace vISA
 
         inline void setBlockInterferencesOneWay(unsigned v1, unsigned col, unsigned block)
         {
+            if (!recordsEdges())
+            {
+                return;
+            }
             if (useDenseMatrix())
             {
 #ifdef _DEBUG
                 MUST_BE_TRUE(sparseIntf.size() == 0, "Updating intf graph matrix after populating sparse intf graph");
 #endif
 
-                matrix[v1 * rowSize + col] |= block;
+                setMatrixBits(v1, col, block);
             }
             else
             {
@@ -580,9 +716,22 @@ namespace vISA
         G4_Kernel& kernel;
         LivenessAnalysis& liveAnalysis;
 
+        // Orders live range ids by spill cost, ties broken by id.
+        struct SpillCostLess
+        {
+            LiveRange** lrs;
+            bool operator()(unsigned id1, unsigned id2) const;
+        };
+
         std::vector<LiveRange*> colorOrder;
-        LIVERANGE_LIST unconstrainedWorklist;
-        LIVERANGE_LIST constrainedWorklist;
+        // Simplify worklists. Unconstrained ranges are only appended while
+        // the color order is built, so they are kept in a vector consumed
+        // from a head index. Constrained ranges are kept in a heap by spill
+        // cost, and a range is removed from it in place as soon as removing
+        // its neighbors makes it unconstrained.
+        std::vector<LiveRange*> unconstrainedWorklist;
+        size_t unconstrainedHead = 0;
+        IndexedHeap<SpillCostLess> constrainedHeap;
         unsigned int numColor = 0;
 
 #define GRAPH_COLOR_MEM_SIZE 16*1024
@@ -593,6 +742,7 @@ namespace vISA
         void computeDegreeForARF();
         void computeSpillCosts(bool useSplitLLRHeuristic);
         void determineColorOrdering();
+        void dumpSimplifyGraph(const char* fileName);
         void removeConstrained();
         void relaxNeighborDegreeGRF(LiveRange* lr);
         void relaxNeighborDegreeARF(LiveRange* lr);
@@ -714,6 +864,32 @@ namespace vISA
         bool isClobbered(LiveRange* lr, std::string& msg);
     };
 
+    // Edges built by the per-BB interference scan of the last GRA iteration.
+    // Var ids are renumbered every iteration, so the edges are remapped
+    // through the declares when the next iteration reuses them.
+    struct IntfSnapshot
+    {
+        // Set once spill code for the recorded iteration has been inserted.
+        bool valid = false;
+        std::vector<const G4_Declare*> dcls;
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        std::unordered_set<const G4_Declare*> spilled;
+        // Per BB id, the vars live out of the BB and a hash of its
+        // instruction list, to find the BBs the spill code didn't touch.
+        std::vector<BitSet> liveOut;
+        std::vector<uint64_t> instHash;
+
+        void clear()
+        {
+            valid = false;
+            dcls.clear();
+            edges.clear();
+            spilled.clear();
+            liveOut.clear();
+            instHash.clear();
+        }
+    };
+
     class GlobalRA
     {
     public:
@@ -744,6 +920,7 @@ namespace vISA
         void expandSpillIntrinsic(G4_BB*);
         void expandFillIntrinsic(G4_BB*);
         void expandSpillFillIntrinsics(unsigned int);
+        void updateSpillInfo(uint32_t spillSize, uint32_t GRFSpillFillCount);
 
         static const RAVarInfo defaultValues;
         std::vector<RAVarInfo> vars;
@@ -795,6 +972,9 @@ namespace vISA
 
         uint32_t numGRFSpill = 0;
         uint32_t numGRFFill = 0;
+        // spill/fill sends placed in loop bodies
+        uint32_t numGRFSpillInLoop = 0;
+        uint32_t numGRFFillInLoop = 0;
 
         // kernel's spill size
         // We need this because spill code cleanup may result in OOB fill/spill during coalescing.
@@ -826,6 +1006,13 @@ namespace vISA
         PointsToAnalysis& pointsToAnalysis;
         FCALL_RET_MAP fcallRetMap;
 
+        // Only set while the GRF coloring loop runs with -incrementalIntf.
+        bool incrementalIntf = false;
+        IntfSnapshot prevIntf;
+        // Only set while the GRF coloring loop runs with -incrementalLiveness.
+        bool incrementalLiveness = false;
+        LivenessSnapshot prevLiveness;
+
 
         VarSplitPass* getVarSplitPass() const { return kernel.getVarSplitPass(); }
 
@@ -0,0 +1,164 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#ifndef _INDEXEDHEAP_H_
+#define _INDEXEDHEAP_H_
+
+#include <cassert>
+#include <vector>
+
+namespace vISA
+{
+// Binary min-heap of ids in [0, n) ordered by Less. Unlike
+// std::priority_queue, it tracks where each id is, so an id can be removed or
+// moved after its key changed in O(log n).
+template <typename Less>
+class IndexedHeap
+{
+    static const unsigned notInHeap = ~0u;
+
+    std::vector<unsigned> heap;
+    // position of each id in heap, or notInHeap
+    std::vector<unsigned> pos;
+    Less less;
+
+    void place(unsigned i, unsigned id)
+    {
+        heap[i] = id;
+        pos[id] = i;
+    }
+
+    void siftUp(unsigned i)
+    {
+        unsigned id = heap[i];
+        while (i > 0)
+        {
+            unsigned parent = (i - 1) / 2;
+            if (!less(id, heap[parent]))
+            {
+                break;
+            }
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, id);
+    }
+
+    void siftDown(unsigned i)
+    {
+        unsigned id = heap[i];
+        unsigned size = (unsigned)heap.size();
+        while (2 * i + 1 < size)
+        {
+            unsigned child = 2 * i + 1;
+            if (child + 1 < size && less(heap[child + 1], heap[child]))
+            {
+                child++;
+            }
+            if (!less(heap[child], id))
+            {
+                break;
+            }
+            place(i, heap[child]);
+            i = child;
+        }
+        place(i, id);
+    }
+
+public:
+    explicit IndexedHeap(Less l = Less()) : less(l) {}
+
+    // Empties the heap and sets the range of ids to [0, n).
+    void reset(unsigned n, Less l)
+    {
+        heap.clear();
+        pos.assign(n, notInHeap);
+        less = l;
+    }
+
+    // Replaces the content with ids in O(ids.size()).
+    void assign(const std::vector<unsigned>& ids)
+    {
+        for (unsigned id : heap)
+        {
+            pos[id] = notInHeap;
+        }
+        heap = ids;
+        for (unsigned i = 0; i < heap.size(); i++)
+        {
+            pos[heap[i]] = i;
+        }
+        for (unsigned i = (unsigned)heap.size() / 2; i-- > 0;)
+        {
+            siftDown(i);
+        }
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(unsigned id) const { return pos[id] != notInHeap; }
+    unsigned top() const { return heap.front(); }
+
+    void push(unsigned id)
+    {
+        assert(!contains(id) && "id is already in the heap");
+        heap.push_back(id);
+        siftUp((unsigned)heap.size() - 1);
+    }
+
+    unsigned pop()
+    {
+        unsigned id = heap.front();
+        remove(id);
+        return id;
+    }
+
+    void remove(unsigned id)
+    {
+        unsigned i = pos[id];
+        assert(i != notInHeap && "id is not in the heap");
+        pos[id] = notInHeap;
+        unsigned last = heap.back();
+        heap.pop_back();
+        if (last != id)
+        {
+            place(i, last);
+            update(last);
+        }
+    }
+
+    // Restores the heap order after the key of id changed.
+    void update(unsigned id)
+    {
+        unsigned i = pos[id];
+        siftUp(i);
+        siftDown(pos[id]);
+    }
+};
+}
+
+#endif // _INDEXEDHEAP_H_
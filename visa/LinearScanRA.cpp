@@ -941,7 +941,6 @@ int LinearScanRA::linearScanRA()
 
     std::list<LSLiveRange*> spillLRs;
     int iterator = 0;
-    uint32_t GRFSpillFillCount = 0;
     bool hasStackCall = kernel.fg.getHasStackCalls() || kernel.fg.getIsStackCallFunc();
     int globalScratchOffset = kernel.getInt32KernelAttr(Attributes::ATTR_SpillMemOffset);
     bool useScratchMsgForSpill = !hasStackCall && (globalScratchOffset < (int)(SCRATCH_MSG_LIMIT * 0.6));
@@ -1049,39 +1048,6 @@ int LinearScanRA::linearScanRA()
                 GRFSpillFillCount += lr->getNumRefs();
             }
 
-            // update jit metadata information for spill
-            if (auto jitInfo = builder.getJitInfo())
-            {
-                jitInfo->isSpill = nextSpillOffset > 0;
-                jitInfo->hasStackcalls = kernel.fg.getHasStackCalls();
-
-                if (builder.kernel.fg.frameSizeInOWord != 0) {
-                    // jitInfo->spillMemUsed is the entire visa stack size. Consider the caller/callee
-                    // save size if having caller/callee save
-                    // globalScratchOffset in unit of byte, others in Oword
-                    //
-                    //                               vISA stack
-                    //  globalScratchOffset     -> ---------------------
-                    //  FIXME: should be 0-based   |  spill            |
-                    //                             |                   |
-                    //  calleeSaveAreaOffset    -> ---------------------
-                    //                             |  callee save      |
-                    //  callerSaveAreaOffset    -> ---------------------
-                    //                             |  caller save      |
-                    //  paramOverflowAreaOffset -> ---------------------
-                    jitInfo->spillMemUsed =
-                        builder.kernel.fg.frameSizeInOWord * 16;
-
-                    // reserve spillMemUsed #bytes before 8kb boundary
-                    kernel.getGTPinData()->setScratchNextFree(8 * 1024 - kernel.getGTPinData()->getNumBytesScratchUse());
-                }
-                else {
-                    jitInfo->spillMemUsed = nextSpillOffset;
-                    kernel.getGTPinData()->setScratchNextFree(nextSpillOffset);
-                }
-                jitInfo->numGRFSpillFill = GRFSpillFillCount;
-            }
-
             undoLinearScanRAAssignments();
         }
 
@@ -1169,6 +1135,15 @@ int LinearScanRA::doLinearScanRA()
     pregs = &phyRegs;
     preRAAnalysis();
 
+    if (builder.getOption(vISA_LocalBankConflictReduction) && builder.hasBankCollision())
+    {
+        // Allocation advances round-robin unless first fit is requested.
+        bool doRoundRobin = !builder.getOption(vISA_LSFristFit);
+        bool reduceBCInTAandFF = false;
+        bool reduceBCInRR = bc.setupBankConflictsForKernel(doRoundRobin, reduceBCInTAandFF, numRegLRA, highInternalConflict);
+        doBCR = doRoundRobin ? reduceBCInRR : reduceBCInTAandFF;
+    }
+
     int success = linearScanRA();
 
     if (success == VISA_SUCCESS)
@@ -2223,7 +2198,10 @@ bool globalLinearScan::runLinearScan(IR_Builder& builder, std::vector<LSLiveRang
                     COUT_ERROR << "Failed assigned physical register to " << lr->getTopDcl()->getName() << ", rows :" << lr->getTopDcl()->getNumRows() << std::endl;
                     printActives();
 #endif
-                    return false;
+                    // The freed registers still don't fit lr (e.g., alignment);
+                    // spill lr as well rather than giving up on linear scan,
+                    // which would restart RA with graph coloring.
+                    spillLRs.push_back(lr);
                 }
                 else
                 {
@@ -2703,7 +2681,16 @@ void globalLinearScan::expireInputRanges(unsigned int global_idx)
 BankAlign globalLinearScan::getBankAlign(LSLiveRange* lr)
 {
     G4_Declare* dcl = lr->getTopDcl();
-    BankAlign bankAlign = gra.isEvenAligned(dcl) ? BankAlign::Even : BankAlign::Either;
+    BankAlign bankAlign = BankAlign::Either;
+    if (doBankConflict &&
+        gra.getBankConflict(dcl) != BANK_CONFLICT_NONE)
+    {
+        bankAlign = gra.getBankAlign(dcl);
+    }
+    if (bankAlign == BankAlign::Either)
+    {
+        bankAlign = gra.isEvenAligned(dcl) ? BankAlign::Even : BankAlign::Either;
+    }
 
     if (gra.getVarSplitPass()->isPartialDcl(lr->getTopDcl()))
     {
@@ -154,6 +154,7 @@ namespace vISA
         G4_BB* curBB_ = nullptr;
         uint32_t nextSpillOffset = 0;
         uint32_t scratchOffset = 0;
+        uint32_t GRFSpillFillCount = 0;
 
     public:
         static void getRowInfo(int size, int& nrows, int& lastRowSize);
@@ -165,6 +166,7 @@ namespace vISA
         void undoLinearScanRAAssignments();
         bool hasHighInternalBC() const { return highInternalConflict; }
         uint32_t getSpillSize() { return nextSpillOffset; }
+        uint32_t getGRFSpillFillCount() const { return GRFSpillFillCount; }
     };
 
 class LSLiveRange
@@ -1541,7 +1541,8 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     }
 
     // Note that list::swap does not work for some reason, but list::splice works.
-    INST_LIST TempInsts;
+    // Share the BB's allocator, so that nodes freed below are recycled.
+    INST_LIST TempInsts(CurInsts.get_allocator());
     TempInsts.splice(TempInsts.begin(), CurInsts, CurInsts.begin(), CurInsts.end());
     assert(CurInsts.empty());
 
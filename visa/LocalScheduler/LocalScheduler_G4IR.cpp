@@ -52,6 +52,8 @@ void LocalScheduler::localScheduling()
     LatencyTable LT(fg.builder);
 
     uint32_t totalCycles = 0;
+    // Reused by all blocks so that its arena is allocated once
+    Mem_Manager bbMem(4096);
     for (; ib != bend; ++ib)
     {
         unsigned instCountBefore = (uint32_t)(*ib)->size();
@@ -61,7 +63,7 @@ void LocalScheduler::localScheduling()
             continue;
         }
 
-        Mem_Manager bbMem(4096);
+        bbMem.reset();
         unsigned schedulerWindowSize = m_options->getuInt32Option(vISA_SchedulerWindowSize);
         if (schedulerWindowSize > 0 && instCountBefore > schedulerWindowSize)
         {
@@ -0,0 +1,335 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "LoopVarSplit.h"
+
+#include <map>
+
+namespace vISA
+{
+    void LoopVarSplit::collectLoops()
+    {
+        // A header may close several back edges; merge their bodies. The map
+        // is keyed by block id so the split order does not depend on
+        // pointer values.
+        std::map<unsigned int, std::pair<G4_BB*, FlowGraph::Blocks>> bodies;
+        for (auto&& loop : kernel.fg.naturalLoops)
+        {
+            G4_BB* header = loop.first.second;
+            auto& body = bodies[header->getId()];
+            body.first = header;
+            body.second.insert(loop.second.begin(), loop.second.end());
+        }
+
+        for (auto&& body : bodies)
+        {
+            Loop loop;
+            loop.header = body.second.first;
+            loop.blocks = std::move(body.second.second);
+
+            // The copy needs a block that runs exactly once before each
+            // entry into the loop. RA must not change the CFG, so loops
+            // without such a block are left alone.
+            bool singleEntry = true;
+            for (auto pred : loop.header->Preds)
+            {
+                if (loop.blocks.count(pred))
+                {
+                    continue;
+                }
+                if (loop.preheader)
+                {
+                    singleEntry = false;
+                    break;
+                }
+                loop.preheader = pred;
+            }
+            if (!singleEntry || !loop.preheader ||
+                loop.preheader->Succs.size() != 1 ||
+                loop.preheader->getBBType() != G4_BB_NONE_TYPE)
+            {
+                continue;
+            }
+            if (!loop.preheader->empty())
+            {
+                G4_INST* last = loop.preheader->back();
+                if (last->isFlowControl() &&
+                    (last->opcode() != G4_jmpi || last->getPredicate()))
+                {
+                    continue;
+                }
+            }
+
+            // Callees run as part of the loop but are not in its body, so
+            // uses there could not be redirected to the copy.
+            bool hasCall = false;
+            for (auto bb : loop.blocks)
+            {
+                if (bb->getBBType() != G4_BB_NONE_TYPE ||
+                    bb->isEndWithFCall() || bb->isEndWithFRet())
+                {
+                    hasCall = true;
+                    break;
+                }
+            }
+            if (hasCall)
+            {
+                continue;
+            }
+
+            loops.push_back(std::move(loop));
+        }
+    }
+
+    bool LoopVarSplit::isCandidate(const G4_Declare* dcl) const
+    {
+        // Copies are done in dwords, which keeps them free of the byte and
+        // word region restrictions HWConformity has already dealt with.
+        return dcl->getRegFile() == G4_GRF &&
+            !dcl->getAliasDeclare() &&
+            !dcl->getAddressed() &&
+            !dcl->getRegVar()->isPhyRegAssigned() &&
+            !dcl->getIsSplittedDcl() &&
+            !dcl->getIsPartialDcl() &&
+            dcl->getByteSize() % TypeSize(Type_UD) == 0;
+    }
+
+    void LoopVarSplit::collectRefs()
+    {
+        for (auto lr : coloring.getSpilledLiveRanges())
+        {
+            auto dcl = lr->getDcl();
+            if (isCandidate(dcl))
+            {
+                refs[dcl];
+            }
+        }
+        if (refs.empty())
+        {
+            return;
+        }
+
+        auto getRefs = [this](G4_Operand* opnd) -> References*
+        {
+            auto topdcl = opnd->getTopDcl();
+            if (!topdcl)
+            {
+                return nullptr;
+            }
+            auto it = refs.find(topdcl);
+            if (it == refs.end())
+            {
+                return nullptr;
+            }
+            // References through an alias or an indirect region cannot
+            // simply be rebased onto the copy.
+            auto base = opnd->getBase();
+            if (!base || !base->isRegVar() ||
+                base->asRegVar()->getDeclare() != topdcl ||
+                (opnd->isSrcRegRegion() && opnd->asSrcRegRegion()->getRegAccess() != Direct))
+            {
+                it->second.splittable = false;
+            }
+            return &it->second;
+        };
+
+        for (auto bb : kernel.fg)
+        {
+            for (auto inst : *bb)
+            {
+                auto dst = inst->getDst();
+                if (dst && !dst->isNullReg())
+                {
+                    if (auto r = getRefs(dst))
+                    {
+                        r->defs.push_back(bb);
+                    }
+                }
+
+                for (unsigned int i = 0; i < G4_MAX_SRCS; i++)
+                {
+                    auto src = inst->getSrc(i);
+                    if (!src || !src->isSrcRegRegion())
+                    {
+                        continue;
+                    }
+                    if (auto r = getRefs(src))
+                    {
+                        if (inst->isLifeTimeEnd())
+                        {
+                            // Ends the live range like a def would.
+                            r->defs.push_back(bb);
+                        }
+                        else
+                        {
+                            r->splittable &= !inst->isEOT();
+                            r->uses.push_back(std::make_pair(bb, std::make_pair(inst, i)));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    unsigned int LoopVarSplit::getWeight(const G4_BB* bb) const
+    {
+        return GlobalRA::getRefCount(kernel.getOption(vISA_ConsiderLoopInfoInRA) ?
+            bb->getNestLevel() : 0);
+    }
+
+    const LoopVarSplit::Loop* LoopVarSplit::selectLoop(G4_Declare* dcl, const References& r) const
+    {
+        const Loop* best = nullptr;
+        for (auto&& loop : loops)
+        {
+            if (best && best->blocks.size() >= loop.blocks.size())
+            {
+                continue;
+            }
+            if (!liveness.isLiveAtEntry(loop.header, dcl->getRegVar()->getId()))
+            {
+                continue;
+            }
+
+            // The copy is made once per entry, so the variable must not be
+            // redefined while the loop runs.
+            bool defInLoop = false;
+            unsigned int outWeight = 0;
+            for (auto bb : r.defs)
+            {
+                if (loop.blocks.count(bb))
+                {
+                    defInLoop = true;
+                    break;
+                }
+                outWeight += getWeight(bb);
+            }
+            if (defInLoop)
+            {
+                continue;
+            }
+
+            unsigned int inWeight = 0;
+            for (auto&& use : r.uses)
+            {
+                if (loop.blocks.count(use.first))
+                {
+                    inWeight += getWeight(use.first);
+                }
+                else
+                {
+                    outWeight += getWeight(use.first);
+                }
+            }
+
+            // Only worth a copy if the loop dominates the spill cost; the
+            // copy itself is one more reference in the preheader.
+            if (inWeight > outWeight + getWeight(loop.preheader))
+            {
+                best = &loop;
+            }
+        }
+        return best;
+    }
+
+    void LoopVarSplit::split(G4_Declare* dcl, References& r, const Loop& loop)
+    {
+        auto builder = kernel.fg.builder;
+        const char* name = builder->getNameString(builder->mem, 32, "%s_LOOP%d",
+            dcl->getName(), loop.header->getId());
+        G4_Declare* copyDcl = builder->createDeclareNoLookup(name, G4_GRF,
+            dcl->getNumElems(), dcl->getNumRows(), dcl->getElemType());
+        copyDcl->copyAlign(dcl);
+        gra.copyAlignment(copyDcl, dcl);
+
+        // Copy the whole variable with NoMask at the end of the preheader, at
+        // most two GRFs per mov.
+        G4_BB* preheader = loop.preheader;
+        auto insertPt = preheader->end();
+        if (!preheader->empty() && preheader->back()->isFlowControl())
+        {
+            --insertPt;
+        }
+        const unsigned int grfSize = numEltPerGRF<Type_UB>();
+        const unsigned int size = dcl->getByteSize();
+        for (unsigned int offset = 0; offset < size;)
+        {
+            unsigned int bytes = 2 * grfSize;
+            while (bytes > size - offset)
+            {
+                bytes /= 2;
+            }
+            auto execSize = G4_ExecSize(bytes / TypeSize(Type_UD));
+            short regOff = offset / grfSize;
+            short subRegOff = (offset % grfSize) / TypeSize(Type_UD);
+            auto dst = builder->createDst(copyDcl->getRegVar(), regOff, subRegOff, 1, Type_UD);
+            auto src = builder->createSrc(dcl->getRegVar(), regOff, subRegOff,
+                execSize == 1 ? builder->getRegionScalar() : builder->getRegionStride1(), Type_UD);
+            auto mov = builder->createMov(execSize, dst, src, InstOpt_WriteEnable, false);
+            preheader->insertBefore(insertPt, mov);
+            offset += bytes;
+        }
+
+        for (auto&& use : r.uses)
+        {
+            if (!loop.blocks.count(use.first))
+            {
+                continue;
+            }
+            G4_INST* inst = use.second.first;
+            unsigned int pos = use.second.second;
+            auto src = inst->getSrc(pos)->asSrcRegRegion();
+            inst->setSrc(builder->createSrcWithNewBase(src, copyDcl->getRegVar()), pos);
+        }
+
+        numSplits++;
+    }
+
+    void LoopVarSplit::run()
+    {
+        collectLoops();
+        if (loops.empty())
+        {
+            return;
+        }
+
+        collectRefs();
+
+        // Visit candidates in spill order so results are deterministic.
+        for (auto lr : coloring.getSpilledLiveRanges())
+        {
+            auto it = refs.find(lr->getDcl());
+            if (it == refs.end() || !it->second.splittable)
+            {
+                continue;
+            }
+            if (auto loop = selectLoop(it->first, it->second))
+            {
+                split(it->first, it->second, *loop);
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#ifndef __LOOPVARSPLIT_H__
+#define __LOOPVARSPLIT_H__
+
+#include "FlowGraph.h"
+#include "GraphColor.h"
+#include <unordered_map>
+#include <vector>
+
+namespace vISA
+{
+    // Splits spill candidates at loop boundaries so that their spill code
+    // lands outside hot loops.
+    //
+    // A candidate that is live into a loop and only read inside it gets a
+    // loop-local copy, written once at the end of the loop preheader, and
+    // all uses within the loop read the copy instead. The copy carries the
+    // loop-weighted references while the original keeps only the cheap
+    // ones outside, so the next coloring attempt prefers to spill the
+    // original and the fills move out of the loop.
+    class LoopVarSplit
+    {
+    public:
+        LoopVarSplit(G4_Kernel& k, LivenessAnalysis& l, GraphColor& c, GlobalRA& g) :
+            kernel(k), liveness(l), coloring(c), gra(g)
+        {
+        }
+
+        void run();
+
+        bool getChangesMade() const { return numSplits > 0; }
+        unsigned int getNumSplits() const { return numSplits; }
+
+    private:
+        typedef std::pair<G4_INST*, unsigned int> Use;
+
+        struct Loop
+        {
+            G4_BB* header = nullptr;
+            G4_BB* preheader = nullptr;
+            FlowGraph::Blocks blocks;
+        };
+
+        struct References
+        {
+            std::vector<G4_BB*> defs;
+            std::vector<std::pair<G4_BB*, Use>> uses;
+            bool splittable = true;
+        };
+
+        G4_Kernel& kernel;
+        LivenessAnalysis& liveness;
+        GraphColor& coloring;
+        GlobalRA& gra;
+        unsigned int numSplits = 0;
+
+        std::vector<Loop> loops;
+        std::unordered_map<G4_Declare*, References> refs;
+
+        void collectLoops();
+        bool isCandidate(const G4_Declare* dcl) const;
+        void collectRefs();
+        unsigned int getWeight(const G4_BB* bb) const;
+        const Loop* selectLoop(G4_Declare* dcl, const References& r) const;
+        void split(G4_Declare* dcl, References& r, const Loop& loop);
+    };
+}
+#endif
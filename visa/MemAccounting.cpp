@@ -0,0 +1,161 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "MemAccounting.h"
+#include "include/VISADefines.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace vISA;
+
+static const unsigned numMemOwners = static_cast<unsigned>(MemOwner::NumOwners);
+
+static const char* memOwnerNames[numMemOwners] =
+{
+    "Other",
+    "Kernel",
+    "Liveness",
+    "Interference",
+    "SWSB",
+};
+
+static std::atomic<uint64_t> currentBytes[numMemOwners];
+static std::atomic<uint64_t> peakBytes[numMemOwners];
+// Bytes added by this thread since resetThreadPeaks, and their peak. The
+// count goes negative when the thread frees memory it did not allocate.
+static _THREAD int64_t threadCurrentBytes[numMemOwners];
+static _THREAD uint64_t threadPeakBytes[numMemOwners];
+static _THREAD MemOwner scopeOwner = MemOwner::Other;
+
+void MemAccounting::add(MemOwner owner, size_t bytes)
+{
+    unsigned i = static_cast<unsigned>(owner);
+    uint64_t now = currentBytes[i].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t peak = peakBytes[i].load(std::memory_order_relaxed);
+    while (now > peak &&
+        !peakBytes[i].compare_exchange_weak(peak, now, std::memory_order_relaxed))
+    {
+    }
+    threadCurrentBytes[i] += bytes;
+    if (threadCurrentBytes[i] > 0 && (uint64_t)threadCurrentBytes[i] > threadPeakBytes[i])
+    {
+        threadPeakBytes[i] = threadCurrentBytes[i];
+    }
+}
+
+void MemAccounting::sub(MemOwner owner, size_t bytes)
+{
+    unsigned i = static_cast<unsigned>(owner);
+    currentBytes[i].fetch_sub(bytes, std::memory_order_relaxed);
+    threadCurrentBytes[i] -= bytes;
+}
+
+uint64_t MemAccounting::getCurrent(MemOwner owner)
+{
+    return currentBytes[static_cast<unsigned>(owner)].load(std::memory_order_relaxed);
+}
+
+uint64_t MemAccounting::getPeak(MemOwner owner)
+{
+    return peakBytes[static_cast<unsigned>(owner)].load(std::memory_order_relaxed);
+}
+
+uint64_t MemAccounting::getThreadPeak(MemOwner owner)
+{
+    return threadPeakBytes[static_cast<unsigned>(owner)];
+}
+
+void MemAccounting::resetThreadPeaks()
+{
+    for (unsigned i = 0; i < numMemOwners; i++)
+    {
+        threadCurrentBytes[i] = 0;
+        threadPeakBytes[i] = 0;
+    }
+}
+
+void MemAccounting::saveThreadPeaks(ThreadPeaks& peaks)
+{
+    for (unsigned i = 0; i < numMemOwners; i++)
+    {
+        peaks.bytes[i] = threadPeakBytes[i];
+        peaks.current[i] = threadCurrentBytes[i];
+    }
+}
+
+void MemAccounting::mergeThreadPeaks(const std::vector<ThreadPeaks>& peaks)
+{
+    for (unsigned i = 0; i < numMemOwners; i++)
+    {
+        int64_t workersPeak = 0;
+        int64_t workersCurrent = 0;
+        for (auto& workerPeaks : peaks)
+        {
+            workersPeak += workerPeaks.bytes[i];
+            workersCurrent += workerPeaks.current[i];
+        }
+        int64_t peak = std::max<int64_t>(threadCurrentBytes[i], 0) + workersPeak;
+        threadPeakBytes[i] = std::max<uint64_t>(threadPeakBytes[i], peak);
+        threadCurrentBytes[i] += workersCurrent;
+    }
+}
+
+const char* MemAccounting::getName(MemOwner owner)
+{
+    return memOwnerNames[static_cast<unsigned>(owner)];
+}
+
+MemOwnerScope::MemOwnerScope(MemOwner owner) : savedOwner(scopeOwner)
+{
+    scopeOwner = owner;
+}
+
+MemOwnerScope::~MemOwnerScope()
+{
+    scopeOwner = savedOwner;
+}
+
+MemOwner MemOwnerScope::current()
+{
+    return scopeOwner;
+}
+
+// Functions exposed by VISA lib API, read together with the timers.
+extern "C" unsigned int getTotalMemOwners()
+{
+    return numMemOwners;
+}
+
+extern "C" const char* getMemOwnerName(unsigned int idx)
+{
+    return memOwnerNames[idx];
+}
+
+extern "C" uint64_t getMemOwnerPeakBytes(unsigned int idx)
+{
+    return threadPeakBytes[idx];
+}
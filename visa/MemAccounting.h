@@ -0,0 +1,152 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Process-wide accounting of the memory held by the main finalizer data
+// structures.
+
+#ifndef _MEM_ACCOUNTING_H_
+#define _MEM_ACCOUNTING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace vISA
+{
+    // Owners memory is attributed to. Keep in sync with memOwnerNames.
+    enum class MemOwner : unsigned char
+    {
+        Other,
+        Kernel,         // G4_Kernel IR and builder (kernel Mem_Manager)
+        Liveness,       // LivenessAnalysis
+        Interference,   // interference graph and coloring state of GraphColor
+        SWSB,           // scoreboard generation
+        NumOwners
+    };
+
+    // Byte counters per owner. Unlike COLLECT_ALLOCATION_STATS this is always
+    // compiled in: counters move when an arena or a matrix is allocated or
+    // freed, and per allocation only for the few containers that are charged
+    // to an owner other than Other (the bitsets of liveness analysis).
+    //
+    // Besides the process-wide current and peak bytes, each thread keeps the
+    // bytes it added since its last resetThreadPeaks() (done by initTimer) and
+    // the peak of that count, so that a compile reports the high water mark
+    // of its own allocations, whatever other threads compile concurrently.
+    // Worker threads hand their counts back like their timers: saveThreadPeaks
+    // when done, then mergeThreadPeaks on the thread that joins them.
+    class MemAccounting
+    {
+    public:
+        struct ThreadPeaks
+        {
+            uint64_t bytes[static_cast<unsigned>(MemOwner::NumOwners)] = {};
+            // Bytes the thread still held when done; they are freed later by
+            // whoever joins it.
+            int64_t current[static_cast<unsigned>(MemOwner::NumOwners)] = {};
+        };
+
+        static void add(MemOwner owner, size_t bytes);
+        static void sub(MemOwner owner, size_t bytes);
+
+        static uint64_t getCurrent(MemOwner owner);
+        static uint64_t getPeak(MemOwner owner);
+        static uint64_t getThreadPeak(MemOwner owner);
+        static void resetThreadPeaks();
+        static void saveThreadPeaks(ThreadPeaks& peaks);
+        // Merges the counts of workers that ran concurrently. Their peaks may
+        // have coincided, so they are added on top of this thread's count.
+        static void mergeThreadPeaks(const std::vector<ThreadPeaks>& peaks);
+
+        static const char* getName(MemOwner owner);
+    };
+
+    // Attributes the arenas created on this thread to an owner while alive,
+    // whichever Mem_Manager creates them (e.g. SWSB allocates from the
+    // kernel's Mem_Manager).
+    class MemOwnerScope
+    {
+    public:
+        explicit MemOwnerScope(MemOwner owner);
+        ~MemOwnerScope();
+
+        // The owner of the innermost scope, or Other if none.
+        static MemOwner current();
+
+    private:
+        MemOwner savedOwner;
+    };
+
+    // Allocator for std containers whose storage is charged to an owner. The
+    // owner moves with the storage when a container is moved or swapped.
+    template <class T>
+    class MemAccountingAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        MemAccountingAllocator() : owner(MemOwnerScope::current()) {}
+        MemAccountingAllocator(MemOwner o) : owner(o) {}
+        template <class U>
+        MemAccountingAllocator(const MemAccountingAllocator<U>& other) : owner(other.owner) {}
+
+        T* allocate(size_t n)
+        {
+            if (owner != MemOwner::Other)
+            {
+                MemAccounting::add(owner, n * sizeof(T));
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            if (owner != MemOwner::Other)
+            {
+                MemAccounting::sub(owner, n * sizeof(T));
+            }
+            ::operator delete(p);
+        }
+
+        MemOwner getOwner() const { return owner; }
+
+        template <class U>
+        bool operator==(const MemAccountingAllocator<U>& other) const { return owner == other.owner; }
+        template <class U>
+        bool operator!=(const MemAccountingAllocator<U>& other) const { return owner != other.owner; }
+
+        template <class U> friend class MemAccountingAllocator;
+
+    private:
+        MemOwner owner;
+    };
+}
+
+#endif
@@ -37,7 +37,7 @@ namespace vISA
     class Mem_Manager {
     public:
 
-        Mem_Manager(size_t defaultArenaSize);
+        Mem_Manager(size_t defaultArenaSize, MemOwner owner = MemOwner::Other);
         ~Mem_Manager();
 
         void* alloc(size_t size)
@@ -50,6 +50,13 @@ namespace vISA
             return _arenaManager.AllocDataSpace(size, static_cast<size_t>(al));
         }
 
+        // Free everything allocated so far while keeping the largest arena,
+        // for managers reused across iterations of the same work.
+        void reset()
+        {
+            _arenaManager.Reset();
+        }
+
     private:
 
         vISA::ArenaManager _arenaManager;
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FlowGraph.h"
 #include "RegAlloc.h"
 #include <bitset>
+#include <queue>
 #include "GraphColor.h"
 #include "Timer.h"
 #include <fstream>
@@ -593,8 +594,13 @@ LivenessAnalysis::LivenessAnalysis(
         bool verifyRA,
         bool forceRun) :
         selectedRF(kind),
-        pointsToAnalysis(g.pointsToAnalysis), m(4096), gra(g), fg(g.kernel.fg)
+        pointsToAnalysis(g.pointsToAnalysis), m(4096, MemOwner::Liveness), gra(g), fg(g.kernel.fg),
+        def_in(MemOwner::Liveness), def_out(MemOwner::Liveness), use_in(MemOwner::Liveness),
+        use_out(MemOwner::Liveness), use_gen(MemOwner::Liveness), use_kill(MemOwner::Liveness),
+        indr_use(MemOwner::Liveness)
 {
+    MemOwnerScope livenessMem(MemOwner::Liveness);
+
     //
     // NOTE:
     // The maydef sets are simply aliases to the mayuse sets, since their uses are
@@ -669,15 +675,16 @@ LivenessAnalysis::LivenessAnalysis(
     use_kill.resize(numBBId);
     indr_use.resize(numBBId);
 
+    bool sparseSets = gra.kernel.getOption(vISA_SparseLivenessSets);
     for (unsigned i = 0; i < numBBId; i++)
     {
         def_in[i]  = BitSet(numVarId, false);
         def_out[i] = BitSet(numVarId, false);
         use_in[i]  = BitSet(numVarId, false);
         use_out[i] = BitSet(numVarId, false);
-        use_gen[i] = BitSet(numVarId, false);
-        use_kill[i]= BitSet(numVarId, false);
-        indr_use[i]= BitSet(numVarId, false);
+        use_gen[i] = SparseBitSet(numVarId, sparseSets);
+        use_kill[i]= SparseBitSet(numVarId, sparseSets);
+        indr_use[i]= SparseBitSet(numVarId, sparseSets);
     }
 }
 
@@ -748,7 +755,7 @@ bool LivenessAnalysis::livenessCandidate(G4_Declare* decl, bool verifyRA)
     }
 }
 
-void LivenessAnalysis::updateKillSetForDcl(G4_Declare* dcl, BitSet* curBBGen, BitSet* curBBKill, G4_BB* curBB, BitSet* entryBBGen, BitSet* entryBBKill, G4_BB* entryBB, unsigned scopeID)
+void LivenessAnalysis::updateKillSetForDcl(G4_Declare* dcl, SparseBitSet* curBBGen, SparseBitSet* curBBKill, G4_BB* curBB, SparseBitSet* entryBBGen, SparseBitSet* entryBBKill, G4_BB* entryBB, unsigned scopeID)
 {
     if (scopeID != 0 &&
         scopeID != UINT_MAX &&
@@ -769,7 +776,7 @@ void LivenessAnalysis::updateKillSetForDcl(G4_Declare* dcl, BitSet* curBBGen, Bi
 // and a sub-routine local variable is killed in entry block of the sub-routine. No
 // error check is performed currently so if variable scoping information is incorrect
 // then generated code will be so too.
-void LivenessAnalysis::performScoping(BitSet* curBBGen, BitSet* curBBKill, G4_BB* curBB, BitSet* entryBBGen, BitSet* entryBBKill, G4_BB* entryBB)
+void LivenessAnalysis::performScoping(SparseBitSet* curBBGen, SparseBitSet* curBBKill, G4_BB* curBB, SparseBitSet* entryBBGen, SparseBitSet* entryBBKill, G4_BB* entryBB)
 {
     unsigned scopeID = curBB->getScopeID();
     for (G4_INST* inst : *curBB)
@@ -921,6 +928,7 @@ void LivenessAnalysis::detectNeverDefinedVarRows()
 //
 void LivenessAnalysis::computeLiveness()
 {
+    MemOwnerScope livenessMem(MemOwner::Liveness);
     //
     // no reg var is selected, then no need to compute liveness
     //
@@ -1020,8 +1028,8 @@ void LivenessAnalysis::computeLiveness()
     }
 
     G4_BB* subEntryBB = NULL;
-    BitSet* subEntryKill = NULL;
-    BitSet* subEntryGen = NULL;
+    SparseBitSet* subEntryKill = NULL;
+    SparseBitSet* subEntryGen = NULL;
 
     if (fg.getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_CM)
     {
@@ -1103,30 +1111,45 @@ void LivenessAnalysis::computeLiveness()
     }
 
     //
-    // backward flow analysis to propagate uses (locate last uses)
+    // Both fix-points are solved with a worklist ordered by the SCCs of the
+    // CFG (see computeBBOrder), so a BB is only revisited after a BB it
+    // depends on has changed.
     //
+    std::vector<G4_BB*> order;
+    std::vector<unsigned> orderIndex;
+    computeBBOrder(order, orderIndex);
 
-    bool change = true;
-
-    while (change)
+    //
+    // Across the iterations of the GRF coloring loop, only the vars touched by
+    // the new spill/fill code need to be solved again; the fix-point is
+    // started from the BBs whose local facts changed.
+    //
+    bool trackIterations = gra.incrementalLiveness && livenessClass(G4_GRF) && fg.getNumCalls() == 0;
+    bool verifyIncremental = trackIterations && fg.builder->getOption(vISA_VerifyIncrementalLiveness);
+    std::vector<std::vector<unsigned>> localFacts;
+    std::vector<unsigned> cfg;
+    std::vector<bool> seeds;
+    BitSetVector initDefOut(MemOwner::Liveness);
+    unsigned numReused = 0;
+    if (trackIterations)
     {
-        change = false;
-        BB_LIST::iterator rit = fg.end();
-        do
+        computeLocalFacts(inputDefs, outputUses, localFacts);
+        computeCFGSignature(cfg);
+        if (verifyIncremental)
         {
-            //
-            // use_out = use_in(s1) + use_in(s2) + ...
-            // where s1 s2 ... are the successors of bb
-            // use_in  = use_gen + (use_out - use_kill)
-            //
-            --rit;
-            if (contextFreeUseAnalyze((*rit), change))
-            {
-                change = true;
-            }
-
-        } while (rit != fg.begin());
+            initDefOut = def_out;
+        }
+        if (gra.prevLiveness.valid)
+        {
+            numReused = seedFromPrevIteration(localFacts, cfg, seeds);
+        }
     }
+    const std::vector<bool>* worklistSeeds = numReused > 0 ? &seeds : nullptr;
+
+    //
+    // backward flow analysis to propagate uses (locate last uses)
+    //
+    useAnalysisWorklist(order, orderIndex, worklistSeeds);
 
     //
     // forward flow analysis to propagate defs (locate first defs)
@@ -1134,25 +1157,40 @@ void LivenessAnalysis::computeLiveness()
 
     //
     // initialize entry block with payload input
+    // (def_in is otherwise empty, or holds the reused solution of the vars
+    // unchanged since the previous iteration)
     //
-    def_in[fg.getEntryBB()->getId()] = inputDefs;
-    change = true;
-    while (change)
+    def_in[fg.getEntryBB()->getId()] |= inputDefs;
+    defAnalysisWorklist(order, orderIndex, worklistSeeds);
+
+    if (numReused > 0 && verifyIncremental)
     {
-        change = false;
-        for (auto bb : fg)
+        verifyIncrementalLiveness(order, orderIndex, inputDefs, outputUses, initDefOut);
+    }
+    if (trackIterations)
+    {
+        recordForNextIteration(std::move(localFacts), std::move(cfg));
+    }
+
+    if (fg.builder->getOption(vISA_RATrace))
+    {
+        std::cout << "\t--liveness: " << numBBId << " BBs, " << numUseVisits << " use visits, " <<
+            numDefVisits << " def visits";
+        if (numReused > 0)
         {
-            //
-            // def_in   = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
-            // def_out |= def_in
-            //
-            if (contextFreeDefAnalyze(bb, change))
-            {
-                change = true;
-            }
+            std::cout << ", " << numReused << " of " << numVarId << " vars reused";
         }
+        std::cout << "\n";
     }
 
+#if COMPILER_STATS_ENABLE
+    CompilerStats& stats = fg.builder->getcompilerStats();
+    int simdSize = fg.getKernel()->getSimdSize();
+    stats.IncreaseI64("LivenessRuns", 1, simdSize);
+    stats.IncreaseI64("LivenessUseVisits", numUseVisits, simdSize);
+    stats.IncreaseI64("LivenessDefVisits", numDefVisits, simdSize);
+#endif
+
 #if 0
     // debug code to compare old v. new IPA
     {
@@ -1192,8 +1230,8 @@ void LivenessAnalysis::computeLiveness()
             std::cerr << "\n";
         };
 
-        auto printSetDiff = [&idToDecl, this](const std::vector<BitSet>& set1,
-            const std::vector<BitSet>& set2)
+        auto printSetDiff = [&idToDecl, this](const BitSetVector& set1,
+            const BitSetVector& set2)
         {
             for (int i = 0, size = (int) set1.size(); i < size; ++i)
             {
@@ -1786,8 +1824,8 @@ void LivenessAnalysis::footprintSrc(G4_INST* i,
 void LivenessAnalysis::computeGenKillandPseudoKill(G4_BB* bb,
                                                    BitSet& def_out,
                                                    BitSet& use_in,
-                                                   BitSet& use_gen,
-                                                   BitSet& use_kill)
+                                                   SparseBitSet& use_gen,
+                                                   SparseBitSet& use_kill)
 {
     std::vector<BitSet*> footprints(numVarId, 0);
     std::vector<std::pair<G4_Declare*, INST_LIST_RITER>> pseudoKills;
@@ -2274,7 +2312,8 @@ void LivenessAnalysis::computeGenKillandPseudoKill(G4_BB* bb,
     //
     // initialize use_in
     //
-    use_in = use_gen;
+    use_in.clear();
+    use_in |= use_gen;
 
     //
     // Destroy bitsets allocated using mem manager
@@ -2330,6 +2369,422 @@ bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb, bool isChanged)
     return changed;
 }
 
+//
+// Order all BBs for the use/def worklists: the strongly connected components
+// of the CFG in topological order, and the BBs of a component in reverse
+// post-order. A loop is thus iterated to its fix-point before anything that
+// depends on it is visited, instead of the whole CFG being swept again for
+// every loop that hasn't converged.
+// BBs not reachable from the entry (e.g., subroutines only entered through
+// call edges) start their own DFS in layout order.
+// orderIndex maps a BB id to its position in order.
+//
+void LivenessAnalysis::computeBBOrder(std::vector<G4_BB*>& order, std::vector<unsigned>& orderIndex) const
+{
+    // one iterative DFS computes both the post-order and Tarjan's SCCs
+    std::vector<G4_BB*> postOrder;
+    postOrder.reserve(numBBId);
+    std::vector<unsigned> dfsNum(numBBId, UINT_MAX);
+    std::vector<unsigned> lowLink(numBBId, 0);
+    std::vector<unsigned> sccId(numBBId, UINT_MAX);
+    std::vector<G4_BB*> sccStack;
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+    unsigned nextDfsNum = 0;
+    unsigned numSCC = 0;
+
+    auto visit = [&](G4_BB* bb)
+    {
+        unsigned id = bb->getId();
+        dfsNum[id] = lowLink[id] = nextDfsNum++;
+        sccStack.push_back(bb);
+        stack.push_back(std::make_pair(bb, bb->Succs.begin()));
+    };
+
+    auto dfs = [&](G4_BB* root)
+    {
+        visit(root);
+        while (!stack.empty())
+        {
+            G4_BB* bb = stack.back().first;
+            unsigned id = bb->getId();
+            BB_LIST_ITER& succIt = stack.back().second;
+            if (succIt != bb->Succs.end())
+            {
+                G4_BB* succ = *succIt;
+                ++succIt;
+                unsigned succId = succ->getId();
+                if (dfsNum[succId] == UINT_MAX)
+                {
+                    visit(succ);
+                }
+                else if (sccId[succId] == UINT_MAX)
+                {
+                    // succ is still on the SCC stack
+                    lowLink[id] = std::min(lowLink[id], dfsNum[succId]);
+                }
+            }
+            else
+            {
+                postOrder.push_back(bb);
+                stack.pop_back();
+                if (!stack.empty())
+                {
+                    unsigned parentId = stack.back().first->getId();
+                    lowLink[parentId] = std::min(lowLink[parentId], lowLink[id]);
+                }
+                if (lowLink[id] == dfsNum[id])
+                {
+                    G4_BB* member = nullptr;
+                    do
+                    {
+                        member = sccStack.back();
+                        sccStack.pop_back();
+                        sccId[member->getId()] = numSCC;
+                    } while (member != bb);
+                    numSCC++;
+                }
+            }
+        }
+    };
+
+    dfs(fg.getEntryBB());
+    for (auto bb : fg)
+    {
+        if (dfsNum[bb->getId()] == UINT_MAX)
+        {
+            dfs(bb);
+        }
+    }
+
+    // Tarjan completes the SCCs in reverse topological order
+    order.assign(postOrder.rbegin(), postOrder.rend());
+    std::stable_sort(order.begin(), order.end(),
+        [&sccId](G4_BB* bb1, G4_BB* bb2) { return sccId[bb1->getId()] > sccId[bb2->getId()]; });
+    orderIndex.resize(numBBId);
+    for (unsigned i = 0, size = (unsigned)order.size(); i < size; i++)
+    {
+        orderIndex[order[i]->getId()] = i;
+    }
+}
+
+//
+// Backward use fix-point. Every BB is visited once in reverse order; after
+// that a BB is only revisited if the use_in of one of its successors has
+// changed. With seeds, only the seeded BBs are visited to start with; the
+// other BBs must already hold their solution.
+//
+void LivenessAnalysis::useAnalysisWorklist(const std::vector<G4_BB*>& order, const std::vector<unsigned>& orderIndex,
+    const std::vector<bool>* seeds)
+{
+    // max-heap on the position visits the components bottom-up
+    std::priority_queue<unsigned> worklist;
+    std::vector<bool> inWorklist(order.size(), false);
+    for (unsigned i = 0, size = (unsigned)order.size(); i < size; i++)
+    {
+        if (!seeds || (*seeds)[order[i]->getId()])
+        {
+            inWorklist[i] = true;
+            worklist.push(i);
+        }
+    }
+
+    BitSet oldUseIn(numVarId, false);
+    while (!worklist.empty())
+    {
+        unsigned idx = worklist.top();
+        worklist.pop();
+        inWorklist[idx] = false;
+
+        G4_BB* bb = order[idx];
+        unsigned bbid = bb->getId();
+        numUseVisits++;
+
+        oldUseIn = use_in[bbid];
+        // isChanged=true skips the use_out copy, we compare use_in instead
+        contextFreeUseAnalyze(bb, true);
+        if (use_in[bbid] != oldUseIn)
+        {
+            for (auto predBB : bb->Preds)
+            {
+                unsigned predIdx = orderIndex[predBB->getId()];
+                if (!inWorklist[predIdx])
+                {
+                    inWorklist[predIdx] = true;
+                    worklist.push(predIdx);
+                }
+            }
+        }
+    }
+}
+
+//
+// Forward def fix-point. Every BB is visited once in order; after that a BB
+// is only revisited if the def_out of one of its predecessors has changed.
+// seeds works as for useAnalysisWorklist.
+//
+void LivenessAnalysis::defAnalysisWorklist(const std::vector<G4_BB*>& order, const std::vector<unsigned>& orderIndex,
+    const std::vector<bool>* seeds)
+{
+    // min-heap on the position visits the components top-down
+    std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> worklist;
+    std::vector<bool> inWorklist(order.size(), false);
+    for (unsigned i = 0, size = (unsigned)order.size(); i < size; i++)
+    {
+        if (!seeds || (*seeds)[order[i]->getId()])
+        {
+            inWorklist[i] = true;
+            worklist.push(i);
+        }
+    }
+
+    BitSet oldDefOut(numVarId, false);
+    while (!worklist.empty())
+    {
+        unsigned idx = worklist.top();
+        worklist.pop();
+        inWorklist[idx] = false;
+
+        G4_BB* bb = order[idx];
+        unsigned bbid = bb->getId();
+        numDefVisits++;
+
+        oldDefOut = def_out[bbid];
+        contextFreeDefAnalyze(bb, true);
+        if (def_out[bbid] != oldDefOut)
+        {
+            for (auto succBB : bb->Succs)
+            {
+                unsigned succIdx = orderIndex[succBB->getId()];
+                if (!inWorklist[succIdx])
+                {
+                    inWorklist[succIdx] = true;
+                    worklist.push(succIdx);
+                }
+            }
+        }
+    }
+}
+
+//
+// Collect the local facts of every var: the BBs where it is in use_gen,
+// use_kill or the def gen set (def_out before the fix-point), and whether it
+// is a kernel input or output. Together with the CFG these fully determine
+// the var's liveness solution.
+//
+void LivenessAnalysis::computeLocalFacts(const BitSet& inputDefs, const BitSet& outputUses,
+    std::vector<std::vector<unsigned>>& facts) const
+{
+    facts.assign(numVarId, std::vector<unsigned>());
+    for (auto bb : fg)
+    {
+        unsigned id = bb->getId();
+        unsigned code = id * NUM_LOCAL_FACTS;
+        use_gen[id].forEachSetBit([&](unsigned v) { facts[v].push_back(code + FACT_GEN); });
+        use_kill[id].forEachSetBit([&](unsigned v) { facts[v].push_back(code + FACT_KILL); });
+        def_out[id].forEachSetBit([&](unsigned v) { facts[v].push_back(code + FACT_DEF); });
+    }
+    unsigned kernelCode = numBBId * NUM_LOCAL_FACTS;
+    inputDefs.forEachSetBit([&](unsigned v) { facts[v].push_back(kernelCode + FACT_INPUT); });
+    outputUses.forEachSetBit([&](unsigned v) { facts[v].push_back(kernelCode + FACT_OUTPUT); });
+
+    for (auto& varFacts : facts)
+    {
+        std::sort(varFacts.begin(), varFacts.end());
+    }
+}
+
+void LivenessAnalysis::computeCFGSignature(std::vector<unsigned>& cfg) const
+{
+    cfg.clear();
+    for (auto bb : fg)
+    {
+        cfg.push_back(bb->getId());
+        for (auto succ : bb->Succs)
+        {
+            cfg.push_back(succ->getId());
+        }
+        cfg.push_back(UINT_MAX);
+    }
+}
+
+//
+// Carry the solution of the vars whose local facts are unchanged since the
+// previous iteration over from gra.prevLiveness, and mark in seeds the BBs
+// the worklists must start from for the others:
+// - a BB where a changed var is generated, killed or defined, and its
+//   predecessors and successors, which read its use_in/def_out;
+// - the entry and exit BBs, which get the kernel inputs and outputs.
+// Every other BB holds a solution that is already final, as none of its
+// neighbours has anything to propagate for the changed vars.
+// Returns the number of vars reused, 0 if the snapshot can't be used.
+//
+unsigned LivenessAnalysis::seedFromPrevIteration(const std::vector<std::vector<unsigned>>& facts,
+    const std::vector<unsigned>& cfg, std::vector<bool>& seeds)
+{
+    const LivenessSnapshot& prev = gra.prevLiveness;
+    if (cfg != prev.cfg)
+    {
+        return 0;
+    }
+
+    std::unordered_map<const G4_Declare*, unsigned> prevIds;
+    for (unsigned i = 0, size = (unsigned)prev.dcls.size(); i < size; i++)
+    {
+        prevIds[prev.dcls[i]] = i;
+    }
+
+    // previous var id -> current var id of the unchanged vars
+    std::vector<unsigned> toCur(prev.dcls.size(), UINT_MAX);
+    std::vector<bool> changed(numVarId, true);
+    unsigned numReused = 0;
+    for (unsigned v = 0; v < numVarId; v++)
+    {
+        auto it = prevIds.find(vars[v]->getDeclare());
+        if (it != prevIds.end() && facts[v] == prev.localFacts[it->second])
+        {
+            toCur[it->second] = v;
+            changed[v] = false;
+            numReused++;
+        }
+    }
+    if (numReused == 0)
+    {
+        return 0;
+    }
+
+    std::vector<bool> touched(numBBId, false);
+    for (unsigned v = 0; v < numVarId; v++)
+    {
+        if (changed[v])
+        {
+            for (unsigned code : facts[v])
+            {
+                unsigned id = code / NUM_LOCAL_FACTS;
+                if (id < numBBId)
+                {
+                    touched[id] = true;
+                }
+            }
+        }
+    }
+
+    seeds.assign(numBBId, false);
+    for (auto bb : fg)
+    {
+        unsigned id = bb->getId();
+        if (bb->Succs.empty() || bb == fg.getEntryBB())
+        {
+            seeds[id] = true;
+        }
+        if (touched[id])
+        {
+            seeds[id] = true;
+            for (auto pred : bb->Preds)
+            {
+                seeds[pred->getId()] = true;
+            }
+            for (auto succ : bb->Succs)
+            {
+                seeds[succ->getId()] = true;
+            }
+        }
+    }
+
+    auto reuse = [&toCur](const BitSet& prevSet, BitSet& curSet)
+    {
+        prevSet.forEachSetBit([&](unsigned prevId)
+        {
+            if (toCur[prevId] != UINT_MAX)
+            {
+                curSet.set(toCur[prevId], true);
+            }
+        });
+    };
+    for (unsigned id = 0; id < numBBId; id++)
+    {
+        // use_in may be stale after performScoping, the non-seeded BBs
+        // aren't recomputed
+        use_in[id].clear();
+        use_in[id] |= use_gen[id];
+
+        reuse(prev.use_in[id], use_in[id]);
+        reuse(prev.use_out[id], use_out[id]);
+        reuse(prev.def_in[id], def_in[id]);
+        reuse(prev.def_out[id], def_out[id]);
+    }
+
+    return numReused;
+}
+
+void LivenessAnalysis::recordForNextIteration(std::vector<std::vector<unsigned>>&& facts, std::vector<unsigned>&& cfg) const
+{
+    LivenessSnapshot& snapshot = gra.prevLiveness;
+    snapshot.clear();
+    snapshot.dcls.resize(numVarId);
+    for (unsigned v = 0; v < numVarId; v++)
+    {
+        snapshot.dcls[v] = vars[v]->getDeclare();
+    }
+    snapshot.localFacts = std::move(facts);
+    snapshot.cfg = std::move(cfg);
+    snapshot.use_in.assign(use_in.begin(), use_in.end());
+    snapshot.use_out.assign(use_out.begin(), use_out.end());
+    snapshot.def_in.assign(def_in.begin(), def_in.end());
+    snapshot.def_out.assign(def_out.begin(), def_out.end());
+    snapshot.valid = true;
+}
+
+//
+// -verifyIncrementalLiveness: solve both fix-points again from scratch and
+// check that the incremental solution is identical.
+//
+void LivenessAnalysis::verifyIncrementalLiveness(const std::vector<G4_BB*>& order,
+    const std::vector<unsigned>& orderIndex, const BitSet& inputDefs, const BitSet& outputUses,
+    const BitSetVector& initDefOut)
+{
+    BitSetVector incUseIn(use_in), incUseOut(use_out), incDefIn(def_in), incDefOut(def_out);
+
+    for (auto bb : fg)
+    {
+        unsigned id = bb->getId();
+        use_in[id].clear();
+        use_in[id] |= use_gen[id];
+        use_out[id].clear();
+        if (bb->Succs.empty())
+        {
+            use_out[id] = outputUses;
+        }
+        def_in[id].clear();
+        def_out[id] = initDefOut[id];
+    }
+    useAnalysisWorklist(order, orderIndex);
+    def_in[fg.getEntryBB()->getId()] |= inputDefs;
+    defAnalysisWorklist(order, orderIndex);
+
+    auto check = [this](const char* setName, const BitSetVector& incSets, const BitSetVector& sets)
+    {
+        for (unsigned id = 0; id < numBBId; id++)
+        {
+            if (incSets[id] != sets[id])
+            {
+                for (unsigned v = 0; v < numVarId; v++)
+                {
+                    if (incSets[id].isSet(v) != sets[id].isSet(v))
+                    {
+                        std::cerr << "incremental liveness mismatch: " << vars[v]->getDeclare()->getName() <<
+                            " in " << setName << " of BB" << id << "\n";
+                    }
+                }
+                MUST_BE_TRUE(false, "incremental liveness differs from full recomputation");
+            }
+        }
+    };
+    check("use_in", incUseIn, use_in);
+    check("use_out", incUseOut, use_out);
+    check("def_in", incDefIn, def_in);
+    check("def_out", incDefOut, def_out);
+}
+
 //
 // def_in = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 // def_out |= def_in
@@ -2367,7 +2822,7 @@ bool LivenessAnalysis::contextFreeDefAnalyze(G4_BB* bb, bool isChanged)
      return changed;
 }
 
-void LivenessAnalysis::dump_bb_vector(char* vname, std::vector<BitSet>& vec)
+void LivenessAnalysis::dump_bb_vector(char* vname, BitSetVector& vec)
 {
     std::cerr << vname << "\n";
     for (BB_LIST_ITER it = fg.begin(); it != fg.end(); it++)
@@ -2981,7 +3436,7 @@ void GlobalRA::verifyRA(LivenessAnalysis & liveAnalysis)
                             MUST_BE_TRUE(liveOutRegMapIt != liveOutRegMap.end(), "RA verification error: Invalid entry in liveOutRegMap!");
                             if (liveOutRegVec[idx] != varID)
                             {
-                                const BitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
+                                const SparseBitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
 
                                 if (strstr(dcl->getName(), GlobalRA::StackCallStr) != NULL)
                                 {
@@ -3052,7 +3507,7 @@ void GlobalRA::verifyRA(LivenessAnalysis & liveAnalysis)
                                 MUST_BE_TRUE(liveOutRegMapIt != liveOutRegMap.end(), "RA verification error: Invalid entry in liveOutRegMap!");
                                 if (liveOutRegVec[idx] != varID)
                                 {
-                                    const BitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
+                                    const SparseBitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
 
                                     if (strstr(dcl->getName(), GlobalRA::StackCallStr) != NULL)
                                     {
@@ -3140,7 +3595,7 @@ void GlobalRA::verifyRA(LivenessAnalysis & liveAnalysis)
                         {
                             if (liveOutRegVec[idx] != varID)
                             {
-                                const BitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
+                                const SparseBitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
 
                                 if (dcl->isInput())
                                 {
@@ -3218,7 +3673,7 @@ void GlobalRA::verifyRA(LivenessAnalysis & liveAnalysis)
                             {
                                 if (liveOutRegVec[idx] != varID)
                                 {
-                                    const BitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
+                                    const SparseBitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
 
                                     if (dcl->isInput())
                                     {
@@ -3330,7 +3785,7 @@ void GlobalRA::verifyRA(LivenessAnalysis & liveAnalysis)
                             {
                                 if (liveOutRegVec[idx] != varID)
                                 {
-                                    const BitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
+                                    const SparseBitSet& indr_use = liveAnalysis.indr_use[bb->getId()];
 
                                     if (dcl->isInput())
                                     {
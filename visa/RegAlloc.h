@@ -30,6 +30,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 
 #include "BitSet.h"
+#include "SparseBitSet.h"
 #include "LocalRA.h"
 #include "LinearScanRA.h"
 
@@ -392,8 +393,48 @@ struct VarRangeListPackage
     VAR_RANGE_LIST list;
 };
 
+//
+// GRF liveness of the previous GRA iteration, with the local facts (gen, kill
+// and def sets, kernel inputs and outputs) it was solved from. The fix-point
+// is separable per variable, so the solution of a var whose local facts are
+// the same in every BB of an unchanged CFG can be reused as is.
+// Var ids are renumbered every iteration, so vars are matched by declare.
+//
+struct LivenessSnapshot
+{
+    bool valid = false;
+    std::vector<const G4_Declare*> dcls;
+    // per var, the sorted codes (BB id * NUM_LOCAL_FACTS + fact) of its local facts
+    std::vector<std::vector<unsigned>> localFacts;
+    // BB ids in layout order, each followed by its successor ids and UINT_MAX
+    std::vector<unsigned> cfg;
+    std::vector<BitSet> use_in;
+    std::vector<BitSet> use_out;
+    std::vector<BitSet> def_in;
+    std::vector<BitSet> def_out;
+
+    void clear()
+    {
+        valid = false;
+        dcls.clear();
+        localFacts.clear();
+        cfg.clear();
+        use_in.clear();
+        use_out.clear();
+        def_in.clear();
+        def_out.clear();
+    }
+};
+
 class LivenessAnalysis
 {
+public:
+    // Per-BB sets. Their storage is charged to MemOwner::Liveness, and so are
+    // the bit arrays of the sets, which are allocated under a MemOwnerScope.
+    typedef std::vector<BitSet, vISA::MemAccountingAllocator<BitSet>> BitSetVector;
+    typedef std::vector<SparseBitSet, vISA::MemAccountingAllocator<SparseBitSet>> SparseBitSetVector;
+
+private:
     unsigned numVarId = 0;         // the var count
     unsigned numGlobalVarId = 0;   // the global var count
     unsigned numSplitVar = 0;      // the split var count
@@ -411,18 +452,38 @@ class LivenessAnalysis
     void computeGenKillandPseudoKill(G4_BB* bb,
         BitSet& def_out,
         BitSet& use_in,
-        BitSet& use_gen,
-        BitSet& use_kill);
+        SparseBitSet& use_gen,
+        SparseBitSet& use_kill);
 
     bool contextFreeUseAnalyze(G4_BB* bb, bool isChanged);
     bool contextFreeDefAnalyze(G4_BB* bb, bool isChanged);
+    void computeBBOrder(std::vector<G4_BB*>& order, std::vector<unsigned>& orderIndex) const;
+    void useAnalysisWorklist(const std::vector<G4_BB*>& order, const std::vector<unsigned>& orderIndex,
+        const std::vector<bool>* seeds = nullptr);
+    void defAnalysisWorklist(const std::vector<G4_BB*>& order, const std::vector<unsigned>& orderIndex,
+        const std::vector<bool>* seeds = nullptr);
+
+    // incremental liveness across GRA iterations (-incrementalLiveness)
+    enum LocalFact { FACT_GEN, FACT_KILL, FACT_DEF, FACT_INPUT, FACT_OUTPUT, NUM_LOCAL_FACTS };
+    void computeLocalFacts(const BitSet& inputDefs, const BitSet& outputUses,
+        std::vector<std::vector<unsigned>>& facts) const;
+    void computeCFGSignature(std::vector<unsigned>& cfg) const;
+    unsigned seedFromPrevIteration(const std::vector<std::vector<unsigned>>& facts,
+        const std::vector<unsigned>& cfg, std::vector<bool>& seeds);
+    void recordForNextIteration(std::vector<std::vector<unsigned>>&& facts, std::vector<unsigned>&& cfg) const;
+    void verifyIncrementalLiveness(const std::vector<G4_BB*>& order, const std::vector<unsigned>& orderIndex,
+        const BitSet& inputDefs, const BitSet& outputUses, const BitSetVector& initDefOut);
+
+    // number of BBs processed by the use/def fix-points (-ratrace)
+    unsigned numUseVisits = 0;
+    unsigned numDefVisits = 0;
 
     bool livenessCandidate(G4_Declare* decl, bool verifyRA);
 
-    void dump_bb_vector(char* vname, std::vector<BitSet>& vec);
+    void dump_bb_vector(char* vname, BitSetVector& vec);
     void dump_fn_vector(char* vname, std::vector<FuncInfo*>& fns, std::vector<BitSet>& vec);
 
-    void updateKillSetForDcl(G4_Declare* dcl, BitSet* curBBGen, BitSet* curBBKill, G4_BB* curBB, BitSet* entryBBGen, BitSet* entryBBKill,
+    void updateKillSetForDcl(G4_Declare* dcl, SparseBitSet* curBBGen, SparseBitSet* curBBKill, G4_BB* curBB, SparseBitSet* entryBBGen, SparseBitSet* entryBBKill,
         G4_BB* entryBB, unsigned scopeID);
     void footprintDst(G4_BB* bb, G4_INST* i, G4_Operand* opnd, BitSet* dstfootprint);
     void footprintSrc(G4_INST* i, G4_Operand *opnd, BitSet* srcfootprint);
@@ -437,13 +498,13 @@ public:
     //
     // Bitsets used for data flow.
     //
-    std::vector<BitSet> def_in;
-    std::vector<BitSet> def_out;
-    std::vector<BitSet> use_in;
-    std::vector<BitSet> use_out;
-    std::vector<BitSet> use_gen;
-    std::vector<BitSet> use_kill;
-    std::vector<BitSet> indr_use;
+    BitSetVector def_in;
+    BitSetVector def_out;
+    BitSetVector use_in;
+    BitSetVector use_out;
+    SparseBitSetVector use_gen;
+    SparseBitSetVector use_kill;
+    SparseBitSetVector indr_use;
     std::unordered_map<FuncInfo*, BitSet> subroutineMaydef;
 
     bool isLocalVar(G4_Declare* decl);
@@ -474,7 +535,7 @@ public:
 
     bool writeWholeRegion(const G4_BB* bb, G4_INST* prd, G4_VarBase* flagReg);
 
-    void performScoping(BitSet* curBBGen, BitSet* curBBKill, G4_BB* curBB, BitSet* entryBBGen, BitSet* entryBBKill, G4_BB* entryBB);
+    void performScoping(SparseBitSet* curBBGen, SparseBitSet* curBBKill, G4_BB* curBB, SparseBitSet* entryBBGen, SparseBitSet* entryBBKill, G4_BB* entryBB);
 
     void hierarchicalIPA(const BitSet& kernelInput, const BitSet& kernelOutput);
     void useAnalysis(FuncInfo* subroutine);
@@ -0,0 +1,159 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#include "SparseBitSet.h"
+#include <algorithm>
+
+static bool compareElementIndex(const std::pair<unsigned, BITSET_ARRAY_TYPE>& elt, unsigned index)
+{
+    return elt.first < index;
+}
+
+bool SparseBitSet::isSet(unsigned index) const
+{
+    if (m_IsDense)
+    {
+        return m_Dense.isSet(index);
+    }
+    if (index >= m_Size)
+    {
+        return false;
+    }
+
+    unsigned eltIndex = index / NUM_BITS_PER_ELT;
+    auto it = std::lower_bound(m_Elements.begin(), m_Elements.end(), eltIndex, compareElementIndex);
+    return it != m_Elements.end() && it->first == eltIndex &&
+        (it->second & BIT(index % NUM_BITS_PER_ELT)) != 0;
+}
+
+void SparseBitSet::set(unsigned index, bool value)
+{
+    // grow the set like BitSet::set() does
+    if (index >= m_Size)
+    {
+        m_Size = index + 1;
+    }
+    if (m_IsDense)
+    {
+        m_Dense.set(index, value);
+        return;
+    }
+
+    unsigned eltIndex = index / NUM_BITS_PER_ELT;
+    BITSET_ARRAY_TYPE bit = BIT(index % NUM_BITS_PER_ELT);
+    auto it = std::lower_bound(m_Elements.begin(), m_Elements.end(), eltIndex, compareElementIndex);
+    bool found = it != m_Elements.end() && it->first == eltIndex;
+
+    if (value)
+    {
+        if (found)
+        {
+            it->second |= bit;
+            return;
+        }
+        m_Elements.insert(it, Element(eltIndex, bit));
+
+        unsigned numElements = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+        if (m_Elements.size() * SPARSE_TO_DENSE_RATIO > numElements)
+        {
+            makeDense();
+        }
+    }
+    else if (found)
+    {
+        it->second &= ~bit;
+        if (it->second == 0)
+        {
+            m_Elements.erase(it);
+        }
+    }
+}
+
+void SparseBitSet::clear()
+{
+    if (m_IsDense)
+    {
+        m_Dense.clear();
+    }
+    else
+    {
+        m_Elements.clear();
+    }
+}
+
+void SparseBitSet::makeDense()
+{
+    {
+        vISA::MemOwnerScope memOwner(m_Elements.get_allocator().getOwner());
+        m_Dense.resize(m_Size);
+    }
+    for (auto& elt : m_Elements)
+    {
+        m_Dense.m_BitSetArray[elt.first] = elt.second;
+    }
+    ElementVector(m_Elements.get_allocator()).swap(m_Elements);
+    m_IsDense = true;
+}
+
+void SparseBitSet::orInto(BitSet& dst) const
+{
+    if (m_IsDense)
+    {
+        dst |= m_Dense;
+        return;
+    }
+
+    // grow dst to our size like BitSet::operator|= does
+    if (dst.m_Size < m_Size)
+    {
+        dst.create(m_Size);
+    }
+    for (auto& elt : m_Elements)
+    {
+        dst.m_BitSetArray[elt.first] |= elt.second;
+    }
+}
+
+void SparseBitSet::subtractFrom(BitSet& dst) const
+{
+    if (m_IsDense)
+    {
+        dst -= m_Dense;
+        return;
+    }
+
+    // do not grow dst for subtract
+    unsigned dstArraySize = (dst.m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    for (auto& elt : m_Elements)
+    {
+        if (elt.first >= dstArraySize)
+        {
+            break;
+        }
+        dst.m_BitSetArray[elt.first] &= ~elt.second;
+    }
+}
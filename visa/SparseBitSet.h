@@ -0,0 +1,116 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#ifndef _SPARSEBITSET_H_
+#define _SPARSEBITSET_H_
+
+#include "BitSet.h"
+#include <utility>
+#include <vector>
+
+// Bitset for sets that are expected to be mostly empty, such as the per-BB
+// gen/kill sets of liveness analysis. Only the non-zero elements are stored, as
+// (element index, element value) pairs sorted by index. Elements have the same
+// layout as in BitSet, so the two can be combined element by element.
+// Once more than 1/SPARSE_TO_DENSE_RATIO of the elements are non-zero the set
+// switches to a dense BitSet, so it never gets much bigger or slower than a
+// plain BitSet would be.
+class SparseBitSet
+{
+public:
+    SparseBitSet() : m_Size(0), m_IsDense(false) {}
+    SparseBitSet(unsigned size, bool allowSparse) : m_Size(size), m_IsDense(!allowSparse)
+    {
+        if (m_IsDense)
+        {
+            m_Dense.resize(size);
+        }
+    }
+
+    unsigned getSize() const { return m_Size; }
+    bool isDense() const { return m_IsDense; }
+
+    bool isSet(unsigned index) const;
+    void set(unsigned index, bool value);
+    void clear();
+
+    // dst |= *this
+    void orInto(BitSet& dst) const;
+    // dst -= *this
+    void subtractFrom(BitSet& dst) const;
+
+    // Calls f(index) for every set bit, in increasing order.
+    template <typename F>
+    void forEachSetBit(F f) const
+    {
+        if (m_IsDense)
+        {
+            m_Dense.forEachSetBit(f);
+            return;
+        }
+        for (const Element& elt : m_Elements)
+        {
+            BITSET_ARRAY_TYPE value = elt.second;
+            for (unsigned bitIndex = 0; value != 0; bitIndex++, value >>= 1)
+            {
+                if (value & 1)
+                {
+                    f(elt.first * NUM_BITS_PER_ELT + bitIndex);
+                }
+            }
+        }
+    }
+
+private:
+    static const unsigned SPARSE_TO_DENSE_RATIO = 8;
+
+    typedef std::pair<unsigned, BITSET_ARRAY_TYPE> Element;
+    // Charged to the MemOwnerScope active when the set was constructed, like
+    // the dense BitSet it may turn into.
+    typedef std::vector<Element, vISA::MemAccountingAllocator<Element>> ElementVector;
+
+    unsigned m_Size;
+    bool m_IsDense;
+    BitSet m_Dense;
+    ElementVector m_Elements;
+
+    void makeDense();
+};
+
+inline BitSet& operator|=(BitSet& dst, const SparseBitSet& src)
+{
+    src.orInto(dst);
+    return dst;
+}
+
+inline BitSet& operator-=(BitSet& dst, const SparseBitSet& src)
+{
+    src.subtractFrom(dst);
+    return dst;
+}
+
+#endif
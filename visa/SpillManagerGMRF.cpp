@@ -4821,6 +4821,10 @@ void GlobalRA::expandSpillIntrinsic(G4_BB* bb)
                 }
             }
             numGRFSpill++;
+            if (bb->getNestLevel())
+            {
+                numGRFSpillInLoop++;
+            }
             instIt = bb->erase(spillIt);
             continue;
         }
@@ -4997,6 +5001,10 @@ void GlobalRA::expandFillIntrinsic(G4_BB* bb)
                 }
             }
             numGRFFill++;
+            if (bb->getNestLevel())
+            {
+                numGRFFillInLoop++;
+            }
             instIt = bb->erase(fillIt);
             continue;
         }
@@ -5016,5 +5024,7 @@ void GlobalRA::expandSpillFillIntrinsics(unsigned int spillSizeInBytes)
     }
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFSpillStr(), numGRFSpill, kernel.getSimdSize());
     kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFFillStr(), numGRFFill, kernel.getSimdSize());
+    kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFSpillInLoopStr(), numGRFSpillInLoop, kernel.getSimdSize());
+    kernel.fg.builder->getcompilerStats().SetI64(CompilerStats::numGRFFillInLoopStr(), numGRFFillInLoop, kernel.getSimdSize());
 
 }
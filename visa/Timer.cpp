@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "Option.h"
 #include "Timer.h"
+#include "MemAccounting.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -107,9 +108,25 @@ struct Timer {
 static _THREAD Timer timers[static_cast<int>(TimerID::NUM_TIMERS)];
 static _THREAD LARGE_INTEGER proc_freq;
 static _THREAD int numTimers = static_cast<int>(TimerID::NUM_TIMERS);
+// Begin times of the timers as trace events; 0 if not started while tracing.
+static _THREAD uint64_t traceStart[static_cast<int>(TimerID::NUM_TIMERS)];
+
+// Timer names without the indentation used for dumps.
+static const char* getTraceName(int timer)
+{
+    const char* name = timerNames[timer];
+    while (*name == '\t' || *name == ' ')
+    {
+        name++;
+    }
+    return name;
+}
 
 void initTimer() {
 
+    // Memory peaks are reported per compile along with the timers.
+    vISA::MemAccounting::resetThreadPeaks();
+
 #ifdef MEASURE_COMPILATION_TIME
     numTimers = 0;
     for (int i = 0; i < static_cast<int>(TimerID::NUM_TIMERS); i++)
@@ -148,6 +165,26 @@ void resetPerKernel()
     }
 }
 
+void saveTimers(TimerValues& values)
+{
+    for (int i = 0; i < static_cast<int>(TimerID::NUM_TIMERS); i++)
+    {
+        values.time[i] = timers[i].time;
+        values.ticks[i] = timers[i].ticks;
+        values.hits[i] = timers[i].hits;
+    }
+}
+
+void addTimers(const TimerValues& values)
+{
+    for (int i = 0; i < static_cast<int>(TimerID::NUM_TIMERS); i++)
+    {
+        timers[i].time += values.time[i];
+        timers[i].ticks += values.ticks[i];
+        timers[i].hits += values.hits[i];
+    }
+}
+
 int createNewTimer(const char* name)
 {
     timers[numTimers].name = name;
@@ -157,6 +194,10 @@ int createNewTimer(const char* name)
 void startTimer(TimerID timerId)
 {
     int timer = static_cast<int>(timerId);
+    if (CompileTrace::isEnabled() && timer < static_cast<int>(TimerID::NUM_TIMERS))
+    {
+        traceStart[timer] = CompileTrace::now();
+    }
 #ifdef MEASURE_COMPILATION_TIME
     if (timer < static_cast<int>(TimerID::NUM_TIMERS))
     {
@@ -189,6 +230,11 @@ void startTimer(TimerID timerId)
 void stopTimer(TimerID timerId)
 {
     int timer = static_cast<int>(timerId);
+    if (timer < static_cast<int>(TimerID::NUM_TIMERS) && traceStart[timer])
+    {
+        CompileTrace::Tracer::get().record(getTraceName(timer), "vISA", traceStart[timer], CompileTrace::now());
+        traceStart[timer] = 0;
+    }
 #ifdef MEASURE_COMPILATION_TIME
     if (timer < static_cast<int>(TimerID::NUM_TIMERS))
     {
@@ -33,6 +33,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #endif
 
 #include "VISADefines.h"
+#include "inc/common/CompileTrace.h"
+#include <cstdint>
 
 // Timer library for the compiler
 // To collect compile time information, do the following:
@@ -48,6 +50,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // or invoke other extern functions in Timer.cpp
 // to get individual timer name, ticks, time count.
 //
+// Timers also show up as events in compile traces (see CompileTrace.h),
+// including in builds that do not measure compilation time.
+//
 #define DEF_TIMER(ENUM, DESCR) ENUM,
 enum class TimerID
 {
@@ -62,6 +67,18 @@ void stopTimer(TimerID timer);
 void dumpAllTimers(const char *asmFileName, bool outputTime = false);
 void dumpEncoderStats(Options *opt, std::string &asmName);
 void resetPerKernel();
+
+// Timer values collected on one thread. Timers are thread-local, so a worker
+// thread saves its values once it is done and the owning thread adds them to
+// its own timers.
+struct TimerValues
+{
+    double       time[static_cast<int>(TimerID::NUM_TIMERS)] = {};
+    int64_t      ticks[static_cast<int>(TimerID::NUM_TIMERS)] = {};
+    unsigned int hits[static_cast<int>(TimerID::NUM_TIMERS)] = {};
+};
+void saveTimers(TimerValues& values);
+void addTimers(const TimerValues& values);
 // double getTimerUS(unsigned idx);
 
 
@@ -71,10 +88,26 @@ struct TimerScope {
     ~TimerScope() {stopTimer(timerId);}
 };
 
+// Only calls into the timers while tracing, for builds without them.
+struct TraceTimerScope {
+    const TimerID timerId;
+    const bool traced;
+    TraceTimerScope(const TimerID _timerId) : timerId(_timerId), traced(CompileTrace::isEnabled())
+    {
+        if (traced)
+            startTimer(timerId);
+    }
+    ~TraceTimerScope()
+    {
+        if (traced)
+            stopTimer(timerId);
+    }
+};
+
 #if defined(MEASURE_COMPILATION_TIME)
 #define  TIME_SCOPE(TIMER_ID) TimerScope __timerScope(TimerID::TIMER_ID);
 #else
-#define  TIME_SCOPE(TIMER_ID)
+#define  TIME_SCOPE(TIMER_ID) TraceTimerScope __timerScope(TimerID::TIMER_ID);
 #endif
 
 #undef DEF_TIMER
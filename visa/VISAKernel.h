@@ -63,7 +63,9 @@ class VISAKernelImpl : public VISAFunction
 
 public:
     VISAKernelImpl(enum VISA_BUILD_TYPE type, CISA_IR_Builder* cisaBuilder, const char* name)
-        : m_mem(4096), m_CISABuilder(cisaBuilder), m_options(cisaBuilder->getOptions())
+        : m_mem(4096), m_CISABuilder(cisaBuilder),
+          m_instListNodeAllocator(INST_LIST_NODE_ALLOCATOR::createShared()),
+          m_options(cisaBuilder->getOptions())
     {
         mBuildOption = m_CISABuilder->getBuilderOption();
         m_magic_number = COMMON_ISA_MAGIC_NUM;
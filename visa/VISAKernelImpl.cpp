@@ -347,6 +347,8 @@ void* VISAKernelImpl::compilePostOptimize(unsigned int& binarySize)
     {
         if (!getOptions()->getOption(vISA_forceDebugSWSB))
         {
+            // SWSB allocates from the kernel's memory; attribute it separately.
+            vISA::MemOwnerScope swsbMemOwner(vISA::MemOwner::SWSB);
             SWSB swsb(*m_kernel, *m_kernelMem);
             swsb.SWSBGenerator();
         }
@@ -574,7 +576,7 @@ void VISAKernelImpl::recordFinalizerInfo()
 
 int VISAKernelImpl::InitializeFastPath()
 {
-    m_kernelMem = new vISA::Mem_Manager(4096);
+    m_kernelMem = new vISA::Mem_Manager(4096, vISA::MemOwner::Kernel);
 
     m_kernel = new (m_mem) G4_Kernel(
         m_instListNodeAllocator,
@@ -640,6 +642,8 @@ void VISAKernelImpl::initCompilerStats()
 {
     m_compilerStats.Init(CompilerStats::numGRFSpillStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numGRFFillStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::numGRFSpillInLoopStr(), CompilerStats::type_int64);
+    m_compilerStats.Init(CompilerStats::numGRFFillInLoopStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numSendStr(), CompilerStats::type_int64);
     m_compilerStats.Init(CompilerStats::numCyclesStr(), CompilerStats::type_int64);
 #if COMPILER_STATS_ENABLE
@@ -650,6 +654,10 @@ void VISAKernelImpl::initCompilerStats()
     m_compilerStats.Init("IsLocalRA", CompilerStats::type_bool);
     m_compilerStats.Init("IsHybridRA", CompilerStats::type_bool);
     m_compilerStats.Init("IsGlobalRA", CompilerStats::type_bool);
+    m_compilerStats.Init("IntfGraphPeakBytes", CompilerStats::type_int64);
+    m_compilerStats.Init("LivenessRuns", CompilerStats::type_int64);
+    m_compilerStats.Init("LivenessUseVisits", CompilerStats::type_int64);
+    m_compilerStats.Init("LivenessDefVisits", CompilerStats::type_int64);
 #endif // COMPILER_STATS_ENABLE
 }
 
@@ -0,0 +1,85 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "WorkerThreads.h"
+#include "common.h"
+#include "Option.h"
+#include "Timer.h"
+#include "MemAccounting.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+unsigned vISA::getNumWorkerThreads(unsigned requested)
+{
+    unsigned hwThreads = std::thread::hardware_concurrency();
+    if (hwThreads != 0 && requested > hwThreads)
+    {
+        requested = hwThreads;
+    }
+    return std::max(requested, 1u);
+}
+
+void vISA::runOnWorkerThreads(
+    unsigned numThreads, size_t numItems, const std::function<void(size_t)>& work)
+{
+    numThreads = (unsigned)std::min<size_t>(numThreads, numItems);
+    TARGET_PLATFORM platform = getGenxPlatform();
+    const char* steppingStr = GetSteppingString();
+    std::atomic<size_t> nextItem(0);
+    std::vector<TimerValues> workerTimers(numThreads);
+    std::vector<MemAccounting::ThreadPeaks> workerPeaks(numThreads);
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+
+    for (unsigned t = 0; t < numThreads; t++)
+    {
+        workers.emplace_back([&, t]()
+        {
+            SetVisaPlatform(platform);
+            InitStepping();
+            SetStepping(steppingStr);
+            initTimer();
+            for (size_t i = nextItem++; i < numItems; i = nextItem++)
+            {
+                work(i);
+            }
+            saveTimers(workerTimers[t]);
+            MemAccounting::saveThreadPeaks(workerPeaks[t]);
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (auto& timers : workerTimers)
+    {
+        addTimers(timers);
+    }
+    MemAccounting::mergeThreadPeaks(workerPeaks);
+}
@@ -0,0 +1,47 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+#ifndef _WORKERTHREADS_H_
+#define _WORKERTHREADS_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace vISA
+{
+// Number of threads to use when the user asked for requested threads:
+// capped by the hardware concurrency, and 1 if requested is 0 or 1.
+unsigned getNumWorkerThreads(unsigned requested);
+
+// Run work(0) ... work(numItems - 1) on at most numThreads worker threads.
+// Workers inherit the caller's platform and stepping, and their timers are
+// added to the caller's timers once all of them have finished.
+void runOnWorkerThreads(
+    unsigned numThreads, size_t numItems, const std::function<void(size_t)>& work);
+}
+
+#endif // _WORKERTHREADS_H_
@@ -0,0 +1,132 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+// Arena chunk reuse as the finalizer causes it: every round creates
+// short-lived managers (liveness, RA iterations, scheduling) that allocate a
+// few hundred KB of small objects and die. Reports the new[] calls and the
+// time per round for
+//   pooled    arenas of a pooled size (4 KB), whose chunks the thread's
+//             chunk pool recycles across managers
+//   unpooled  arenas of a size that is not a pool class (4 KB - 96), whose
+//             chunks are allocated and freed every time as before the pool
+//   reset     one 4 KB manager reused through Mem_Manager::reset
+//
+//   vISABench arena [rounds]
+
+#include "Bench.h"
+#include "Mem_Manager.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace vISA;
+using namespace vISABench;
+
+static std::atomic<uint64_t> numArrayNews(0);
+
+// Arena chunks are allocated with new[], so counting array news counts the
+// chunk mallocs.
+void* operator new[](size_t size)
+{
+    numArrayNews++;
+    if (void* p = malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+static const unsigned managersPerRound = 8;
+static const unsigned allocsPerManager = 4096;
+
+static void fill(Mem_Manager& mem, unsigned seed)
+{
+    for (unsigned i = 0; i < allocsPerManager; i++)
+    {
+        // 8 to 128 bytes, like IR nodes and operands
+        size_t size = 8 + ((i * 2654435761u + seed) >> 16) % 121;
+        sink += (uintptr_t)mem.alloc(size);
+    }
+}
+
+static void report(const char* name, unsigned rounds, double ns, uint64_t news)
+{
+    printf("%-10s %12.0f %12.1f\n", name, ns, (double)news / rounds);
+}
+
+int vISABench::runArena(int argc, const char* argv[])
+{
+    unsigned rounds = argc > 0 ? (unsigned)atoi(argv[0]) : 200;
+    if (rounds == 0)
+    {
+        rounds = 1;
+    }
+
+    printf("%-10s %12s %12s\n", "arenas", "round ns", "new[]/round");
+
+    const size_t sizes[] = { 4096, 4096 - 96 };
+    const char* names[] = { "pooled", "unpooled" };
+    for (unsigned k = 0; k < 2; k++)
+    {
+        uint64_t before = numArrayNews;
+        double ns = timeLoop(rounds, [&]()
+        {
+            for (unsigned m = 0; m < managersPerRound; m++)
+            {
+                Mem_Manager mem(sizes[k]);
+                fill(mem, m);
+            }
+        });
+        report(names[k], rounds, ns, numArrayNews - before);
+    }
+
+    {
+        Mem_Manager mem(4096);
+        uint64_t before = numArrayNews;
+        double ns = timeLoop(rounds, [&]()
+        {
+            for (unsigned m = 0; m < managersPerRound; m++)
+            {
+                fill(mem, m);
+                mem.reset();
+            }
+        });
+        report("reset", rounds, ns, numArrayNews - before);
+    }
+    return 0;
+}
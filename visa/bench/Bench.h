@@ -0,0 +1,62 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Microbenchmarks of the finalizer data structures. They are not built by
+// default; configure with -DVISA_BUILD_BENCHMARKS=ON to get vISABench.
+
+#ifndef _VISA_BENCH_H_
+#define _VISA_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace vISABench
+{
+    // Keeps the compiler from dropping work whose result is otherwise unused.
+    extern volatile uint64_t sink;
+
+    // Runs body() iterations times and returns the average time per call in
+    // nanoseconds.
+    template <typename Body>
+    double timeLoop(unsigned iterations, Body body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < iterations; ++i)
+        {
+            body();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    int runBitSet(int argc, const char* argv[]);
+    int runInstList(int argc, const char* argv[]);
+    int runColorOrder(int argc, const char* argv[]);
+    int runArena(int argc, const char* argv[]);
+}
+
+#endif
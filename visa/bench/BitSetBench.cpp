@@ -0,0 +1,97 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Bulk operations of BitSet at every width the CPU supports, on the set
+// sizes the liveness dataflow sees (one bit per variable).
+//
+//   vISABench bitset [iterations]
+
+#include "Bench.h"
+#include "BitSet.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace vISABench;
+
+static void fillRandom(BitSet& set, std::mt19937& rng, unsigned density)
+{
+    for (unsigned i = 0; i < set.getSize(); ++i)
+    {
+        set.set(i, rng() % 100 < density);
+    }
+}
+
+int vISABench::runBitSet(int argc, const char* argv[])
+{
+    unsigned iterations = argc > 0 ? (unsigned)atoi(argv[0]) : 200000;
+    if (iterations == 0)
+    {
+        iterations = 1;
+    }
+
+    const unsigned sizes[] = { 256, 4096, 65536 };
+    const unsigned widths[] = { 64, 128, 256 };
+    const unsigned defaultWidth = BitSet::getBulkOpWidth();
+
+    printf("%-8s %-6s %10s %10s %10s %10s\n", "bits", "width", "|= ns", "&= ns", "-= ns", "empty ns");
+    for (unsigned size : sizes)
+    {
+        std::mt19937 rng(size);
+        BitSet a(size, false), b(size, false), c(size, false), empty(size, false);
+        fillRandom(a, rng, 30);
+        fillRandom(b, rng, 30);
+        fillRandom(c, rng, 70);
+        // Scale down so every size runs for about the same time.
+        unsigned iters = iterations / (size / 256);
+        if (iters == 0)
+        {
+            iters = 1;
+        }
+
+        for (unsigned width : widths)
+        {
+            BitSet::setBulkOpWidth(width);
+            if (BitSet::getBulkOpWidth() != width)
+            {
+                continue;
+            }
+            BitSet r = a;
+            double orNs = timeLoop(iters, [&]() { r |= b; });
+            double andNs = timeLoop(iters, [&]() { r = a; r &= c; });
+            double minusNs = timeLoop(iters, [&]() { r = a; r -= b; });
+            double copyNs = timeLoop(iters, [&]() { r = a; });
+            double emptyNs = timeLoop(iters, [&]() { sink += empty.isEmpty(); });
+            sink += r.isSet(size - 1);
+            // &= and -= are timed with the copy that resets their input.
+            printf("%-8u %-6u %10.1f %10.1f %10.1f %10.1f\n", size, width,
+                orNs, andNs - copyNs, minusNs - copyNs, emptyNs);
+        }
+    }
+    BitSet::setBulkOpWidth(defaultWidth);
+    return 0;
+}
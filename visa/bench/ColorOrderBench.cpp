@@ -0,0 +1,367 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+
+// Simplify phase of the graph coloring RA: computes the color order of
+// interference graphs with the sorted-list orderer the finalizer used
+// before (constrained ranges sorted by spill cost once, then skipped over
+// when they became unconstrained) and with the IndexedHeap orderer of
+// GraphColor::determineColorOrdering. Reports the time per ordering, whether
+// both give the same order, and the number of constrained ranges picked
+// (the potential spills) by each.
+//
+// The graphs are either random ones, or replayed from a file written by the
+// finalizer's -dumpSimplifyGraph option.
+//
+//   vISABench colororder [nodes | graph file] [iterations]
+
+#include "Bench.h"
+#include "IndexedHeap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vISA;
+using namespace vISABench;
+
+namespace
+{
+struct Node
+{
+    unsigned degree;
+    unsigned numRegNeeded;
+    unsigned numForbidden;
+    float spillCost;
+};
+
+struct Edge
+{
+    unsigned to;
+    unsigned weight;
+};
+
+struct Graph
+{
+    unsigned numColor = 0;
+    bool isGRF = true;
+    std::vector<Node> nodes;
+    // edges[n] are the degrees to relax when n is removed
+    std::vector<std::vector<Edge>> edges;
+    size_t numEdges = 0;
+};
+
+struct Ordering
+{
+    std::vector<unsigned> order;
+    unsigned numConstrainedPicks = 0;
+};
+
+class Orderer
+{
+public:
+    explicit Orderer(const Graph& g) : graph(g) {}
+
+    bool lessCost(unsigned n1, unsigned n2) const
+    {
+        float c1 = graph.nodes[n1].spillCost;
+        float c2 = graph.nodes[n2].spillCost;
+        return c1 < c2 || (c1 == c2 && n1 < n2);
+    }
+
+    bool isUnconstrained(unsigned n, bool relaxing) const
+    {
+        unsigned availColor = graph.numColor;
+        if (!relaxing || graph.isGRF)
+        {
+            availColor -= graph.nodes[n].numForbidden;
+        }
+        return degree[n] + graph.nodes[n].numRegNeeded <= availColor;
+    }
+
+    void init()
+    {
+        degree.resize(graph.nodes.size());
+        active.assign(graph.nodes.size(), false);
+        for (size_t i = 0; i < graph.nodes.size(); i++)
+        {
+            degree[i] = graph.nodes[i].degree;
+        }
+    }
+
+    // Subtracts n's edges from its active neighbors and returns the ones that
+    // became unconstrained through unconstrained().
+    template <typename F>
+    void relax(unsigned n, F unconstrained)
+    {
+        for (const Edge& e : graph.edges[n])
+        {
+            if (active[e.to])
+            {
+                degree[e.to] -= e.weight;
+                if (isUnconstrained(e.to, true))
+                {
+                    active[e.to] = false;
+                    unconstrained(e.to);
+                }
+            }
+        }
+    }
+
+    const Graph& graph;
+    std::vector<unsigned> degree;
+    std::vector<bool> active;
+};
+
+// The orderer as it was before the heap: all ranges sorted by spill cost,
+// and std::list worklists.
+static void listOrder(const Graph& g, Ordering& result)
+{
+    Orderer o(g);
+    o.init();
+    result.order.clear();
+    result.numConstrainedPicks = 0;
+
+    std::vector<unsigned> sorted(g.nodes.size());
+    for (unsigned i = 0; i < sorted.size(); i++)
+    {
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(),
+        [&](unsigned n1, unsigned n2) { return o.lessCost(n1, n2); });
+
+    std::list<unsigned> unconstrained, constrained;
+    for (unsigned n : sorted)
+    {
+        if (o.isUnconstrained(n, false))
+        {
+            unconstrained.push_back(n);
+        }
+        else
+        {
+            constrained.push_back(n);
+            o.active[n] = true;
+        }
+    }
+
+    auto push = [&](unsigned n) { unconstrained.push_back(n); };
+    while (!constrained.empty() || !unconstrained.empty())
+    {
+        while (!unconstrained.empty())
+        {
+            unsigned n = unconstrained.front();
+            unconstrained.pop_front();
+            o.relax(n, push);
+            result.order.push_back(n);
+        }
+        if (!constrained.empty())
+        {
+            unsigned n = constrained.front();
+            constrained.pop_front();
+            if (o.active[n])
+            {
+                o.relax(n, push);
+                result.order.push_back(n);
+                o.active[n] = false;
+                result.numConstrainedPicks++;
+            }
+        }
+    }
+}
+
+struct CostLess
+{
+    const Orderer* o;
+    bool operator()(unsigned n1, unsigned n2) const { return o->lessCost(n1, n2); }
+};
+
+// The orderer of GraphColor::determineColorOrdering.
+static void heapOrder(const Graph& g, Ordering& result)
+{
+    Orderer o(g);
+    o.init();
+    result.order.clear();
+    result.numConstrainedPicks = 0;
+
+    std::vector<unsigned> unconstrained, constrained;
+    for (unsigned n = 0; n < g.nodes.size(); n++)
+    {
+        if (o.isUnconstrained(n, false))
+        {
+            unconstrained.push_back(n);
+        }
+        else
+        {
+            constrained.push_back(n);
+            o.active[n] = true;
+        }
+    }
+    std::sort(unconstrained.begin(), unconstrained.end(),
+        [&](unsigned n1, unsigned n2) { return o.lessCost(n1, n2); });
+    IndexedHeap<CostLess> heap;
+    heap.reset((unsigned)g.nodes.size(), CostLess{ &o });
+    heap.assign(constrained);
+
+    size_t head = 0;
+    auto push = [&](unsigned n)
+    {
+        heap.remove(n);
+        unconstrained.push_back(n);
+    };
+    while (!heap.empty() || head < unconstrained.size())
+    {
+        while (head < unconstrained.size())
+        {
+            unsigned n = unconstrained[head++];
+            o.relax(n, push);
+            result.order.push_back(n);
+        }
+        if (!heap.empty())
+        {
+            unsigned n = heap.pop();
+            o.relax(n, push);
+            result.order.push_back(n);
+            o.active[n] = false;
+            result.numConstrainedPicks++;
+        }
+    }
+}
+
+// Random graph of ranges taking 1 to 4 registers, where a range's degree is
+// the number of registers its neighbors take, as for GRF ranges.
+static Graph randomGraph(unsigned numNodes, unsigned avgNeighbors, unsigned seed)
+{
+    Graph g;
+    g.numColor = 128;
+    g.nodes.resize(numNodes);
+    g.edges.resize(numNodes);
+    std::mt19937 rng(seed);
+    for (Node& n : g.nodes)
+    {
+        n.degree = 0;
+        n.numRegNeeded = 1 + rng() % 4;
+        n.numForbidden = 0;
+        n.spillCost = (float)(rng() % 10000) / 7;
+    }
+    // neighbors are close in id, as live ranges of nearby code are
+    for (unsigned n1 = 0; n1 < numNodes; n1++)
+    {
+        for (unsigned k = 0; k < avgNeighbors / 2; k++)
+        {
+            unsigned n2 = n1 + 1 + rng() % (4 * avgNeighbors);
+            if (n2 >= numNodes)
+            {
+                continue;
+            }
+            g.edges[n1].push_back({ n2, g.nodes[n1].numRegNeeded });
+            g.edges[n2].push_back({ n1, g.nodes[n2].numRegNeeded });
+            g.nodes[n2].degree += g.nodes[n1].numRegNeeded;
+            g.nodes[n1].degree += g.nodes[n2].numRegNeeded;
+            g.numEdges += 2;
+        }
+    }
+    return g;
+}
+
+static bool readGraph(std::istream& in, Graph& g)
+{
+    std::string tag;
+    size_t numNodes;
+    if (!(in >> tag >> numNodes >> g.numColor >> g.isGRF) || tag != "graph")
+    {
+        return false;
+    }
+    g.nodes.resize(numNodes);
+    g.edges.resize(numNodes);
+    for (Node& n : g.nodes)
+    {
+        in >> tag >> n.degree >> n.numRegNeeded >> n.numForbidden >> n.spillCost;
+    }
+    unsigned from, to, weight;
+    while (in >> tag && tag == "e" && in >> from >> to >> weight)
+    {
+        g.edges[from].push_back({ to, weight });
+        g.numEdges++;
+    }
+    return tag == "end";
+}
+
+static void compare(const Graph& g, unsigned iterations)
+{
+    Ordering listResult, heapResult;
+    double listNs = timeLoop(iterations, [&]() { listOrder(g, listResult); });
+    double heapNs = timeLoop(iterations, [&]() { heapOrder(g, heapResult); });
+    sink += listResult.order.size() + heapResult.order.size();
+
+    printf("%-8zu %-9zu %12.0f %12.0f %-6s %8u %8u\n", g.nodes.size(), g.numEdges,
+        listNs, heapNs, listResult.order == heapResult.order ? "yes" : "NO",
+        listResult.numConstrainedPicks, heapResult.numConstrainedPicks);
+}
+}
+
+int vISABench::runColorOrder(int argc, const char* argv[])
+{
+    unsigned iterations = argc > 1 ? (unsigned)atoi(argv[1]) : 20;
+    if (iterations == 0)
+    {
+        iterations = 1;
+    }
+
+    printf("%-8s %-9s %12s %12s %-6s %8s %8s\n", "nodes", "edges", "list ns", "heap ns",
+        "same", "list pk", "heap pk");
+    if (argc > 0 && atoi(argv[0]) == 0)
+    {
+        std::ifstream in(argv[0]);
+        if (!in)
+        {
+            fprintf(stderr, "cannot open %s\n", argv[0]);
+            return 1;
+        }
+        Graph g;
+        while (readGraph(in, g))
+        {
+            compare(g, iterations);
+            g = Graph();
+        }
+        return 0;
+    }
+
+    std::vector<unsigned> sizes = { 1000, 10000, 100000 };
+    if (argc > 0)
+    {
+        sizes = { (unsigned)atoi(argv[0]) };
+    }
+    for (unsigned numNodes : sizes)
+    {
+        // enough neighbors that part of the graph is constrained
+        compare(randomGraph(numNodes, 96, numNodes), iterations);
+    }
+    return 0;
+}
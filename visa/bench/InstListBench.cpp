@@ -0,0 +1,103 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+// Instruction list churn as the schedulers cause it: every round rebuilds a
+// block's INST_LIST in a new order and drops the old nodes. Compares the
+// plain arena allocator, which never reuses a node, with the recycling
+// INST_LIST_NODE_ALLOCATOR, reporting the time per round and the arena
+// memory held at the end.
+//
+//   vISABench instlist [rounds]
+
+#include "Bench.h"
+#include "Gen4_IR.hpp"
+#include "MemAccounting.h"
+
+#include <cstdlib>
+#include <list>
+
+using namespace vISA;
+using namespace vISABench;
+
+template <class Alloc>
+static void churn(const Alloc& alloc, unsigned blockSize, unsigned rounds, double& ns, uint64_t& bytes)
+{
+    uint64_t before = MemAccounting::getCurrent(MemOwner::Other);
+    std::list<G4_INST*, Alloc> block(alloc);
+    for (unsigned i = 0; i < blockSize; ++i)
+    {
+        block.push_back((G4_INST*)(uintptr_t)((i + 1) * 64));
+    }
+
+    ns = timeLoop(rounds, [&]()
+    {
+        std::list<G4_INST*, Alloc> scheduled(alloc);
+        for (auto it = block.rbegin(), ie = block.rend(); it != ie; ++it)
+        {
+            scheduled.push_back(*it);
+        }
+        block.clear();
+        block.splice(block.end(), scheduled);
+        sink += (uintptr_t)block.front();
+    });
+    bytes = MemAccounting::getCurrent(MemOwner::Other) - before;
+}
+
+int vISABench::runInstList(int argc, const char* argv[])
+{
+    unsigned rounds = argc > 0 ? (unsigned)atoi(argv[0]) : 2000;
+    if (rounds == 0)
+    {
+        rounds = 1;
+    }
+
+    const unsigned blockSizes[] = { 16, 256, 4096 };
+
+    printf("%-8s %-10s %12s %12s\n", "insts", "allocator", "round ns", "arena KB");
+    for (unsigned blockSize : blockSizes)
+    {
+        // Scale down so every size runs for about the same time.
+        unsigned iters = rounds * 16 / blockSize;
+        if (iters == 0)
+        {
+            iters = 1;
+        }
+
+        double ns = 0;
+        uint64_t bytes = 0;
+        {
+            std_arena_based_allocator<G4_INST*> arena;
+            churn(arena, blockSize, iters, ns, bytes);
+        }
+        printf("%-8u %-10s %12.0f %12.1f\n", blockSize, "arena", ns, bytes / 1024.0);
+        {
+            INST_LIST_NODE_ALLOCATOR recycling = INST_LIST_NODE_ALLOCATOR::createShared();
+            churn(recycling, blockSize, iters, ns, bytes);
+        }
+        printf("%-8u %-10s %12.0f %12.1f\n", blockSize, "recycling", ns, bytes / 1024.0);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*===================== begin_copyright_notice ==================================
+
+Copyright (c) 2017 Intel Corporation
+
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+======================= end_copyright_notice ==================================*/
+
+#include "Bench.h"
+
+#include <cstring>
+
+using namespace vISABench;
+
+volatile uint64_t vISABench::sink;
+
+struct BenchEntry
+{
+    const char* name;
+    int (*run)(int argc, const char* argv[]);
+};
+
+static const BenchEntry benches[] =
+{
+    { "bitset", runBitSet },
+    { "instlist", runInstList },
+    { "colororder", runColorOrder },
+    { "arena", runArena },
+};
+
+static void usage()
+{
+    fprintf(stderr, "usage: vISABench <benchmark> [options]\nbenchmarks:");
+    for (auto& bench : benches)
+    {
+        fprintf(stderr, " %s", bench.name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 2)
+    {
+        usage();
+        return 1;
+    }
+    for (auto& bench : benches)
+    {
+        if (strcmp(argv[1], bench.name) == 0)
+        {
+            return bench.run(argc - 2, argv + 2);
+        }
+    }
+    usage();
+    return 1;
+}
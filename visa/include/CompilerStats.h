@@ -109,6 +109,8 @@ public:
     static constexpr const char* numSendStr() { return "NumSendInst"; };
     static constexpr const char* numGRFSpillStr() { return "NumGRFSpill"; };
     static constexpr const char* numGRFFillStr() { return "NumGRFFill"; };
+    static constexpr const char* numGRFSpillInLoopStr() { return "NumGRFSpillInLoop"; };
+    static constexpr const char* numGRFFillInLoopStr() { return "NumGRFFillInLoop"; };
     static constexpr const char* numCyclesStr() { return "NumCycles"; };
 
 